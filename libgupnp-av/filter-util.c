@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2007, 2008 OpenedHand Ltd.
+ * Copyright (C) 2012 Intel Corporation.
+ *
+ * Authors: Jorn Baayen <jorn@openedhand.com>
+ *          Jens Georg <jensg@openismus.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "filter-util.h"
+
+/* Properties that are always included, regardless of the filter */
+gboolean
+filter_util_is_standard_prop (const char *name,
+                              const char *prefix,
+                              const char *parent_name)
+{
+        return strcmp (name, "id") == 0 ||
+               strcmp (name, "parentID") == 0 ||
+               strcmp (name, "restricted") == 0 ||
+               strcmp (name, "refID") == 0 ||
+               (g_strcmp0 (prefix, "dc") == 0 &&
+                strcmp (name, "title") == 0) ||
+               (g_strcmp0 (prefix, "upnp") == 0 &&
+                strcmp (name, "class") == 0) ||
+               (g_strcmp0 (parent_name, "res") == 0 &&
+                strcmp (name, "protocolInfo") == 0);
+}
+
+gboolean
+filter_util_is_container_standard_prop (const char *name,
+                                        const char *prefix,
+                                        const char *upnp_class)
+{
+        return g_strcmp0 (upnp_class, "object.container.storageFolder") == 0 &&
+               g_strcmp0 (prefix, "upnp") == 0 &&
+               strcmp (name, "storageUsed") == 0;
+}
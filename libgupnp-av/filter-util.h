@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2007, 2008 OpenedHand Ltd.
+ * Copyright (C) 2012 Intel Corporation.
+ *
+ * Authors: Jorn Baayen <jorn@openedhand.com>
+ *          Jens Georg <jensg@openismus.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef FILTER_UTIL_H
+#define FILTER_UTIL_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Helpers for the 'Filter' argument of Browse and Search, as understood by
+ * gupnp_didl_lite_writer_filter(). The names a filter asks for are looked up
+ * in a GUPnPDIDLLiteFilter, these are the properties kept regardless. Names
+ * are passed as namespace prefix and local name; a %NULL prefix means the
+ * name is unqualified. */
+
+G_GNUC_INTERNAL gboolean
+filter_util_is_standard_prop            (const char *name,
+                                         const char *prefix,
+                                         const char *parent_name);
+
+G_GNUC_INTERNAL gboolean
+filter_util_is_container_standard_prop  (const char *name,
+                                         const char *prefix,
+                                         const char *upnp_class);
+
+G_END_DECLS
+
+#endif /* __FILTER_UTIL_H__ */
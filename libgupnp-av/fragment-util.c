@@ -614,11 +614,18 @@ fix_fragment (const gchar *fragment)
         return g_strdup_printf
                     ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
                      "<DIDLLiteFragment\n"
-                     "xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
-                     "xmlns=\"urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/\"\n"
-                     "xmlns:upnp=\"urn:schemas-upnp-org:metadata-1-0/upnp/\"\n"
+                     "xmlns:%s=\"%s\"\n"
+                     "xmlns=\"%s\"\n"
+                     "xmlns:%s=\"%s\"\n"
                      "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
                      ">%s</DIDLLiteFragment>\n",
+                     av_xml_util_get_namespace_prefix (GUPNP_XML_NAMESPACE_DC),
+                     av_xml_util_get_namespace_uri (GUPNP_XML_NAMESPACE_DC),
+                     av_xml_util_get_namespace_uri
+                                        (GUPNP_XML_NAMESPACE_DIDL_LITE),
+                     av_xml_util_get_namespace_prefix
+                                        (GUPNP_XML_NAMESPACE_UPNP),
+                     av_xml_util_get_namespace_uri (GUPNP_XML_NAMESPACE_UPNP),
                      fragment);
 }
 
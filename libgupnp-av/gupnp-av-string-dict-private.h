@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_AV_STRING_DICT_PRIVATE_H
+#define GUPNP_AV_STRING_DICT_PRIVATE_H
+
+#include <libxml/parser.h>
+#include <libxml/dict.h>
+
+#include "gupnp-av-string-dict.h"
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL void
+gupnp_av_string_dict_attach             (GUPnPAVStringDict *dict,
+                                         xmlParserCtxt     *ctxt);
+
+G_GNUC_INTERNAL xmlDoc *
+gupnp_av_string_dict_read_memory        (GUPnPAVStringDict *dict,
+                                         const char        *data,
+                                         gsize              length,
+                                         int                options);
+
+G_GNUC_INTERNAL void
+gupnp_av_string_dict_intern_content     (xmlNode *node);
+
+G_END_DECLS
+
+#endif /* __GUPNP_AV_STRING_DICT_PRIVATE_H__ */
@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPAVStringDict:
+ *
+ * A pool of interned strings shared between parsed documents
+ *
+ * Every XML document normally comes with a dictionary of its own, holding
+ * element and attribute names as well as a few short text values. Parsers
+ * given a [struct@GUPnPAV.AVStringDict] use it instead, so documents parsed
+ * with the same dictionary store each of these strings only once. The DIDL-Lite
+ * parser additionally interns the class and the protocol info of each object,
+ * which repeat a lot in a typical ContentDirectory.
+ *
+ * A dictionary never forgets a string, so it is best suited to long-lived
+ * caches of objects from the same servers.
+ *
+ * A dictionary, and all the objects parsed with it, must only be used from
+ * one thread at a time.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include "gupnp-av-string-dict.h"
+#include "gupnp-av-string-dict-private.h"
+
+struct _GUPnPAVStringDict {
+        xmlDict *dict;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPAVStringDict,
+                     gupnp_av_string_dict,
+                     gupnp_av_string_dict_ref,
+                     gupnp_av_string_dict_unref)
+
+/**
+ * gupnp_av_string_dict_new:
+ *
+ * Create a new, empty [struct@GUPnPAV.AVStringDict].
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.AVStringDict].
+ *
+ * Since: 0.16
+ **/
+GUPnPAVStringDict *
+gupnp_av_string_dict_new (void)
+{
+        GUPnPAVStringDict *dict;
+
+        dict = g_atomic_rc_box_new0 (GUPnPAVStringDict);
+        dict->dict = xmlDictCreate ();
+
+        return dict;
+}
+
+/**
+ * gupnp_av_string_dict_ref:
+ * @dict: A [struct@GUPnPAV.AVStringDict]
+ *
+ * Increase reference count of a [struct@GUPnPAV.AVStringDict].
+ *
+ * Returns: (transfer full): The object passed in @dict.
+ *
+ * Since: 0.16
+ **/
+GUPnPAVStringDict *
+gupnp_av_string_dict_ref (GUPnPAVStringDict *dict)
+{
+        g_return_val_if_fail (dict != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (dict);
+}
+
+static void
+string_dict_free (GUPnPAVStringDict *dict)
+{
+        /* Documents still using the dictionary hold references of their
+         * own */
+        xmlDictFree (dict->dict);
+}
+
+/**
+ * gupnp_av_string_dict_unref:
+ * @dict: A [struct@GUPnPAV.AVStringDict]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.AVStringDict]. If the
+ * reference count drops to 0, @dict is freed once the last object parsed
+ * with it is gone.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_av_string_dict_unref (GUPnPAVStringDict *dict)
+{
+        g_return_if_fail (dict != NULL);
+
+        g_atomic_rc_box_release_full (dict, (GDestroyNotify) string_dict_free);
+}
+
+/**
+ * gupnp_av_string_dict_get_size:
+ * @dict: A [struct@GUPnPAV.AVStringDict]
+ *
+ * Get the number of distinct strings interned in @dict.
+ *
+ * Returns: The number of strings in @dict.
+ *
+ * Since: 0.16
+ **/
+gsize
+gupnp_av_string_dict_get_size (GUPnPAVStringDict *dict)
+{
+        int size;
+
+        g_return_val_if_fail (dict != NULL, 0);
+
+        size = xmlDictSize (dict->dict);
+
+        return size > 0 ? (gsize) size : 0;
+}
+
+/*
+ * Makes @ctxt build its documents with the dictionary of @dict instead of a
+ * private one. Must be called before anything has been parsed.
+ */
+void
+gupnp_av_string_dict_attach (GUPnPAVStringDict *dict,
+                             xmlParserCtxt     *ctxt)
+{
+        if (dict == NULL || ctxt == NULL)
+                return;
+
+#if LIBXML_VERSION >= 21400
+        xmlCtxtSetDict (ctxt, dict->dict);
+#else
+        /* Older libxml2 has no call for this */
+        xmlDictFree (ctxt->dict);
+        ctxt->dict = dict->dict;
+        xmlDictReference (ctxt->dict);
+
+        /* The context looks these up once and compares by pointer */
+        ctxt->str_xml = xmlDictLookup (ctxt->dict, BAD_CAST "xml", 3);
+        ctxt->str_xmlns = xmlDictLookup (ctxt->dict, BAD_CAST "xmlns", 5);
+        ctxt->str_xml_ns = xmlDictLookup (ctxt->dict, XML_XML_NAMESPACE, 36);
+#endif
+}
+
+/* Parses @data into a document using the dictionary of @dict */
+xmlDoc *
+gupnp_av_string_dict_read_memory (GUPnPAVStringDict *dict,
+                                  const char        *data,
+                                  gsize              length,
+                                  int                options)
+{
+        xmlParserCtxt *ctxt;
+        xmlDoc        *doc = NULL;
+
+        if (length > G_MAXINT)
+                return NULL;
+
+        ctxt = xmlNewParserCtxt ();
+        if (ctxt == NULL)
+                return NULL;
+
+        gupnp_av_string_dict_attach (dict, ctxt);
+        doc = xmlCtxtReadMemory (ctxt, data, (int) length, NULL, NULL, options);
+        xmlFreeParserCtxt (ctxt);
+
+        return doc;
+}
+
+/*
+ * Replaces the content of the text children of @node by its interned copy
+ * in the document's dictionary. libxml2 knows not to free such content.
+ */
+void
+gupnp_av_string_dict_intern_content (xmlNode *node)
+{
+        xmlDict *dict;
+        xmlNode *child;
+
+        if (node == NULL || node->doc == NULL || node->doc->dict == NULL)
+                return;
+
+        dict = node->doc->dict;
+        for (child = node->children; child != NULL; child = child->next) {
+                const xmlChar *interned;
+
+                if (child->type != XML_TEXT_NODE ||
+                    child->content == NULL ||
+                    child->content == (xmlChar *) &child->properties ||
+                    xmlDictOwns (dict, child->content))
+                        continue;
+
+                interned = xmlDictLookup (dict, child->content, -1);
+                if (interned == NULL)
+                        continue;
+
+                xmlFree (child->content);
+                child->content = (xmlChar *) interned;
+        }
+}
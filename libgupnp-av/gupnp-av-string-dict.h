@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_AV_STRING_DICT_H
+#define GUPNP_AV_STRING_DICT_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+GType
+gupnp_av_string_dict_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_AV_STRING_DICT (gupnp_av_string_dict_get_type ())
+
+typedef struct _GUPnPAVStringDict GUPnPAVStringDict;
+
+GUPnPAVStringDict *
+gupnp_av_string_dict_new        (void);
+
+GUPnPAVStringDict *
+gupnp_av_string_dict_ref        (GUPnPAVStringDict *dict);
+
+void
+gupnp_av_string_dict_unref      (GUPnPAVStringDict *dict);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPAVStringDict, gupnp_av_string_dict_unref)
+
+gsize
+gupnp_av_string_dict_get_size   (GUPnPAVStringDict *dict);
+
+G_END_DECLS
+
+#endif /* __GUPNP_AV_STRING_DICT_H__ */
@@ -10,15 +10,23 @@
  */
 
 #include "gupnp-av-enums.h"
+#include "gupnp-av-string-dict.h"
 #include "gupnp-didl-lite-object.h"
+#include "gupnp-didl-lite-object-handle.h"
 #include "gupnp-didl-lite-container.h"
 #include "gupnp-didl-lite-createclass.h"
 #include "gupnp-didl-lite-item.h"
 #include "gupnp-didl-lite-parser.h"
 #include "gupnp-didl-lite-resource.h"
+#include "gupnp-didl-lite-scan-result.h"
+#include "gupnp-didl-lite-snapshot.h"
+#include "gupnp-didl-lite-catalog.h"
 #include "gupnp-didl-lite-descriptor.h"
+#include "gupnp-didl-lite-filter.h"
+#include "gupnp-didl-lite-fragment-cache.h"
 #include "gupnp-didl-lite-writer.h"
 #include "gupnp-protocol-info.h"
+#include "gupnp-protocol-info-matcher.h"
 #include "gupnp-search-criteria-parser.h"
 #include "gupnp-last-change-parser.h"
 #include "gupnp-cds-last-change-parser.h"
@@ -21,8 +21,11 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include "xml-util.h"
 #include "gupnp-cds-last-change-parser.h"
+#include "gupnp-av-string-dict-private.h"
 
 /**
  * GUPnPCDSLastChangeEntry:
@@ -38,23 +41,119 @@ struct _GUPnPCDSLastChangeEntry {
         gboolean is_subtree_update;
 };
 
-G_DEFINE_TYPE (GUPnPCDSLastChangeParser,
-               gupnp_cds_last_change_parser,
-               G_TYPE_OBJECT)
+struct _GUPnPCDSLastChangeParserPrivate {
+        GUPnPAVStringDict *string_dict;
+};
+typedef struct _GUPnPCDSLastChangeParserPrivate GUPnPCDSLastChangeParserPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GUPnPCDSLastChangeParser,
+                            gupnp_cds_last_change_parser,
+                            G_TYPE_OBJECT)
 
 G_DEFINE_BOXED_TYPE (GUPnPCDSLastChangeEntry,
                      gupnp_cds_last_change_entry,
                      gupnp_cds_last_change_entry_ref,
                      gupnp_cds_last_change_entry_unref)
 
+enum {
+        PROP_0,
+        PROP_STRING_DICT
+};
+
 static void
 gupnp_cds_last_change_parser_init (G_GNUC_UNUSED GUPnPCDSLastChangeParser *parser)
 {
 }
 
 static void
-gupnp_cds_last_change_parser_class_init (G_GNUC_UNUSED GUPnPCDSLastChangeParserClass *klass)
+gupnp_cds_last_change_parser_set_property (GObject      *object,
+                                           guint         property_id,
+                                           const GValue *value,
+                                           GParamSpec   *pspec)
+{
+        GUPnPCDSLastChangeParser *parser;
+
+        parser = GUPNP_CDS_LAST_CHANGE_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STRING_DICT:
+                gupnp_cds_last_change_parser_set_string_dict
+                                        (parser, g_value_get_boxed (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
+static void
+gupnp_cds_last_change_parser_get_property (GObject    *object,
+                                           guint       property_id,
+                                           GValue     *value,
+                                           GParamSpec *pspec)
+{
+        GUPnPCDSLastChangeParser *parser;
+
+        parser = GUPNP_CDS_LAST_CHANGE_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STRING_DICT:
+                g_value_set_boxed (value,
+                                   gupnp_cds_last_change_parser_get_string_dict
+                                        (parser));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
+static void
+gupnp_cds_last_change_parser_dispose (GObject *object)
+{
+        GObjectClass *gobject_class;
+        GUPnPCDSLastChangeParserPrivate *priv;
+
+        priv = gupnp_cds_last_change_parser_get_instance_private
+                                        (GUPNP_CDS_LAST_CHANGE_PARSER (object));
+
+        g_clear_pointer (&priv->string_dict, gupnp_av_string_dict_unref);
+
+        gobject_class = G_OBJECT_CLASS
+                                (gupnp_cds_last_change_parser_parent_class);
+        gobject_class->dispose (object);
+}
+
+static void
+gupnp_cds_last_change_parser_class_init (GUPnPCDSLastChangeParserClass *klass)
 {
+        GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+        object_class->set_property = gupnp_cds_last_change_parser_set_property;
+        object_class->get_property = gupnp_cds_last_change_parser_get_property;
+        object_class->dispose = gupnp_cds_last_change_parser_dispose;
+
+        /**
+         * GUPnPCDSLastChangeParser:string-dict:
+         *
+         * The [struct@GUPnPAV.AVStringDict] to intern the names of parsed
+         * LastChange documents in, or %NULL to give each document a
+         * dictionary of its own.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_STRING_DICT,
+                 g_param_spec_boxed ("string-dict",
+                                     "String dictionary",
+                                     "The dictionary shared by the parsed"
+                                     " documents.",
+                                     GUPNP_TYPE_AV_STRING_DICT,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_NAME |
+                                     G_PARAM_STATIC_NICK |
+                                     G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -97,11 +196,21 @@ gupnp_cds_last_change_parser_parse (GUPnPCDSLastChangeParser *parser,
         xmlNode *state_event, *it;
         GList *result = NULL;
         GUPnPCDSLastChangeEntry *entry;
+        GUPnPCDSLastChangeParserPrivate *priv;
 
         g_return_val_if_fail (GUPNP_IS_CDS_LAST_CHANGE_PARSER (parser),
                               NULL);
 
-        doc = xmlParseDoc ((const xmlChar *) last_change);
+        priv = gupnp_cds_last_change_parser_get_instance_private (parser);
+
+        if (priv->string_dict != NULL)
+                doc = gupnp_av_string_dict_read_memory
+                                        (priv->string_dict,
+                                         last_change,
+                                         strlen (last_change),
+                                         0);
+        else
+                doc = xmlParseDoc ((const xmlChar *) last_change);
         if (doc == NULL) {
                 g_set_error (error,
                              G_MARKUP_ERROR,
@@ -362,3 +471,58 @@ gupnp_cds_last_change_entry_get_update_id (GUPnPCDSLastChangeEntry *entry)
 
         return entry->update_id;
 }
+
+/**
+ * gupnp_cds_last_change_parser_set_string_dict:
+ * @parser: A [class@GUPnPAV.CDSLastChangeParser]
+ * @dict: (nullable): A [struct@GUPnPAV.AVStringDict], or %NULL
+ *
+ * Makes @parser intern the names in the documents it parses in @dict instead
+ * of a dictionary private to each document. See
+ * #GUPnPCDSLastChangeParser:string-dict.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_cds_last_change_parser_set_string_dict
+                                        (GUPnPCDSLastChangeParser *parser,
+                                         GUPnPAVStringDict        *dict)
+{
+        GUPnPCDSLastChangeParserPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_CDS_LAST_CHANGE_PARSER (parser));
+
+        priv = gupnp_cds_last_change_parser_get_instance_private (parser);
+
+        if (priv->string_dict == dict)
+                return;
+
+        g_clear_pointer (&priv->string_dict, gupnp_av_string_dict_unref);
+        if (dict != NULL)
+                priv->string_dict = gupnp_av_string_dict_ref (dict);
+
+        g_object_notify (G_OBJECT (parser), "string-dict");
+}
+
+/**
+ * gupnp_cds_last_change_parser_get_string_dict:
+ * @parser: A [class@GUPnPAV.CDSLastChangeParser]
+ *
+ * Get the dictionary @parser interns names in.
+ *
+ * Return value: (transfer none) (nullable): The [struct@GUPnPAV.AVStringDict],
+ * or %NULL.
+ *
+ * Since: 0.16
+ **/
+GUPnPAVStringDict *
+gupnp_cds_last_change_parser_get_string_dict (GUPnPCDSLastChangeParser *parser)
+{
+        GUPnPCDSLastChangeParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_CDS_LAST_CHANGE_PARSER (parser), NULL);
+
+        priv = gupnp_cds_last_change_parser_get_instance_private (parser);
+
+        return priv->string_dict;
+}
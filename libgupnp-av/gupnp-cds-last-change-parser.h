@@ -12,6 +12,8 @@
 
 #include <glib-object.h>
 
+#include "gupnp-av-string-dict.h"
+
 G_BEGIN_DECLS
 
 
@@ -63,6 +65,15 @@ gupnp_cds_last_change_parser_parse (GUPnPCDSLastChangeParser *parser,
                                     const char               *last_change,
                                     GError                  **error);
 
+void
+gupnp_cds_last_change_parser_set_string_dict
+                                   (GUPnPCDSLastChangeParser *parser,
+                                    GUPnPAVStringDict        *dict);
+
+GUPnPAVStringDict *
+gupnp_cds_last_change_parser_get_string_dict
+                                   (GUPnPCDSLastChangeParser *parser);
+
 GUPnPCDSLastChangeEntry *
 gupnp_cds_last_change_entry_ref    (GUPnPCDSLastChangeEntry *entry);
 void
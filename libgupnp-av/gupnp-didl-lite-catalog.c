@@ -0,0 +1,755 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPDIDLLiteCatalog:
+ *
+ * A read-only catalog of DIDL-Lite objects stored in a file
+ *
+ * A [struct@GUPnPAV.DIDLLiteCatalog] holds the
+ * [struct@GUPnPAV.DIDLLiteSnapshot] of any number of objects, together with
+ * an index of their IDs and of the children of every parent ID. It is made
+ * by a [struct@GUPnPAV.DIDLLiteCatalogBuilder] and stored as a single
+ * #GVariant, so opening a catalog with
+ * gupnp_didl_lite_catalog_new_from_file() only maps the file into memory.
+ * Nothing is parsed or copied up front: a lookup reads a handful of index
+ * entries and the snapshots point straight into the mapped data.
+ *
+ * To serialize an entry, add it to a #GUPnPDIDLLiteWriter with
+ * gupnp_didl_lite_catalog_add_to_writer() and get the DIDL-Lite fragment
+ * from the writer.
+ *
+ * Catalog files are stored in the byte order of the machine that wrote them
+ * and are rejected on machines of the other byte order.
+ *
+ * Since: 0.16
+ */
+
+/**
+ * GUPnPDIDLLiteCatalogBuilder:
+ *
+ * Collects DIDL-Lite objects for a new [struct@GUPnPAV.DIDLLiteCatalog]
+ *
+ * Add the objects in the order they should be listed by
+ * gupnp_didl_lite_catalog_get_children(), then store the catalog with
+ * gupnp_didl_lite_catalog_builder_write().
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "gupnp-didl-lite-catalog.h"
+
+#define CATALOG_MAGIC "GUPnPDIDLLiteCatalog"
+#define CATALOG_VERSION 1
+
+/* Magic, version, the snapshots in the order they were added, (ID, index)
+ * pairs sorted by ID, (parent ID, first, count) triplets sorted by parent ID
+ * and the indices of the children, grouped by parent */
+#define OBJECTS_VARIANT_TYPE "a" GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE
+#define CATALOG_VARIANT_TYPE "(sq" OBJECTS_VARIANT_TYPE "a(su)a(suu)au)"
+
+struct _GUPnPDIDLLiteCatalog {
+        GVariant *variant;
+        GVariant *objects;
+        GVariant *ids;
+        GVariant *parents;
+        GVariant *children;
+};
+
+struct _GUPnPDIDLLiteCatalogBuilder {
+        GPtrArray *snapshots;
+};
+
+typedef struct {
+        const char *key;
+        guint32     index;
+} CatalogKey;
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteCatalog,
+                     gupnp_didl_lite_catalog,
+                     gupnp_didl_lite_catalog_ref,
+                     gupnp_didl_lite_catalog_unref)
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteCatalogBuilder,
+                     gupnp_didl_lite_catalog_builder,
+                     gupnp_didl_lite_catalog_builder_ref,
+                     gupnp_didl_lite_catalog_builder_unref)
+
+/**
+ * gupnp_didl_lite_catalog_new_from_bytes:
+ * @bytes: The data of a catalog
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Create a [struct@GUPnPAV.DIDLLiteCatalog] from data made by
+ * gupnp_didl_lite_catalog_builder_to_bytes(). The catalog keeps a reference
+ * to @bytes and reads from it directly.
+ *
+ * Returns: (transfer full) (nullable): A new
+ * [struct@GUPnPAV.DIDLLiteCatalog], or %NULL if @bytes is not a catalog.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteCatalog *
+gupnp_didl_lite_catalog_new_from_bytes (GBytes  *bytes,
+                                        GError **error)
+{
+        GUPnPDIDLLiteCatalog *catalog;
+        GVariant *variant;
+        const char *magic;
+        guint16 version;
+
+        g_return_val_if_fail (bytes != NULL, NULL);
+
+        variant = g_variant_new_from_bytes
+                                (G_VARIANT_TYPE (CATALOG_VARIANT_TYPE),
+                                 bytes,
+                                 FALSE);
+        g_variant_ref_sink (variant);
+
+        g_variant_get_child (variant, 0, "&s", &magic);
+        if (strcmp (magic, CATALOG_MAGIC) != 0) {
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_INVALID_DATA,
+                                     "Not a DIDL-Lite catalog");
+                g_variant_unref (variant);
+
+                return NULL;
+        }
+
+        /* Also catches files written in the other byte order */
+        g_variant_get_child (variant, 1, "q", &version);
+        if (version != CATALOG_VERSION) {
+                g_set_error (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_INVALID_DATA,
+                             "Unsupported DIDL-Lite catalog version %u",
+                             version);
+                g_variant_unref (variant);
+
+                return NULL;
+        }
+
+        catalog = g_atomic_rc_box_new0 (GUPnPDIDLLiteCatalog);
+        catalog->variant = variant;
+        catalog->objects = g_variant_get_child_value (variant, 2);
+        catalog->ids = g_variant_get_child_value (variant, 3);
+        catalog->parents = g_variant_get_child_value (variant, 4);
+        catalog->children = g_variant_get_child_value (variant, 5);
+
+        return catalog;
+}
+
+/**
+ * gupnp_didl_lite_catalog_new_from_file:
+ * @path: The path of a catalog file
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Map the catalog file at @path, as written by
+ * gupnp_didl_lite_catalog_builder_write(), into memory.
+ *
+ * The file must not be modified while the catalog is in use. Replacing it,
+ * as gupnp_didl_lite_catalog_builder_write() does, is safe.
+ *
+ * Returns: (transfer full) (nullable): A new
+ * [struct@GUPnPAV.DIDLLiteCatalog], or %NULL on error.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteCatalog *
+gupnp_didl_lite_catalog_new_from_file (const char *path,
+                                       GError    **error)
+{
+        GUPnPDIDLLiteCatalog *catalog;
+        GMappedFile *file;
+        GBytes *bytes;
+
+        g_return_val_if_fail (path != NULL, NULL);
+
+        file = g_mapped_file_new (path, FALSE, error);
+        if (file == NULL)
+                return NULL;
+
+        bytes = g_mapped_file_get_bytes (file);
+        g_mapped_file_unref (file);
+
+        catalog = gupnp_didl_lite_catalog_new_from_bytes (bytes, error);
+        g_bytes_unref (bytes);
+
+        return catalog;
+}
+
+/**
+ * gupnp_didl_lite_catalog_ref:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteCatalog].
+ *
+ * Returns: (transfer full): The object passed in @catalog.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteCatalog *
+gupnp_didl_lite_catalog_ref (GUPnPDIDLLiteCatalog *catalog)
+{
+        g_return_val_if_fail (catalog != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (catalog);
+}
+
+static void
+catalog_free (GUPnPDIDLLiteCatalog *catalog)
+{
+        g_variant_unref (catalog->objects);
+        g_variant_unref (catalog->ids);
+        g_variant_unref (catalog->parents);
+        g_variant_unref (catalog->children);
+        g_variant_unref (catalog->variant);
+}
+
+/**
+ * gupnp_didl_lite_catalog_unref:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteCatalog]. If the
+ * reference count drops to 0, @catalog is freed. Snapshots taken from
+ * @catalog keep its data alive.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_catalog_unref (GUPnPDIDLLiteCatalog *catalog)
+{
+        g_return_if_fail (catalog != NULL);
+
+        g_atomic_rc_box_release_full (catalog, (GDestroyNotify) catalog_free);
+}
+
+/**
+ * gupnp_didl_lite_catalog_get_length:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ *
+ * Get the number of objects in @catalog.
+ *
+ * Returns: The number of objects.
+ *
+ * Since: 0.16
+ **/
+guint
+gupnp_didl_lite_catalog_get_length (GUPnPDIDLLiteCatalog *catalog)
+{
+        g_return_val_if_fail (catalog != NULL, 0);
+
+        return (guint) g_variant_n_children (catalog->objects);
+}
+
+/**
+ * gupnp_didl_lite_catalog_get_snapshot:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ * @index_: The index of the object, in the order the objects were added
+ *
+ * Get the snapshot of the object at @index_.
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.DIDLLiteSnapshot].
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_catalog_get_snapshot (GUPnPDIDLLiteCatalog *catalog,
+                                      guint                 index_)
+{
+        GUPnPDIDLLiteSnapshot *snapshot;
+        GVariant *child;
+
+        g_return_val_if_fail (catalog != NULL, NULL);
+        g_return_val_if_fail (index_ < g_variant_n_children (catalog->objects),
+                              NULL);
+
+        child = g_variant_get_child_value (catalog->objects, index_);
+        snapshot = gupnp_didl_lite_snapshot_new_from_variant (child);
+        g_variant_unref (child);
+
+        return snapshot;
+}
+
+/* Binary search of @key in an array of tuples sorted by their first,
+ * string member. Finds the first of several equal keys. */
+static gboolean
+find_key (GVariant   *sorted,
+          const char *key,
+          gsize      *position)
+{
+        gsize low = 0;
+        gsize high = g_variant_n_children (sorted);
+
+        while (low < high) {
+                gsize middle = low + (high - low) / 2;
+                GVariant *child;
+                const char *middle_key;
+
+                child = g_variant_get_child_value (sorted, middle);
+                g_variant_get_child (child, 0, "&s", &middle_key);
+                if (strcmp (middle_key, key) < 0)
+                        low = middle + 1;
+                else
+                        high = middle;
+                g_variant_unref (child);
+        }
+
+        if (low < g_variant_n_children (sorted)) {
+                GVariant *child;
+                const char *found_key;
+                gboolean found;
+
+                child = g_variant_get_child_value (sorted, low);
+                g_variant_get_child (child, 0, "&s", &found_key);
+                found = strcmp (found_key, key) == 0;
+                g_variant_unref (child);
+
+                if (found) {
+                        *position = low;
+
+                        return TRUE;
+                }
+        }
+
+        return FALSE;
+}
+
+/**
+ * gupnp_didl_lite_catalog_lookup_index:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ * @id: The ID of an object
+ * @index_: (out) (optional): The location to store the index of the object
+ *
+ * Find the object with ID @id. If there are several, the first one added is
+ * found.
+ *
+ * Returns: %TRUE if @catalog has an object with ID @id.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_catalog_lookup_index (GUPnPDIDLLiteCatalog *catalog,
+                                      const char           *id,
+                                      guint                *index_)
+{
+        gsize position;
+        guint32 found;
+
+        g_return_val_if_fail (catalog != NULL, FALSE);
+        g_return_val_if_fail (id != NULL, FALSE);
+
+        if (!find_key (catalog->ids, id, &position))
+                return FALSE;
+
+        g_variant_get_child (catalog->ids, position, "(&su)", NULL, &found);
+        if (found >= g_variant_n_children (catalog->objects))
+                return FALSE;
+
+        if (index_ != NULL)
+                *index_ = found;
+
+        return TRUE;
+}
+
+/**
+ * gupnp_didl_lite_catalog_lookup:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ * @id: The ID of an object
+ *
+ * Get the snapshot of the object with ID @id. If there are several, the first
+ * one added is returned.
+ *
+ * Returns: (transfer full) (nullable): A new
+ * [struct@GUPnPAV.DIDLLiteSnapshot], or %NULL if @catalog has no object with
+ * ID @id.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_catalog_lookup (GUPnPDIDLLiteCatalog *catalog,
+                                const char           *id)
+{
+        guint index_;
+
+        g_return_val_if_fail (catalog != NULL, NULL);
+        g_return_val_if_fail (id != NULL, NULL);
+
+        if (!gupnp_didl_lite_catalog_lookup_index (catalog, id, &index_))
+                return NULL;
+
+        return gupnp_didl_lite_catalog_get_snapshot (catalog, index_);
+}
+
+/**
+ * gupnp_didl_lite_catalog_get_children:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ * @parent_id: The ID of a container
+ * @n_children: (out): The location to store the number of children
+ *
+ * Get the indices of all objects with parent ID @parent_id, in the order
+ * they were added. The container itself need not be in @catalog. Pass the
+ * indices to gupnp_didl_lite_catalog_get_snapshot().
+ *
+ * Returns: (transfer none) (array length=n_children) (nullable): The indices
+ * of the children, pointing into the data of @catalog, or %NULL if there are
+ * none.
+ *
+ * Since: 0.16
+ **/
+const guint32 *
+gupnp_didl_lite_catalog_get_children (GUPnPDIDLLiteCatalog *catalog,
+                                      const char           *parent_id,
+                                      guint                *n_children)
+{
+        const guint32 *children;
+        gsize n_objects;
+        gsize length;
+        gsize position;
+        guint32 first;
+        guint32 count;
+        guint32 i;
+
+        g_return_val_if_fail (n_children != NULL, NULL);
+        *n_children = 0;
+        g_return_val_if_fail (catalog != NULL, NULL);
+        g_return_val_if_fail (parent_id != NULL, NULL);
+
+        if (!find_key (catalog->parents, parent_id, &position))
+                return NULL;
+
+        g_variant_get_child (catalog->parents,
+                             position,
+                             "(&suu)",
+                             NULL,
+                             &first,
+                             &count);
+        children = g_variant_get_fixed_array (catalog->children,
+                                              &length,
+                                              sizeof (guint32));
+        if (count == 0 || first > length || count > length - first)
+                return NULL;
+
+        /* The file is not trusted, so make sure no index is out of range */
+        n_objects = g_variant_n_children (catalog->objects);
+        for (i = first; i < first + count; i++)
+                if (children[i] >= n_objects)
+                        return NULL;
+
+        *n_children = count;
+
+        return children + first;
+}
+
+/**
+ * gupnp_didl_lite_catalog_add_to_writer:
+ * @catalog: A [struct@GUPnPAV.DIDLLiteCatalog]
+ * @id: The ID of an object
+ * @writer: The #GUPnPDIDLLiteWriter to add the object to
+ *
+ * Add the object with ID @id to @writer, see
+ * gupnp_didl_lite_snapshot_to_object().
+ *
+ * Returns: (transfer full) (nullable): The new #GUPnPDIDLLiteObject, or %NULL
+ * if @catalog has no object with ID @id. Unref after usage.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteObject *
+gupnp_didl_lite_catalog_add_to_writer (GUPnPDIDLLiteCatalog *catalog,
+                                       const char           *id,
+                                       GUPnPDIDLLiteWriter  *writer)
+{
+        GUPnPDIDLLiteSnapshot *snapshot;
+        GUPnPDIDLLiteObject *object;
+
+        g_return_val_if_fail (catalog != NULL, NULL);
+        g_return_val_if_fail (id != NULL, NULL);
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+
+        snapshot = gupnp_didl_lite_catalog_lookup (catalog, id);
+        if (snapshot == NULL)
+                return NULL;
+
+        object = gupnp_didl_lite_snapshot_to_object (snapshot, writer);
+        gupnp_didl_lite_snapshot_unref (snapshot);
+
+        return object;
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_new:
+ *
+ * Create a new, empty [struct@GUPnPAV.DIDLLiteCatalogBuilder].
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.DIDLLiteCatalogBuilder].
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteCatalogBuilder *
+gupnp_didl_lite_catalog_builder_new (void)
+{
+        GUPnPDIDLLiteCatalogBuilder *builder;
+
+        builder = g_atomic_rc_box_new0 (GUPnPDIDLLiteCatalogBuilder);
+        builder->snapshots = g_ptr_array_new_with_free_func
+                        ((GDestroyNotify) gupnp_didl_lite_snapshot_unref);
+
+        return builder;
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_ref:
+ * @builder: A [struct@GUPnPAV.DIDLLiteCatalogBuilder]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteCatalogBuilder].
+ *
+ * Returns: (transfer full): The object passed in @builder.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteCatalogBuilder *
+gupnp_didl_lite_catalog_builder_ref (GUPnPDIDLLiteCatalogBuilder *builder)
+{
+        g_return_val_if_fail (builder != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (builder);
+}
+
+static void
+catalog_builder_free (GUPnPDIDLLiteCatalogBuilder *builder)
+{
+        g_ptr_array_unref (builder->snapshots);
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_unref:
+ * @builder: A [struct@GUPnPAV.DIDLLiteCatalogBuilder]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteCatalogBuilder]. If
+ * the reference count drops to 0, @builder is freed.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_catalog_builder_unref (GUPnPDIDLLiteCatalogBuilder *builder)
+{
+        g_return_if_fail (builder != NULL);
+
+        g_atomic_rc_box_release_full (builder,
+                                      (GDestroyNotify) catalog_builder_free);
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_add:
+ * @builder: A [struct@GUPnPAV.DIDLLiteCatalogBuilder]
+ * @snapshot: The [struct@GUPnPAV.DIDLLiteSnapshot] of an object
+ *
+ * Append the object kept in @snapshot to the catalog.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_catalog_builder_add (GUPnPDIDLLiteCatalogBuilder *builder,
+                                     GUPnPDIDLLiteSnapshot       *snapshot)
+{
+        g_return_if_fail (builder != NULL);
+        g_return_if_fail (snapshot != NULL);
+
+        g_ptr_array_add (builder->snapshots,
+                         gupnp_didl_lite_snapshot_ref (snapshot));
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_add_object:
+ * @builder: A [struct@GUPnPAV.DIDLLiteCatalogBuilder]
+ * @object: A #GUPnPDIDLLiteObject
+ *
+ * Append a snapshot of @object to the catalog. Only the parts of @object
+ * kept by a [struct@GUPnPAV.DIDLLiteSnapshot] are stored.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_catalog_builder_add_object
+                                (GUPnPDIDLLiteCatalogBuilder *builder,
+                                 GUPnPDIDLLiteObject         *object)
+{
+        g_return_if_fail (builder != NULL);
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object));
+
+        g_ptr_array_add (builder->snapshots,
+                         gupnp_didl_lite_snapshot_new (object));
+}
+
+static int
+compare_keys (gconstpointer a,
+              gconstpointer b)
+{
+        const CatalogKey *key_a = a;
+        const CatalogKey *key_b = b;
+        int result;
+
+        result = strcmp (key_a->key, key_b->key);
+        if (result != 0)
+                return result;
+
+        /* Keep equal keys in the order the objects were added */
+        return (key_a->index > key_b->index) - (key_a->index < key_b->index);
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_to_bytes:
+ * @builder: A [struct@GUPnPAV.DIDLLiteCatalogBuilder]
+ *
+ * Build a catalog of all objects added to @builder so far. Objects without
+ * an ID can only be found through the children of their parent.
+ *
+ * Returns: (transfer full): The data of the catalog, to be read with
+ * gupnp_didl_lite_catalog_new_from_bytes().
+ *
+ * Since: 0.16
+ **/
+GBytes *
+gupnp_didl_lite_catalog_builder_to_bytes
+                                (GUPnPDIDLLiteCatalogBuilder *builder)
+{
+        GVariantBuilder objects;
+        GVariantBuilder ids;
+        GVariantBuilder parents;
+        GVariantBuilder children;
+        GArray *id_keys;
+        GArray *parent_keys;
+        GVariant *variant;
+        GBytes *bytes;
+        guint first;
+        guint i;
+
+        g_return_val_if_fail (builder != NULL, NULL);
+
+        id_keys = g_array_sized_new (FALSE,
+                                     FALSE,
+                                     sizeof (CatalogKey),
+                                     builder->snapshots->len);
+        parent_keys = g_array_sized_new (FALSE,
+                                         FALSE,
+                                         sizeof (CatalogKey),
+                                         builder->snapshots->len);
+
+        g_variant_builder_init (&objects,
+                                G_VARIANT_TYPE (OBJECTS_VARIANT_TYPE));
+        for (i = 0; i < builder->snapshots->len; i++) {
+                GUPnPDIDLLiteSnapshot *snapshot;
+                const GUPnPDIDLLiteFields *fields;
+                GVariant *value;
+                CatalogKey key;
+
+                snapshot = g_ptr_array_index (builder->snapshots, i);
+                value = gupnp_didl_lite_snapshot_to_variant (snapshot);
+                g_variant_builder_add_value (&objects, value);
+
+                fields = gupnp_didl_lite_snapshot_get_fields (snapshot);
+                key.index = i;
+                if (fields->id != NULL) {
+                        key.key = fields->id;
+                        g_array_append_val (id_keys, key);
+                }
+                if (fields->parent_id != NULL) {
+                        key.key = fields->parent_id;
+                        g_array_append_val (parent_keys, key);
+                }
+        }
+
+        g_array_sort (id_keys, compare_keys);
+        g_variant_builder_init (&ids, G_VARIANT_TYPE ("a(su)"));
+        for (i = 0; i < id_keys->len; i++) {
+                CatalogKey *key = &g_array_index (id_keys, CatalogKey, i);
+
+                g_variant_builder_add (&ids, "(su)", key->key, key->index);
+        }
+
+        g_array_sort (parent_keys, compare_keys);
+        g_variant_builder_init (&parents, G_VARIANT_TYPE ("a(suu)"));
+        g_variant_builder_init (&children, G_VARIANT_TYPE ("au"));
+        first = 0;
+        for (i = 0; i < parent_keys->len; i++) {
+                CatalogKey *key = &g_array_index (parent_keys, CatalogKey, i);
+                CatalogKey *next;
+
+                g_variant_builder_add (&children, "u", key->index);
+
+                if (i + 1 < parent_keys->len) {
+                        next = &g_array_index (parent_keys, CatalogKey, i + 1);
+                        if (strcmp (next->key, key->key) == 0)
+                                continue;
+                }
+
+                g_variant_builder_add (&parents,
+                                       "(suu)",
+                                       key->key,
+                                       first,
+                                       i + 1 - first);
+                first = i + 1;
+        }
+
+        variant = g_variant_new (CATALOG_VARIANT_TYPE,
+                                 CATALOG_MAGIC,
+                                 (guint16) CATALOG_VERSION,
+                                 &objects,
+                                 &ids,
+                                 &parents,
+                                 &children);
+        g_variant_ref_sink (variant);
+        bytes = g_variant_get_data_as_bytes (variant);
+        g_variant_unref (variant);
+
+        g_array_free (id_keys, TRUE);
+        g_array_free (parent_keys, TRUE);
+
+        return bytes;
+}
+
+/**
+ * gupnp_didl_lite_catalog_builder_write:
+ * @builder: A [struct@GUPnPAV.DIDLLiteCatalogBuilder]
+ * @path: The path of the catalog file
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Build a catalog of all objects added to @builder so far and store it at
+ * @path. An existing file at @path is replaced atomically, so catalogs
+ * opened from it stay valid.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_catalog_builder_write (GUPnPDIDLLiteCatalogBuilder *builder,
+                                       const char                  *path,
+                                       GError                     **error)
+{
+        GBytes *bytes;
+        gboolean result;
+
+        g_return_val_if_fail (builder != NULL, FALSE);
+        g_return_val_if_fail (path != NULL, FALSE);
+
+        bytes = gupnp_didl_lite_catalog_builder_to_bytes (builder);
+        result = g_file_set_contents (path,
+                                      g_bytes_get_data (bytes, NULL),
+                                      (gssize) g_bytes_get_size (bytes),
+                                      error);
+        g_bytes_unref (bytes);
+
+        return result;
+}
@@ -0,0 +1,106 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_CATALOG_H
+#define GUPNP_DIDL_LITE_CATALOG_H
+
+#include <gio/gio.h>
+
+#include "gupnp-didl-lite-snapshot.h"
+
+G_BEGIN_DECLS
+
+GType
+gupnp_didl_lite_catalog_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_CATALOG \
+                (gupnp_didl_lite_catalog_get_type ())
+
+typedef struct _GUPnPDIDLLiteCatalog GUPnPDIDLLiteCatalog;
+
+GUPnPDIDLLiteCatalog *
+gupnp_didl_lite_catalog_new_from_file   (const char *path,
+                                         GError    **error);
+
+GUPnPDIDLLiteCatalog *
+gupnp_didl_lite_catalog_new_from_bytes  (GBytes  *bytes,
+                                         GError **error);
+
+GUPnPDIDLLiteCatalog *
+gupnp_didl_lite_catalog_ref             (GUPnPDIDLLiteCatalog *catalog);
+
+void
+gupnp_didl_lite_catalog_unref           (GUPnPDIDLLiteCatalog *catalog);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteCatalog,
+                               gupnp_didl_lite_catalog_unref)
+
+guint
+gupnp_didl_lite_catalog_get_length      (GUPnPDIDLLiteCatalog *catalog);
+
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_catalog_get_snapshot    (GUPnPDIDLLiteCatalog *catalog,
+                                         guint                 index_);
+
+gboolean
+gupnp_didl_lite_catalog_lookup_index    (GUPnPDIDLLiteCatalog *catalog,
+                                         const char           *id,
+                                         guint                *index_);
+
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_catalog_lookup          (GUPnPDIDLLiteCatalog *catalog,
+                                         const char           *id);
+
+const guint32 *
+gupnp_didl_lite_catalog_get_children    (GUPnPDIDLLiteCatalog *catalog,
+                                         const char           *parent_id,
+                                         guint                *n_children);
+
+GUPnPDIDLLiteObject *
+gupnp_didl_lite_catalog_add_to_writer   (GUPnPDIDLLiteCatalog *catalog,
+                                         const char           *id,
+                                         GUPnPDIDLLiteWriter  *writer);
+
+GType
+gupnp_didl_lite_catalog_builder_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_CATALOG_BUILDER \
+                (gupnp_didl_lite_catalog_builder_get_type ())
+
+typedef struct _GUPnPDIDLLiteCatalogBuilder GUPnPDIDLLiteCatalogBuilder;
+
+GUPnPDIDLLiteCatalogBuilder *
+gupnp_didl_lite_catalog_builder_new     (void);
+
+GUPnPDIDLLiteCatalogBuilder *
+gupnp_didl_lite_catalog_builder_ref     (GUPnPDIDLLiteCatalogBuilder *builder);
+
+void
+gupnp_didl_lite_catalog_builder_unref   (GUPnPDIDLLiteCatalogBuilder *builder);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteCatalogBuilder,
+                               gupnp_didl_lite_catalog_builder_unref)
+
+void
+gupnp_didl_lite_catalog_builder_add     (GUPnPDIDLLiteCatalogBuilder *builder,
+                                         GUPnPDIDLLiteSnapshot       *snapshot);
+
+void
+gupnp_didl_lite_catalog_builder_add_object
+                                        (GUPnPDIDLLiteCatalogBuilder *builder,
+                                         GUPnPDIDLLiteObject         *object);
+
+GBytes *
+gupnp_didl_lite_catalog_builder_to_bytes
+                                        (GUPnPDIDLLiteCatalogBuilder *builder);
+
+gboolean
+gupnp_didl_lite_catalog_builder_write   (GUPnPDIDLLiteCatalogBuilder *builder,
+                                         const char                  *path,
+                                         GError                     **error);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_CATALOG_H__ */
@@ -254,7 +254,7 @@ gupnp_didl_lite_container_get_searchable (GUPnPDIDLLiteContainer *container)
         g_return_val_if_fail (container != NULL, FALSE);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), FALSE);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
 
         return av_xml_util_get_boolean_attribute (xml_node, "searchable");
@@ -278,7 +278,7 @@ gupnp_didl_lite_container_get_child_count (GUPnPDIDLLiteContainer *container)
         g_return_val_if_fail (container != NULL, 0);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), 0);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
 
         return av_xml_util_get_int_attribute (xml_node, "childCount", -1);
@@ -296,17 +296,18 @@ guint
 gupnp_didl_lite_container_get_container_update_id
                                         (GUPnPDIDLLiteContainer *container)
 {
-        xmlNode *xml_node;
+        const char *content;
 
         g_return_val_if_fail (container != NULL, 0);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), 0);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
-                                (GUPNP_DIDL_LITE_OBJECT (container));
+        content = gupnp_didl_lite_object_get_property_content
+                        (GUPNP_DIDL_LITE_OBJECT (container),
+                         GUPNP_DIDL_LITE_PROPERTY_CONTAINER_UPDATE_ID);
+        if (content == NULL)
+                return 0;
 
-        return av_xml_util_get_uint_child_element (xml_node,
-                                                   "containerUpdateID",
-                                                   0);
+        return strtoul (content, NULL, 0);
 }
 
 /**
@@ -322,15 +323,13 @@ gupnp_didl_lite_container_container_update_id_is_set
                                         (GUPnPDIDLLiteContainer *container)
 {
         const char *content;
-        xmlNode *xml_node;
 
         g_return_val_if_fail (container != NULL, FALSE);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), FALSE);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
-                                        (GUPNP_DIDL_LITE_OBJECT (container));
-        content = av_xml_util_get_child_element_content (xml_node,
-                                                         "containerUpdateID");
+        content = gupnp_didl_lite_object_get_property_content
+                        (GUPNP_DIDL_LITE_OBJECT (container),
+                         GUPNP_DIDL_LITE_PROPERTY_CONTAINER_UPDATE_ID);
         return content != NULL;
 }
 
@@ -346,17 +345,18 @@ guint
 gupnp_didl_lite_container_get_total_deleted_child_count
                                         (GUPnPDIDLLiteContainer *container)
 {
-        xmlNode *xml_node;
+        const char *content;
 
         g_return_val_if_fail (container != NULL, 0);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), 0);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
-                                (GUPNP_DIDL_LITE_OBJECT (container));
+        content = gupnp_didl_lite_object_get_property_content
+                        (GUPNP_DIDL_LITE_OBJECT (container),
+                         GUPNP_DIDL_LITE_PROPERTY_TOTAL_DELETED_CHILD_COUNT);
+        if (content == NULL)
+                return -1;
 
-        return av_xml_util_get_uint_child_element (xml_node,
-                                                   "totalDeletedChildCount",
-                                                   -1);
+        return strtoul (content, NULL, 0);
 }
 
 /**
@@ -372,15 +372,13 @@ gupnp_didl_lite_container_total_deleted_child_count_is_set
                                         (GUPnPDIDLLiteContainer *container)
 {
         const char *content;
-        xmlNode *xml_node;
 
         g_return_val_if_fail (container != NULL, FALSE);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), FALSE);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
-                                        (GUPNP_DIDL_LITE_OBJECT (container));
-        content = av_xml_util_get_child_element_content (xml_node,
-                                                         "totalDeletedChildCount");
+        content = gupnp_didl_lite_object_get_property_content
+                        (GUPNP_DIDL_LITE_OBJECT (container),
+                         GUPNP_DIDL_LITE_PROPERTY_TOTAL_DELETED_CHILD_COUNT);
         return content != NULL;
 }
 /**
@@ -525,15 +523,14 @@ gupnp_didl_lite_container_get_search_classes (GUPnPDIDLLiteContainer *container)
 gint64
 gupnp_didl_lite_container_get_storage_used (GUPnPDIDLLiteContainer *container)
 {
-        xmlNode *xml_node;
         const char *str;
 
         g_return_val_if_fail (container != NULL, 0);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), 0);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
-                                (GUPNP_DIDL_LITE_OBJECT (container));
-        str = av_xml_util_get_child_element_content (xml_node, "storageUsed");
+        str = gupnp_didl_lite_object_get_property_content
+                        (GUPNP_DIDL_LITE_OBJECT (container),
+                         GUPNP_DIDL_LITE_PROPERTY_STORAGE_USED);
         if (str == NULL)
                 return -1;
 
@@ -556,7 +553,15 @@ gupnp_didl_lite_container_set_searchable (GUPnPDIDLLiteContainer *container,
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        if (!gupnp_didl_lite_object_wants_attribute
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 NULL,
+                                 "searchable",
+                                 NULL,
+                                 NULL))
+                return;
+
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
 
         if (searchable)
@@ -587,7 +592,15 @@ gupnp_didl_lite_container_set_child_count (GUPnPDIDLLiteContainer *container,
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        if (!gupnp_didl_lite_object_wants_attribute
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 NULL,
+                                 "childCount",
+                                 NULL,
+                                 NULL))
+                return;
+
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
 
         str = g_strdup_printf ("%d", child_count);
@@ -621,7 +634,12 @@ gupnp_didl_lite_container_set_container_update_id
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
         self_as_object = GUPNP_DIDL_LITE_OBJECT (container);
-        xml_node = gupnp_didl_lite_object_get_xml_node (self_as_object);
+        if (!gupnp_didl_lite_object_wants_property (self_as_object,
+                                                    "upnp",
+                                                    "containerUpdateID"))
+                return;
+
+        xml_node = gupnp_didl_lite_object_peek_xml_node (self_as_object);
         xml_doc = gupnp_didl_lite_object_get_gupnp_xml_doc (self_as_object);
         upnp_ns = gupnp_didl_lite_object_get_upnp_namespace (self_as_object);
 
@@ -652,7 +670,7 @@ gupnp_didl_lite_container_unset_container_update_id
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                         (GUPNP_DIDL_LITE_OBJECT (container));
         av_xml_util_unset_child (xml_node, "containerUpdateID");
 
@@ -681,7 +699,12 @@ gupnp_didl_lite_container_set_total_deleted_child_count
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
         self_as_object = GUPNP_DIDL_LITE_OBJECT (container);
-        xml_node = gupnp_didl_lite_object_get_xml_node (self_as_object);
+        if (!gupnp_didl_lite_object_wants_property (self_as_object,
+                                                    "upnp",
+                                                    "totalDeletedChildCount"))
+                return;
+
+        xml_node = gupnp_didl_lite_object_peek_xml_node (self_as_object);
         xml_doc = gupnp_didl_lite_object_get_gupnp_xml_doc (self_as_object);
         upnp_ns = gupnp_didl_lite_object_get_upnp_namespace (self_as_object);
 
@@ -712,7 +735,7 @@ gupnp_didl_lite_container_unset_total_deleted_child_count
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                         (GUPNP_DIDL_LITE_OBJECT (container));
         av_xml_util_unset_child (xml_node, "totalDeletedChildCount");
 
@@ -760,7 +783,13 @@ gupnp_didl_lite_container_add_create_class_full (
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        container_node = gupnp_didl_lite_object_get_xml_node
+        if (!gupnp_didl_lite_object_wants_property
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 "upnp",
+                                 "createClass"))
+                return;
+
+        container_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
         namespace = gupnp_didl_lite_object_get_upnp_namespace
                                 (GUPNP_DIDL_LITE_OBJECT (container));
@@ -769,14 +798,21 @@ gupnp_didl_lite_container_add_create_class_full (
                                 namespace,
                                 (unsigned char *) "createClass",
                                 (unsigned char *) create_class);
+        av_xml_doc_touch (new_node->doc);
         if (include_derived)
                 str = "1";
         else
                 str = "0";
 
-        xmlSetProp (new_node,
-                    (unsigned char *) "includeDerived",
-                    (unsigned char *) str);
+        if (gupnp_didl_lite_object_wants_attribute
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 NULL,
+                                 "includeDerived",
+                                 "upnp",
+                                 "createClass"))
+                xmlSetProp (new_node,
+                            (unsigned char *) "includeDerived",
+                            (unsigned char *) str);
 }
 
 /**
@@ -822,7 +858,13 @@ gupnp_didl_lite_container_add_search_class_full (
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        if (!gupnp_didl_lite_object_wants_property
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 "upnp",
+                                 "searchClass"))
+                return;
+
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
         namespace = gupnp_didl_lite_object_get_upnp_namespace
                                 (GUPNP_DIDL_LITE_OBJECT (container));
@@ -831,15 +873,22 @@ gupnp_didl_lite_container_add_search_class_full (
                                     namespace,
                                     (unsigned char *) "searchClass",
                                     (unsigned char *) search_class);
+        av_xml_doc_touch (new_xml_node->doc);
 
         if (include_derived)
                 str = "1";
         else
                 str = "0";
 
-        xmlSetProp (new_xml_node,
-                    (unsigned char*) "includeDerived",
-                    (unsigned char*) str);
+        if (gupnp_didl_lite_object_wants_attribute
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 NULL,
+                                 "includeDerived",
+                                 "upnp",
+                                 "searchClass"))
+                xmlSetProp (new_xml_node,
+                            (unsigned char*) "includeDerived",
+                            (unsigned char*) str);
 }
 
 /**
@@ -863,7 +912,13 @@ gupnp_didl_lite_container_set_storage_used (
         g_return_if_fail (container != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        if (!gupnp_didl_lite_object_wants_property
+                                (GUPNP_DIDL_LITE_OBJECT (container),
+                                 "upnp",
+                                 "storageUsed"))
+                return;
+
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (container));
 
         namespace = gupnp_didl_lite_object_get_upnp_namespace
@@ -874,15 +929,17 @@ gupnp_didl_lite_container_set_storage_used (
         storage = gupnp_didl_lite_object_get_properties (
                                         GUPNP_DIDL_LITE_OBJECT (container),
                                         "storageUsed");
-        if (storage == NULL)
+        if (storage == NULL) {
                 xmlNewChild (xml_node,
                              namespace,
                              (unsigned char *) "storageUsed",
                              (unsigned char *) str);
-        else
+                av_xml_doc_touch (xml_node->doc);
+        } else
                 xmlNodeSetContent ((xmlNode *) storage->data,
                                    (unsigned char *) str);
 
+        g_list_free (storage);
         g_free (str);
 
         g_object_notify (G_OBJECT (container), "storage-used");
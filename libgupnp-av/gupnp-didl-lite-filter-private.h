@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_FILTER_PRIVATE_H
+#define GUPNP_DIDL_LITE_FILTER_PRIVATE_H
+
+#include "gupnp-didl-lite-filter.h"
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL gboolean
+gupnp_didl_lite_filter_is_node_allowed  (GUPnPDIDLLiteFilter *filter,
+                                         const char          *prefix,
+                                         const char          *name);
+
+G_GNUC_INTERNAL gboolean
+gupnp_didl_lite_filter_is_attribute_allowed
+                                        (GUPnPDIDLLiteFilter *filter,
+                                         const char          *prefix,
+                                         const char          *name,
+                                         const char          *parent_prefix,
+                                         const char          *parent_name);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_FILTER_PRIVATE_H__ */
@@ -0,0 +1,319 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPDIDLLiteFilter:
+ *
+ * A compiled Browse or Search filter
+ *
+ * The 'Filter' argument of the Browse and Search actions of a
+ * ContentDirectory names the properties a control point wants to see.
+ * A [struct@GUPnPAV.DIDLLiteFilter] splits such a string once into sets of
+ * element and attribute names, so applying it with
+ * gupnp_didl_lite_writer_apply_filter() takes a hash lookup per node instead
+ * of a walk over all the names in the string. Handed to
+ * gupnp_didl_lite_writer_set_filter() up front, it keeps the excluded
+ * properties from being added at all.
+ *
+ * A filter is immutable, so it can be kept around, e.g. for all requests of
+ * the same control point, and shared between threads.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "gupnp-didl-lite-filter.h"
+#include "gupnp-didl-lite-filter-private.h"
+
+/* A name in a filter, and the element it is an attribute of, if any. A
+ * %NULL prefix means the name is unqualified. */
+typedef struct {
+        const char *parent_prefix;
+        const char *parent_name;
+        const char *prefix;
+        const char *name;
+} FilterKey;
+
+struct _GUPnPDIDLLiteFilter {
+        char       *string;
+        gboolean    wildcard;
+
+        /* The string again, cut into the names the keys point to */
+        char       *names;
+        FilterKey  *keys;
+
+        /* Elements, attributes of any element and attributes of a given
+         * element the filter asks for */
+        GHashTable *elements;
+        GHashTable *attributes;
+        GHashTable *element_attributes;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteFilter,
+                     gupnp_didl_lite_filter,
+                     gupnp_didl_lite_filter_ref,
+                     gupnp_didl_lite_filter_unref)
+
+static guint
+filter_key_hash (gconstpointer data)
+{
+        const FilterKey *key = data;
+        guint hash;
+
+        hash = g_str_hash (key->name);
+        if (key->prefix != NULL)
+                hash = hash * 31 + g_str_hash (key->prefix);
+        if (key->parent_name != NULL)
+                hash = hash * 31 + g_str_hash (key->parent_name);
+        if (key->parent_prefix != NULL)
+                hash = hash * 31 + g_str_hash (key->parent_prefix);
+
+        return hash;
+}
+
+static gboolean
+filter_key_equal (gconstpointer a,
+                  gconstpointer b)
+{
+        const FilterKey *key_a = a;
+        const FilterKey *key_b = b;
+
+        return strcmp (key_a->name, key_b->name) == 0 &&
+               g_strcmp0 (key_a->prefix, key_b->prefix) == 0 &&
+               g_strcmp0 (key_a->parent_name, key_b->parent_name) == 0 &&
+               g_strcmp0 (key_a->parent_prefix, key_b->parent_prefix) == 0;
+}
+
+/* Cuts @qname into the prefix and local name of @key */
+static void
+split_qname (char      *qname,
+             FilterKey *key)
+{
+        char *colon;
+
+        colon = strchr (qname, ':');
+        if (colon == NULL) {
+                key->prefix = NULL;
+                key->name = qname;
+        } else {
+                *colon = '\0';
+                key->prefix = qname;
+                key->name = colon + 1;
+        }
+}
+
+/**
+ * gupnp_didl_lite_filter_new:
+ * @filter: A filter string
+ *
+ * Compile @filter, as passed to gupnp_didl_lite_writer_filter(). Please
+ * refer to Section 2.3.15 of UPnP AV ContentDirectory version 3
+ * specification for details on this string.
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.DIDLLiteFilter].
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteFilter *
+gupnp_didl_lite_filter_new (const char *filter)
+{
+        GUPnPDIDLLiteFilter *compiled;
+        const char *p;
+        char *token;
+        guint n_tokens = 1;
+        guint n_keys = 0;
+
+        g_return_val_if_fail (filter != NULL, NULL);
+
+        compiled = g_atomic_rc_box_new0 (GUPnPDIDLLiteFilter);
+        compiled->string = g_strdup (filter);
+        compiled->elements = g_hash_table_new (filter_key_hash,
+                                               filter_key_equal);
+        compiled->attributes = g_hash_table_new (filter_key_hash,
+                                                 filter_key_equal);
+        compiled->element_attributes = g_hash_table_new (filter_key_hash,
+                                                         filter_key_equal);
+
+        if (filter[0] == '*') {
+                compiled->wildcard = TRUE;
+
+                return compiled;
+        }
+
+        for (p = filter; *p != '\0'; p++)
+                if (*p == ',')
+                        n_tokens++;
+
+        /* No token needs more than two keys */
+        compiled->names = g_strdup (filter);
+        compiled->keys = g_new0 (FilterKey, 2 * n_tokens);
+
+        token = compiled->names;
+        while (token != NULL) {
+                char *next;
+                char *at;
+                FilterKey *key;
+
+                next = strchr (token, ',');
+                if (next != NULL)
+                        *next++ = '\0';
+
+                at = strchr (token, '@');
+                if (at == NULL) {
+                        /* An element, also allowed as attribute of any
+                         * element */
+                        key = &compiled->keys[n_keys++];
+                        split_qname (token, key);
+                        g_hash_table_add (compiled->elements, key);
+                        g_hash_table_add (compiled->attributes, key);
+                } else if (at == token) {
+                        /* An attribute of any element */
+                        key = &compiled->keys[n_keys++];
+                        split_qname (at + 1, key);
+                        g_hash_table_add (compiled->attributes, key);
+                } else {
+                        FilterKey *attribute;
+
+                        /* An attribute of the named element, which is then
+                         * allowed as well */
+                        *at = '\0';
+                        key = &compiled->keys[n_keys++];
+                        split_qname (token, key);
+                        g_hash_table_add (compiled->elements, key);
+
+                        attribute = &compiled->keys[n_keys++];
+                        split_qname (at + 1, attribute);
+                        attribute->parent_prefix = key->prefix;
+                        attribute->parent_name = key->name;
+                        g_hash_table_add (compiled->element_attributes,
+                                          attribute);
+                }
+
+                token = next;
+        }
+
+        return compiled;
+}
+
+/**
+ * gupnp_didl_lite_filter_ref:
+ * @filter: A [struct@GUPnPAV.DIDLLiteFilter]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteFilter].
+ *
+ * Returns: (transfer full): The object passed in @filter.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteFilter *
+gupnp_didl_lite_filter_ref (GUPnPDIDLLiteFilter *filter)
+{
+        g_return_val_if_fail (filter != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (filter);
+}
+
+static void
+filter_free (GUPnPDIDLLiteFilter *filter)
+{
+        g_hash_table_destroy (filter->elements);
+        g_hash_table_destroy (filter->attributes);
+        g_hash_table_destroy (filter->element_attributes);
+        g_free (filter->keys);
+        g_free (filter->names);
+        g_free (filter->string);
+}
+
+/**
+ * gupnp_didl_lite_filter_unref:
+ * @filter: A [struct@GUPnPAV.DIDLLiteFilter]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteFilter]. If the
+ * reference count drops to 0, @filter is freed.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_filter_unref (GUPnPDIDLLiteFilter *filter)
+{
+        g_return_if_fail (filter != NULL);
+
+        g_atomic_rc_box_release_full (filter, (GDestroyNotify) filter_free);
+}
+
+/**
+ * gupnp_didl_lite_filter_get_string:
+ * @filter: A [struct@GUPnPAV.DIDLLiteFilter]
+ *
+ * Get the string @filter was compiled from.
+ *
+ * Returns: The filter string.
+ *
+ * Since: 0.16
+ **/
+const char *
+gupnp_didl_lite_filter_get_string (GUPnPDIDLLiteFilter *filter)
+{
+        g_return_val_if_fail (filter != NULL, NULL);
+
+        return filter->string;
+}
+
+/**
+ * gupnp_didl_lite_filter_is_wildcard:
+ * @filter: A [struct@GUPnPAV.DIDLLiteFilter]
+ *
+ * Whether @filter is the wildcard filter "*", which keeps all properties.
+ *
+ * Returns: %TRUE for the wildcard filter.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_filter_is_wildcard (GUPnPDIDLLiteFilter *filter)
+{
+        g_return_val_if_fail (filter != NULL, FALSE);
+
+        return filter->wildcard;
+}
+
+/* Whether an element is named by @filter, either on its own or as the
+ * parent of an attribute */
+gboolean
+gupnp_didl_lite_filter_is_node_allowed (GUPnPDIDLLiteFilter *filter,
+                                        const char          *prefix,
+                                        const char          *name)
+{
+        FilterKey key = { NULL, NULL, prefix, name };
+
+        if (filter->wildcard)
+                return TRUE;
+
+        return g_hash_table_contains (filter->elements, &key);
+}
+
+/* Whether an attribute is named by @filter, for any element or for the
+ * element @parent_prefix:@parent_name */
+gboolean
+gupnp_didl_lite_filter_is_attribute_allowed (GUPnPDIDLLiteFilter *filter,
+                                             const char          *prefix,
+                                             const char          *name,
+                                             const char          *parent_prefix,
+                                             const char          *parent_name)
+{
+        FilterKey key = { NULL, NULL, prefix, name };
+
+        if (filter->wildcard ||
+            g_hash_table_contains (filter->attributes, &key))
+                return TRUE;
+
+        key.parent_prefix = parent_prefix;
+        key.parent_name = parent_name;
+
+        return g_hash_table_contains (filter->element_attributes, &key);
+}
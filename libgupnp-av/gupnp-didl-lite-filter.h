@@ -0,0 +1,41 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_FILTER_H
+#define GUPNP_DIDL_LITE_FILTER_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+GType
+gupnp_didl_lite_filter_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_FILTER \
+                (gupnp_didl_lite_filter_get_type ())
+
+typedef struct _GUPnPDIDLLiteFilter GUPnPDIDLLiteFilter;
+
+GUPnPDIDLLiteFilter *
+gupnp_didl_lite_filter_new              (const char *filter);
+
+GUPnPDIDLLiteFilter *
+gupnp_didl_lite_filter_ref              (GUPnPDIDLLiteFilter *filter);
+
+void
+gupnp_didl_lite_filter_unref            (GUPnPDIDLLiteFilter *filter);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteFilter,
+                               gupnp_didl_lite_filter_unref)
+
+const char *
+gupnp_didl_lite_filter_get_string       (GUPnPDIDLLiteFilter *filter);
+
+gboolean
+gupnp_didl_lite_filter_is_wildcard      (GUPnPDIDLLiteFilter *filter);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_FILTER_H__ */
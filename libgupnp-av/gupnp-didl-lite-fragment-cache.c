@@ -0,0 +1,395 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPDIDLLiteFragmentCache:
+ *
+ * A cache of serialized DIDL-Lite objects
+ *
+ * Most objects of a media library rarely change, so a server does not need
+ * to build and serialize them again for every Browse. A
+ * [struct@GUPnPAV.DIDLLiteFragmentCache] keeps the DIDL-Lite XML of an
+ * object, as the filter of a request left it, keyed by the object ID, its
+ * `upnp:objectUpdateID` and the filter string. A cached fragment is added to
+ * a #GUPnPDIDLLiteWriter with gupnp_didl_lite_writer_add_serialized(), which
+ * copies it into the output as is.
+ *
+ * A bumped update ID makes the old fragments of an object unreachable, they
+ * are evicted as the least recently used entries once the cache is full.
+ * Use gupnp_didl_lite_fragment_cache_remove() to drop them right away.
+ *
+ * The cache is safe to use from several threads at the same time.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "gupnp-didl-lite-fragment-cache.h"
+
+typedef struct {
+        char   *id;
+        guint   update_id;
+        char   *filter;
+        GBytes *fragment;
+
+        /* Position in the queue of recently used entries */
+        GList   link;
+} CacheEntry;
+
+struct _GUPnPDIDLLiteFragmentCache {
+        GMutex      mutex;
+        guint       max_entries;
+
+        /* The entries, also used as keys, and the entries again, the most
+         * recently used first */
+        GHashTable *entries;
+        GQueue      queue;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteFragmentCache,
+                     gupnp_didl_lite_fragment_cache,
+                     gupnp_didl_lite_fragment_cache_ref,
+                     gupnp_didl_lite_fragment_cache_unref)
+
+static guint
+cache_entry_hash (gconstpointer data)
+{
+        const CacheEntry *entry = data;
+
+        return (g_str_hash (entry->id) * 31 + entry->update_id) * 31 +
+               g_str_hash (entry->filter);
+}
+
+static gboolean
+cache_entry_equal (gconstpointer a,
+                   gconstpointer b)
+{
+        const CacheEntry *entry_a = a;
+        const CacheEntry *entry_b = b;
+
+        return entry_a->update_id == entry_b->update_id &&
+               strcmp (entry_a->id, entry_b->id) == 0 &&
+               strcmp (entry_a->filter, entry_b->filter) == 0;
+}
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+        g_free (entry->id);
+        g_free (entry->filter);
+        g_bytes_unref (entry->fragment);
+        g_free (entry);
+}
+
+/* The string identifying the fragments made with @filter. No filter and
+ * the wildcard filter keep all properties, so they share it. */
+static const char *
+get_fingerprint (GUPnPDIDLLiteFilter *filter)
+{
+        if (filter == NULL || gupnp_didl_lite_filter_is_wildcard (filter))
+                return "*";
+
+        return gupnp_didl_lite_filter_get_string (filter);
+}
+
+/* Takes @entry out of the queue and the table and frees it */
+static void
+remove_entry (GUPnPDIDLLiteFragmentCache *cache,
+              CacheEntry                 *entry)
+{
+        g_queue_unlink (&cache->queue, &entry->link);
+        g_hash_table_remove (cache->entries, entry);
+        cache_entry_free (entry);
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_new:
+ * @max_entries: The number of fragments to keep at most, 0 for no limit
+ *
+ * Create an empty cache. Once it holds @max_entries fragments, adding
+ * another one evicts the least recently used.
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.DIDLLiteFragmentCache].
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteFragmentCache *
+gupnp_didl_lite_fragment_cache_new (guint max_entries)
+{
+        GUPnPDIDLLiteFragmentCache *cache;
+
+        cache = g_atomic_rc_box_new0 (GUPnPDIDLLiteFragmentCache);
+        g_mutex_init (&cache->mutex);
+        cache->max_entries = max_entries;
+        cache->entries = g_hash_table_new (cache_entry_hash,
+                                           cache_entry_equal);
+        g_queue_init (&cache->queue);
+
+        return cache;
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_ref:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteFragmentCache].
+ *
+ * Returns: (transfer full): The object passed in @cache.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteFragmentCache *
+gupnp_didl_lite_fragment_cache_ref (GUPnPDIDLLiteFragmentCache *cache)
+{
+        g_return_val_if_fail (cache != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (cache);
+}
+
+static void
+fragment_cache_free (GUPnPDIDLLiteFragmentCache *cache)
+{
+        gupnp_didl_lite_fragment_cache_clear (cache);
+        g_hash_table_destroy (cache->entries);
+        g_mutex_clear (&cache->mutex);
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_unref:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteFragmentCache]. If
+ * the reference count drops to 0, @cache is freed.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_fragment_cache_unref (GUPnPDIDLLiteFragmentCache *cache)
+{
+        g_return_if_fail (cache != NULL);
+
+        g_atomic_rc_box_release_full (cache,
+                                      (GDestroyNotify) fragment_cache_free);
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_lookup:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ * @id: The ID of the object
+ * @update_id: The update ID of the object
+ * @filter: (nullable): The filter of the request, or %NULL for all
+ * properties
+ *
+ * Look up the fragment of the object @id at @update_id, filtered with
+ * @filter.
+ *
+ * Returns: (transfer full) (nullable): The fragment, or %NULL if it is not
+ * cached.
+ *
+ * Since: 0.16
+ **/
+GBytes *
+gupnp_didl_lite_fragment_cache_lookup (GUPnPDIDLLiteFragmentCache *cache,
+                                       const char                 *id,
+                                       guint                       update_id,
+                                       GUPnPDIDLLiteFilter        *filter)
+{
+        CacheEntry key = { NULL, };
+        CacheEntry *entry;
+        GBytes *fragment = NULL;
+
+        g_return_val_if_fail (cache != NULL, NULL);
+        g_return_val_if_fail (id != NULL, NULL);
+
+        key.id = (char *) id;
+        key.update_id = update_id;
+        key.filter = (char *) get_fingerprint (filter);
+
+        g_mutex_lock (&cache->mutex);
+
+        entry = g_hash_table_lookup (cache->entries, &key);
+        if (entry != NULL) {
+                g_queue_unlink (&cache->queue, &entry->link);
+                g_queue_push_head_link (&cache->queue, &entry->link);
+                fragment = g_bytes_ref (entry->fragment);
+        }
+
+        g_mutex_unlock (&cache->mutex);
+
+        return fragment;
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_insert:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ * @id: The ID of the object
+ * @update_id: The update ID of the object
+ * @filter: (nullable): The filter @fragment was made with, or %NULL for all
+ * properties
+ * @fragment: The serialized object
+ *
+ * Add the fragment of the object @id at @update_id, filtered with @filter,
+ * replacing the one cached before, if any.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_fragment_cache_insert (GUPnPDIDLLiteFragmentCache *cache,
+                                       const char                 *id,
+                                       guint                       update_id,
+                                       GUPnPDIDLLiteFilter        *filter,
+                                       GBytes                     *fragment)
+{
+        CacheEntry *entry;
+        CacheEntry *old;
+
+        g_return_if_fail (cache != NULL);
+        g_return_if_fail (id != NULL);
+        g_return_if_fail (fragment != NULL);
+
+        entry = g_new0 (CacheEntry, 1);
+        entry->id = g_strdup (id);
+        entry->update_id = update_id;
+        entry->filter = g_strdup (get_fingerprint (filter));
+        entry->fragment = g_bytes_ref (fragment);
+        entry->link.data = entry;
+
+        g_mutex_lock (&cache->mutex);
+
+        old = g_hash_table_lookup (cache->entries, entry);
+        if (old != NULL)
+                remove_entry (cache, old);
+
+        g_hash_table_add (cache->entries, entry);
+        g_queue_push_head_link (&cache->queue, &entry->link);
+
+        while (cache->max_entries > 0 &&
+               cache->queue.length > cache->max_entries)
+                remove_entry (cache, cache->queue.tail->data);
+
+        g_mutex_unlock (&cache->mutex);
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_insert_object:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ * @object: The #GUPnPDIDLLiteObject
+ * @filter: (nullable): The filter @object has been filtered with, or %NULL
+ *
+ * Serialize @object and add it under its ID and update ID, which is 0 if
+ * it has none. @object is expected to be created by a #GUPnPDIDLLiteWriter
+ * and to hold the properties @filter keeps, i.e. to be filtered already.
+ *
+ * Returns: (transfer full): The fragment, to add it to the writer of the
+ * current response as well.
+ *
+ * Since: 0.16
+ **/
+GBytes *
+gupnp_didl_lite_fragment_cache_insert_object
+                                        (GUPnPDIDLLiteFragmentCache *cache,
+                                         GUPnPDIDLLiteObject        *object,
+                                         GUPnPDIDLLiteFilter        *filter)
+{
+        const char *id;
+        GBytes *fragment;
+
+        g_return_val_if_fail (cache != NULL, NULL);
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+
+        id = gupnp_didl_lite_object_get_id (object);
+        g_return_val_if_fail (id != NULL, NULL);
+
+        fragment = gupnp_didl_lite_object_get_xml_bytes (object);
+        gupnp_didl_lite_fragment_cache_insert
+                                (cache,
+                                 id,
+                                 gupnp_didl_lite_object_get_update_id (object),
+                                 filter,
+                                 fragment);
+
+        return fragment;
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_remove:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ * @id: The ID of an object
+ *
+ * Remove all fragments of the object @id, of any update ID and filter.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_fragment_cache_remove (GUPnPDIDLLiteFragmentCache *cache,
+                                       const char                 *id)
+{
+        GList *link;
+        GList *next;
+
+        g_return_if_fail (cache != NULL);
+        g_return_if_fail (id != NULL);
+
+        g_mutex_lock (&cache->mutex);
+
+        for (link = cache->queue.head; link != NULL; link = next) {
+                CacheEntry *entry = link->data;
+
+                next = link->next;
+
+                if (strcmp (entry->id, id) == 0)
+                        remove_entry (cache, entry);
+        }
+
+        g_mutex_unlock (&cache->mutex);
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_clear:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ *
+ * Remove all fragments from @cache.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_fragment_cache_clear (GUPnPDIDLLiteFragmentCache *cache)
+{
+        g_return_if_fail (cache != NULL);
+
+        g_mutex_lock (&cache->mutex);
+
+        while (cache->queue.head != NULL)
+                remove_entry (cache, cache->queue.head->data);
+
+        g_mutex_unlock (&cache->mutex);
+}
+
+/**
+ * gupnp_didl_lite_fragment_cache_get_length:
+ * @cache: A [struct@GUPnPAV.DIDLLiteFragmentCache]
+ *
+ * Get the number of fragments in @cache.
+ *
+ * Returns: The number of fragments.
+ *
+ * Since: 0.16
+ **/
+guint
+gupnp_didl_lite_fragment_cache_get_length (GUPnPDIDLLiteFragmentCache *cache)
+{
+        guint length;
+
+        g_return_val_if_fail (cache != NULL, 0);
+
+        g_mutex_lock (&cache->mutex);
+        length = cache->queue.length;
+        g_mutex_unlock (&cache->mutex);
+
+        return length;
+}
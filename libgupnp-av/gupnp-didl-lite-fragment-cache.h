@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_FRAGMENT_CACHE_H
+#define GUPNP_DIDL_LITE_FRAGMENT_CACHE_H
+
+#include <glib-object.h>
+
+#include "gupnp-didl-lite-filter.h"
+#include "gupnp-didl-lite-object.h"
+
+G_BEGIN_DECLS
+
+GType
+gupnp_didl_lite_fragment_cache_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_FRAGMENT_CACHE \
+                (gupnp_didl_lite_fragment_cache_get_type ())
+
+typedef struct _GUPnPDIDLLiteFragmentCache GUPnPDIDLLiteFragmentCache;
+
+GUPnPDIDLLiteFragmentCache *
+gupnp_didl_lite_fragment_cache_new      (guint max_entries);
+
+GUPnPDIDLLiteFragmentCache *
+gupnp_didl_lite_fragment_cache_ref      (GUPnPDIDLLiteFragmentCache *cache);
+
+void
+gupnp_didl_lite_fragment_cache_unref    (GUPnPDIDLLiteFragmentCache *cache);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteFragmentCache,
+                               gupnp_didl_lite_fragment_cache_unref)
+
+GBytes *
+gupnp_didl_lite_fragment_cache_lookup   (GUPnPDIDLLiteFragmentCache *cache,
+                                         const char                 *id,
+                                         guint                       update_id,
+                                         GUPnPDIDLLiteFilter        *filter);
+
+void
+gupnp_didl_lite_fragment_cache_insert   (GUPnPDIDLLiteFragmentCache *cache,
+                                         const char                 *id,
+                                         guint                       update_id,
+                                         GUPnPDIDLLiteFilter        *filter,
+                                         GBytes                     *fragment);
+
+GBytes *
+gupnp_didl_lite_fragment_cache_insert_object
+                                        (GUPnPDIDLLiteFragmentCache *cache,
+                                         GUPnPDIDLLiteObject        *object,
+                                         GUPnPDIDLLiteFilter        *filter);
+
+void
+gupnp_didl_lite_fragment_cache_remove   (GUPnPDIDLLiteFragmentCache *cache,
+                                         const char                 *id);
+
+void
+gupnp_didl_lite_fragment_cache_clear    (GUPnPDIDLLiteFragmentCache *cache);
+
+guint
+gupnp_didl_lite_fragment_cache_get_length
+                                        (GUPnPDIDLLiteFragmentCache *cache);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_FRAGMENT_CACHE_H__ */
@@ -20,6 +20,7 @@
 #include <string.h>
 
 #include "gupnp-didl-lite-item.h"
+#include "gupnp-didl-lite-object-private.h"
 #include "xml-util.h"
 #include "time-utils.h"
 
@@ -154,7 +155,7 @@ gupnp_didl_lite_item_get_ref_id (GUPnPDIDLLiteItem *item)
         g_return_val_if_fail (item != NULL, 0);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_ITEM (item), NULL);
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                         (GUPNP_DIDL_LITE_OBJECT (item));
 
         return av_xml_util_get_attribute_content (xml_node, "refID");
@@ -176,7 +177,7 @@ gupnp_didl_lite_item_set_ref_id (GUPnPDIDLLiteItem *item,
         g_return_if_fail (item != NULL);
         g_return_if_fail (GUPNP_IS_DIDL_LITE_ITEM (item));
 
-        xml_node = gupnp_didl_lite_object_get_xml_node
+        xml_node = gupnp_didl_lite_object_peek_xml_node
                                 (GUPNP_DIDL_LITE_OBJECT (item));
 
         xmlSetProp (xml_node,
@@ -205,7 +206,11 @@ gupnp_didl_lite_item_set_lifetime (GUPnPDIDLLiteItem *item,
         g_return_if_fail (GUPNP_IS_DIDL_LITE_ITEM (item));
 
         object = GUPNP_DIDL_LITE_OBJECT (item);
-        node = gupnp_didl_lite_object_get_xml_node (object);
+        if (lifetime >= 0 &&
+            !gupnp_didl_lite_object_wants_property (object, "dlna", "lifetime"))
+                return;
+
+        node = gupnp_didl_lite_object_peek_xml_node (object);
         ns = gupnp_didl_lite_object_get_dlna_namespace (object);
         g_object_get (G_OBJECT (object), "xml-doc", &doc, NULL);
 
@@ -236,7 +241,6 @@ gupnp_didl_lite_item_set_lifetime (GUPnPDIDLLiteItem *item,
 glong
 gupnp_didl_lite_item_get_lifetime (GUPnPDIDLLiteItem *item)
 {
-        xmlNode *node = NULL;
         const char *lifetime_str;
         long lifetime;
         GUPnPDIDLLiteObject *object = NULL;
@@ -244,10 +248,9 @@ gupnp_didl_lite_item_get_lifetime (GUPnPDIDLLiteItem *item)
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_ITEM (item), -1);
 
         object = GUPNP_DIDL_LITE_OBJECT (item);
-        node = gupnp_didl_lite_object_get_xml_node (object);
-
-        lifetime_str = av_xml_util_get_child_element_content (node,
-                                                              "lifetime");
+        lifetime_str = gupnp_didl_lite_object_get_property_content
+                                        (object,
+                                         GUPNP_DIDL_LITE_PROPERTY_LIFETIME);
         lifetime = seconds_from_time (lifetime_str);
 
         return lifetime;
@@ -0,0 +1,24 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_OBJECT_HANDLE_PRIVATE_H
+#define GUPNP_DIDL_LITE_OBJECT_HANDLE_PRIVATE_H
+
+#include "xml-util.h"
+#include "gupnp-didl-lite-object-handle.h"
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL GUPnPDIDLLiteObjectHandle *
+gupnp_didl_lite_object_handle_new       (xmlNode       *xml_node,
+                                         GUPnPAVXMLDoc *xml_doc,
+                                         xmlNs         *upnp_ns,
+                                         xmlNs         *dc_ns,
+                                         xmlNs         *dlna_ns,
+                                         xmlNs         *pv_ns);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_OBJECT_HANDLE_PRIVATE_H__ */
@@ -0,0 +1,212 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPDIDLLiteObjectHandle:
+ *
+ * A cheap reference to a parsed DIDL-Lite object
+ *
+ * Handles are handed out by gupnp_didl_lite_parser_parse_didl_lazy() in
+ * place of #GUPnPDIDLLiteObject instances. They only point into the parsed
+ * document, so the identity of an object can be checked without creating a
+ * GObject for it. gupnp_didl_lite_object_handle_get_object() turns a handle
+ * into a full #GUPnPDIDLLiteItem or #GUPnPDIDLLiteContainer when needed.
+ *
+ * A handle keeps the document it belongs to alive.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include "gupnp-didl-lite-object-handle.h"
+#include "gupnp-didl-lite-object-handle-private.h"
+#include "gupnp-didl-lite-object-private.h"
+
+struct _GUPnPDIDLLiteObjectHandle {
+        xmlNode             *xml_node;
+        GUPnPAVXMLDoc       *xml_doc;
+
+        xmlNs               *upnp_ns;
+        xmlNs               *dc_ns;
+        xmlNs               *dlna_ns;
+        xmlNs               *pv_ns;
+
+        /* Created on first request */
+        GUPnPDIDLLiteObject *object;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteObjectHandle,
+                     gupnp_didl_lite_object_handle,
+                     gupnp_didl_lite_object_handle_ref,
+                     gupnp_didl_lite_object_handle_unref)
+
+GUPnPDIDLLiteObjectHandle *
+gupnp_didl_lite_object_handle_new (xmlNode       *xml_node,
+                                   GUPnPAVXMLDoc *xml_doc,
+                                   xmlNs         *upnp_ns,
+                                   xmlNs         *dc_ns,
+                                   xmlNs         *dlna_ns,
+                                   xmlNs         *pv_ns)
+{
+        GUPnPDIDLLiteObjectHandle *handle;
+
+        handle = g_atomic_rc_box_new0 (GUPnPDIDLLiteObjectHandle);
+        handle->xml_node = xml_node;
+        handle->xml_doc = av_xml_doc_ref (xml_doc);
+        handle->upnp_ns = upnp_ns;
+        handle->dc_ns = dc_ns;
+        handle->dlna_ns = dlna_ns;
+        handle->pv_ns = pv_ns;
+
+        return handle;
+}
+
+/**
+ * gupnp_didl_lite_object_handle_ref:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteObjectHandle].
+ *
+ * Returns: (transfer full): The object passed in @handle.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteObjectHandle *
+gupnp_didl_lite_object_handle_ref (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_val_if_fail (handle != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (handle);
+}
+
+static void
+object_handle_free (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_clear_object (&handle->object);
+        av_xml_doc_unref (handle->xml_doc);
+}
+
+/**
+ * gupnp_didl_lite_object_handle_unref:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteObjectHandle]. If
+ * the reference count drops to 0, @handle is freed.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_object_handle_unref (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_if_fail (handle != NULL);
+
+        g_atomic_rc_box_release_full (handle,
+                                      (GDestroyNotify) object_handle_free);
+}
+
+/**
+ * gupnp_didl_lite_object_handle_is_container:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Check whether @handle refers to a container rather than an item.
+ *
+ * Returns: %TRUE for a container.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_object_handle_is_container (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_val_if_fail (handle != NULL, FALSE);
+
+        return g_ascii_strcasecmp ((const char *) handle->xml_node->name,
+                                   "container") == 0;
+}
+
+/**
+ * gupnp_didl_lite_object_handle_get_id:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Get the ID of the object @handle refers to.
+ *
+ * Returns: The ID of the object, or %NULL.
+ *
+ * Since: 0.16
+ **/
+const char *
+gupnp_didl_lite_object_handle_get_id (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_val_if_fail (handle != NULL, NULL);
+
+        return av_xml_util_get_attribute_content (handle->xml_node, "id");
+}
+
+/**
+ * gupnp_didl_lite_object_handle_get_parent_id:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Get the ID of the parent of the object @handle refers to.
+ *
+ * Returns: The ID of the parent, or %NULL.
+ *
+ * Since: 0.16
+ **/
+const char *
+gupnp_didl_lite_object_handle_get_parent_id (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_val_if_fail (handle != NULL, NULL);
+
+        return av_xml_util_get_attribute_content (handle->xml_node,
+                                                  "parentID");
+}
+
+/**
+ * gupnp_didl_lite_object_handle_get_upnp_class:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Get the UPnP class of the object @handle refers to.
+ *
+ * Returns: The class of the object, or %NULL.
+ *
+ * Since: 0.16
+ **/
+const char *
+gupnp_didl_lite_object_handle_get_upnp_class
+                                        (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_val_if_fail (handle != NULL, NULL);
+
+        return av_xml_util_get_child_element_content (handle->xml_node,
+                                                      "class");
+}
+
+/**
+ * gupnp_didl_lite_object_handle_get_object:
+ * @handle: A [struct@GUPnPAV.DIDLLiteObjectHandle]
+ *
+ * Get the #GUPnPDIDLLiteItem or #GUPnPDIDLLiteContainer @handle refers to.
+ * It is created on the first call, later calls return the same object.
+ *
+ * Returns: (transfer full): The object. Unref after usage.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteObject *
+gupnp_didl_lite_object_handle_get_object (GUPnPDIDLLiteObjectHandle *handle)
+{
+        g_return_val_if_fail (handle != NULL, NULL);
+
+        if (handle->object == NULL)
+                handle->object =
+                        gupnp_didl_lite_object_new_from_xml (handle->xml_node,
+                                                             handle->xml_doc,
+                                                             handle->upnp_ns,
+                                                             handle->dc_ns,
+                                                             handle->dlna_ns,
+                                                             handle->pv_ns);
+
+        return g_object_ref (handle->object);
+}
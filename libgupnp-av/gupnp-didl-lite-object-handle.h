@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_OBJECT_HANDLE_H
+#define GUPNP_DIDL_LITE_OBJECT_HANDLE_H
+
+#include "gupnp-didl-lite-object.h"
+
+G_BEGIN_DECLS
+
+GType
+gupnp_didl_lite_object_handle_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_OBJECT_HANDLE \
+                (gupnp_didl_lite_object_handle_get_type ())
+
+typedef struct _GUPnPDIDLLiteObjectHandle GUPnPDIDLLiteObjectHandle;
+
+GUPnPDIDLLiteObjectHandle *
+gupnp_didl_lite_object_handle_ref       (GUPnPDIDLLiteObjectHandle *handle);
+
+void
+gupnp_didl_lite_object_handle_unref     (GUPnPDIDLLiteObjectHandle *handle);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteObjectHandle,
+                               gupnp_didl_lite_object_handle_unref)
+
+gboolean
+gupnp_didl_lite_object_handle_is_container
+                                        (GUPnPDIDLLiteObjectHandle *handle);
+
+const char *
+gupnp_didl_lite_object_handle_get_id    (GUPnPDIDLLiteObjectHandle *handle);
+
+const char *
+gupnp_didl_lite_object_handle_get_parent_id
+                                        (GUPnPDIDLLiteObjectHandle *handle);
+
+const char *
+gupnp_didl_lite_object_handle_get_upnp_class
+                                        (GUPnPDIDLLiteObjectHandle *handle);
+
+GUPnPDIDLLiteObject *
+gupnp_didl_lite_object_handle_get_object
+                                        (GUPnPDIDLLiteObjectHandle *handle);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_OBJECT_HANDLE_H__ */
@@ -14,6 +14,7 @@
 #define GUPNP_DIDL_LITE_OBJECT_PRIVATE_H
 
 #include "xml-util.h"
+#include "gupnp-didl-lite-filter.h"
 #include "gupnp-didl-lite-object.h"
 
 #include <glib-object.h>
@@ -21,6 +22,29 @@
 
 G_BEGIN_DECLS
 
+/* Properties found through the per-object index */
+typedef enum {
+        GUPNP_DIDL_LITE_PROPERTY_CLASS,
+        GUPNP_DIDL_LITE_PROPERTY_TITLE,
+        GUPNP_DIDL_LITE_PROPERTY_CREATOR,
+        GUPNP_DIDL_LITE_PROPERTY_ARTIST,
+        GUPNP_DIDL_LITE_PROPERTY_AUTHOR,
+        GUPNP_DIDL_LITE_PROPERTY_GENRE,
+        GUPNP_DIDL_LITE_PROPERTY_WRITE_STATUS,
+        GUPNP_DIDL_LITE_PROPERTY_ALBUM,
+        GUPNP_DIDL_LITE_PROPERTY_ALBUM_ART,
+        GUPNP_DIDL_LITE_PROPERTY_DESCRIPTION,
+        GUPNP_DIDL_LITE_PROPERTY_DATE,
+        GUPNP_DIDL_LITE_PROPERTY_TRACK_NUMBER,
+        GUPNP_DIDL_LITE_PROPERTY_UPDATE_ID,
+        GUPNP_DIDL_LITE_PROPERTY_LIFETIME,
+        GUPNP_DIDL_LITE_PROPERTY_CONTAINER_UPDATE_ID,
+        GUPNP_DIDL_LITE_PROPERTY_TOTAL_DELETED_CHILD_COUNT,
+        GUPNP_DIDL_LITE_PROPERTY_STORAGE_USED,
+        GUPNP_DIDL_LITE_PROPERTY_RES,
+        GUPNP_DIDL_LITE_PROPERTY_COUNT
+} GUPnPDIDLLiteProperty;
+
 G_GNUC_INTERNAL GUPnPDIDLLiteObject *
 gupnp_didl_lite_object_new_from_xml     (xmlNode     *xml_node,
                                          GUPnPAVXMLDoc *xml_doc,
@@ -33,6 +57,30 @@ G_GNUC_INTERNAL GUPnPAVXMLDoc *
 gupnp_didl_lite_object_get_gupnp_xml_doc
                                         (GUPnPDIDLLiteObject *object);
 
+G_GNUC_INTERNAL xmlNode *
+gupnp_didl_lite_object_peek_xml_node    (GUPnPDIDLLiteObject *object);
+
+G_GNUC_INTERNAL const char *
+gupnp_didl_lite_object_get_property_content
+                                        (GUPnPDIDLLiteObject  *object,
+                                         GUPnPDIDLLiteProperty property);
+
+G_GNUC_INTERNAL void
+gupnp_didl_lite_object_set_filter       (GUPnPDIDLLiteObject *object,
+                                         GUPnPDIDLLiteFilter *filter);
+
+G_GNUC_INTERNAL gboolean
+gupnp_didl_lite_object_wants_property   (GUPnPDIDLLiteObject *object,
+                                         const char          *prefix,
+                                         const char          *name);
+
+G_GNUC_INTERNAL gboolean
+gupnp_didl_lite_object_wants_attribute  (GUPnPDIDLLiteObject *object,
+                                         const char          *prefix,
+                                         const char          *name,
+                                         const char          *parent_prefix,
+                                         const char          *parent_name);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DIDL_LITE_OBJECT_PRIVATE_H__ */
@@ -29,7 +29,10 @@
 #include "gupnp-didl-lite-container.h"
 #include "gupnp-didl-lite-item.h"
 #include "gupnp-didl-lite-contributor-private.h"
+#include "gupnp-didl-lite-filter-private.h"
+#include "filter-util.h"
 #include "xml-util.h"
+#include "time-utils.h"
 #include "fragment-util.h"
 #include "xsd-data.h"
 
@@ -41,13 +44,188 @@ struct _GUPnPDIDLLiteObjectPrivate {
         xmlNs *dc_ns;
         xmlNs *dlna_ns;
         xmlNs *pv_ns;
+
+        /* First element of each indexed property, valid as long as
+         * index_generation matches the generation of xml_doc */
+        xmlNode  *property_index[GUPNP_DIDL_LITE_PROPERTY_COUNT];
+        guint     index_generation;
+        gboolean  index_valid;
+
+        /* Wrappers for the res elements, handed out by the resource
+         * getters and rebuilt under the same rules as the index */
+        GPtrArray *resources;
+        guint      resources_generation;
+
+        /* The parsed date element and a copy of the content it was parsed
+         * from. The content is compared rather than its address, as other
+         * wrappers of the node may change it in place. */
+        char           *date_content;
+        gboolean        date_parsed;
+        DateTimeFields  date_fields;
+
+        /* The filter of the writer that created the object; setters skip
+         * the properties it would remove anyway */
+        GUPnPDIDLLiteFilter *filter;
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GUPnPDIDLLiteObject,
                                      gupnp_didl_lite_object,
                                      G_TYPE_OBJECT)
 
-static XSDData *didl_lite_xsd;
+static GOnce didl_lite_xsd_once = G_ONCE_INIT;
+
+/* Names of the properties in the index, by GUPnPDIDLLiteProperty */
+static const char *indexed_properties[GUPNP_DIDL_LITE_PROPERTY_COUNT] = {
+        "class",
+        "title",
+        "creator",
+        "artist",
+        "author",
+        "genre",
+        "writeStatus",
+        "album",
+        "albumArtURI",
+        "description",
+        "date",
+        "originalTrackNumber",
+        "objectUpdateID",
+        "lifetime",
+        "containerUpdateID",
+        "totalDeletedChildCount",
+        "storageUsed",
+        "res"
+};
+
+/* Rebuilds the property index in a single pass over the children, unless
+ * the document has not changed since it was last built */
+static void
+update_property_index (GUPnPDIDLLiteObjectPrivate *priv)
+{
+        xmlNode *node;
+
+        if (priv->index_valid &&
+            priv->index_generation == priv->xml_doc->generation)
+                return;
+
+        memset (priv->property_index, 0, sizeof (priv->property_index));
+
+        for (node = priv->xml_node->children; node; node = node->next) {
+                guint i;
+
+                if (node->name == NULL)
+                        continue;
+
+                for (i = 0; i < GUPNP_DIDL_LITE_PROPERTY_COUNT; i++) {
+                        if (g_ascii_strcasecmp (indexed_properties[i],
+                                                (char *) node->name) != 0)
+                                continue;
+
+                        /* Like av_xml_util_get_element(), the first one
+                         * wins */
+                        if (priv->property_index[i] == NULL)
+                                priv->property_index[i] = node;
+
+                        break;
+                }
+        }
+
+        priv->index_generation = priv->xml_doc->generation;
+        priv->index_valid = TRUE;
+}
+
+static xmlNode *
+get_property_node (GUPnPDIDLLiteObjectPrivate *priv,
+                   GUPnPDIDLLiteProperty       property)
+{
+        /* Nothing to tell whether the index is stale */
+        if (priv->xml_doc == NULL)
+                return av_xml_util_get_element (priv->xml_node,
+                                                indexed_properties[property],
+                                                NULL);
+
+        update_property_index (priv);
+
+        /* Callers may change the tree through the node without the document
+         * knowing. Unlinked nodes at least are caught here. */
+        if (priv->property_index[property] != NULL &&
+            priv->property_index[property]->parent != priv->xml_node) {
+                priv->index_valid = FALSE;
+                update_property_index (priv);
+        }
+
+        return priv->property_index[property];
+}
+
+/* Same as av_xml_util_get_child_element_content(), through the index */
+static const char *
+get_property_content (GUPnPDIDLLiteObjectPrivate *priv,
+                      GUPnPDIDLLiteProperty       property)
+{
+        xmlNode *node;
+
+        node = get_property_node (priv, property);
+        if (node == NULL || node->children == NULL)
+                return NULL;
+
+        return (const char *) node->children->content;
+}
+
+/* Returns the date of the object, parsing it only if it has changed since
+ * the last call, or NULL if the object has no valid date */
+static const DateTimeFields *
+get_date_fields (GUPnPDIDLLiteObjectPrivate *priv)
+{
+        const char *content;
+
+        content = get_property_content (priv, GUPNP_DIDL_LITE_PROPERTY_DATE);
+        if (content == NULL)
+                return NULL;
+
+        if (g_strcmp0 (content, priv->date_content) != 0) {
+                g_free (priv->date_content);
+                priv->date_content = g_strdup (content);
+                priv->date_parsed = date_time_parse (content,
+                                                     &priv->date_fields);
+        }
+
+        return priv->date_parsed ? &priv->date_fields : NULL;
+}
+
+/* Returns the wrappers for all res elements of the object, creating them
+ * again only if the document has changed since the last call */
+static GPtrArray *
+get_resource_cache (GUPnPDIDLLiteObjectPrivate *priv)
+{
+        xmlNode *node;
+
+        if (priv->resources != NULL &&
+            priv->xml_doc != NULL &&
+            priv->resources_generation == priv->xml_doc->generation)
+                return priv->resources;
+
+        /* Callers may still hold the old array */
+        g_clear_pointer (&priv->resources, g_ptr_array_unref);
+        priv->resources = g_ptr_array_new_with_free_func (g_object_unref);
+
+        for (node = priv->xml_node->children; node; node = node->next) {
+                GUPnPDIDLLiteResource *resource;
+
+                if (node->name == NULL ||
+                    strcmp ((char *) node->name, "res") != 0)
+                        continue;
+
+                resource = gupnp_didl_lite_resource_new_from_xml (node,
+                                                                  priv->xml_doc,
+                                                                  priv->dlna_ns,
+                                                                  priv->pv_ns);
+                g_ptr_array_add (priv->resources, resource);
+        }
+
+        if (priv->xml_doc != NULL)
+                priv->resources_generation = priv->xml_doc->generation;
+
+        return priv->resources;
+}
 
 enum {
         PROP_0,
@@ -356,7 +534,10 @@ gupnp_didl_lite_object_dispose (GObject *object)
 
         priv = gupnp_didl_lite_object_get_instance_private (self);
 
+        g_clear_pointer (&priv->resources, g_ptr_array_unref);
         g_clear_pointer (&priv->xml_doc, av_xml_doc_unref);
+        g_clear_pointer (&priv->filter, gupnp_didl_lite_filter_unref);
+        g_clear_pointer (&priv->date_content, g_free);
 
         object_class = G_OBJECT_CLASS (gupnp_didl_lite_object_parent_class);
         object_class->dispose (object);
@@ -797,37 +978,21 @@ gupnp_didl_lite_object_class_init (GUPnPDIDLLiteObjectClass *klass)
                                                     G_PARAM_STATIC_NAME |
                                                     G_PARAM_STATIC_NICK |
                                                     G_PARAM_STATIC_BLURB));
-
-        if (didl_lite_xsd == NULL)
-                didl_lite_xsd = fragment_util_get_didl_lite_xsd_data ();
 }
 
-static gboolean
-is_resource_compatible (GUPnPDIDLLiteResource *resource,
-                        char                 **protocols)
+static gpointer
+load_didl_lite_xsd (G_GNUC_UNUSED gpointer data)
 {
-        gboolean ret = FALSE;
-        char **it;
-
-        for (it = protocols; *it != NULL && !ret; it++) {
-                GUPnPProtocolInfo *info;
-                GUPnPProtocolInfo *res_info;
-
-                info = gupnp_protocol_info_new_from_string (*it, NULL);
-                if (info == NULL)
-                        continue;
-
-                res_info = gupnp_didl_lite_resource_get_protocol_info
-                                                        (resource);
-                if (res_info == NULL)
-                        continue;
-
-                ret = gupnp_protocol_info_is_compatible (info, res_info);
-
-                g_object_unref (info);
-        }
+        return fragment_util_get_didl_lite_xsd_data ();
+}
 
-        return ret;
+/* The schema is only needed to apply fragments, so it is loaded on first use
+ * rather than when the first object is created. g_once() makes this safe
+ * when objects are used from several threads. */
+static XSDData *
+get_didl_lite_xsd (void)
+{
+        return g_once (&didl_lite_xsd_once, load_didl_lite_xsd, NULL);
 }
 
 static GList *
@@ -866,10 +1031,9 @@ static char *
 get_contributors_xml_string_by_name (GUPnPDIDLLiteObject *object,
                                      const char          *name)
 {
-        GList     *contributors = NULL;
-        char      *ret = NULL;
-        GList     *l;
-        xmlBuffer *buffer;
+        GList   *contributors = NULL;
+        GList   *l;
+        GString *string;
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
@@ -877,7 +1041,7 @@ get_contributors_xml_string_by_name (GUPnPDIDLLiteObject *object,
         if (contributors == NULL)
                 return NULL;
 
-        buffer = xmlBufferCreate ();
+        string = g_string_new (NULL);
 
         for (l = contributors; l; l = l->next) {
                 xmlNode *node;
@@ -886,20 +1050,14 @@ get_contributors_xml_string_by_name (GUPnPDIDLLiteObject *object,
                 if (!node->children)
                         continue;
 
-                xmlNodeDump (buffer,
-                             priv->xml_doc->doc,
-                             node,
-                             0,
-                             0);
+                av_xml_util_dump_node_to_string (string,
+                                                 priv->xml_doc->doc,
+                                                 node);
         }
 
-        ret = g_strndup ((char *) xmlBufferContent (buffer),
-                         xmlBufferLength (buffer));
-        xmlBufferFree (buffer);
-
         g_list_free (contributors);
 
-        return ret;
+        return g_string_free (string, FALSE);
 }
 
 static void
@@ -907,6 +1065,9 @@ unset_contributors_by_name (GUPnPDIDLLiteObject *object, const char *name)
 {
         GList *contributors = NULL;
         GList *l;
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
 
         contributors = gupnp_didl_lite_object_get_properties (object, name);
         if (contributors == NULL)
@@ -923,6 +1084,7 @@ unset_contributors_by_name (GUPnPDIDLLiteObject *object, const char *name)
                 xmlFreeNode (node);
         }
 
+        av_xml_doc_touch (priv->xml_node->doc);
         g_list_free (contributors);
 
         return;
@@ -974,6 +1136,103 @@ gupnp_didl_lite_object_new_from_xml (xmlNode       *xml_node,
                 return NULL;
 }
 
+/* Content of the first @property child of @object, found through the
+ * object's property index */
+const char *
+gupnp_didl_lite_object_get_property_content (GUPnPDIDLLiteObject  *object,
+                                             GUPnPDIDLLiteProperty property)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        return get_property_content (priv, property);
+}
+
+/* Make the setters of @object skip properties @filter excludes, %NULL to
+ * write all of them */
+void
+gupnp_didl_lite_object_set_filter (GUPnPDIDLLiteObject *object,
+                                   GUPnPDIDLLiteFilter *filter)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        if (filter != NULL && gupnp_didl_lite_filter_is_wildcard (filter))
+                filter = NULL;
+        if (filter != NULL)
+                gupnp_didl_lite_filter_ref (filter);
+
+        g_clear_pointer (&priv->filter, gupnp_didl_lite_filter_unref);
+        priv->filter = filter;
+}
+
+/* Whether a setter should write the child element @prefix:@name, i.e.
+ * whether filtering the writer would keep it. Mirrors filter_node() in
+ * gupnp-didl-lite-writer.c. */
+gboolean
+gupnp_didl_lite_object_wants_property (GUPnPDIDLLiteObject *object,
+                                       const char          *prefix,
+                                       const char          *name)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+        const char *node_name;
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        if (priv->filter == NULL)
+                return TRUE;
+
+        node_name = (const char *) priv->xml_node->name;
+        if (filter_util_is_standard_prop (name, prefix, node_name))
+                return TRUE;
+
+        /* The class decides here, so it has to be set before */
+        if (strcmp (node_name, "container") == 0 &&
+            filter_util_is_container_standard_prop
+                                (name,
+                                 prefix,
+                                 get_property_content
+                                        (priv,
+                                         GUPNP_DIDL_LITE_PROPERTY_CLASS)))
+                return TRUE;
+
+        return gupnp_didl_lite_filter_is_node_allowed (priv->filter,
+                                                       prefix,
+                                                       name);
+}
+
+/* Whether a setter should write the attribute @prefix:@name of the element
+ * @parent_prefix:@parent_name, %NULL for the object element itself.
+ * Mirrors filter_attributes() in gupnp-didl-lite-writer.c. */
+gboolean
+gupnp_didl_lite_object_wants_attribute (GUPnPDIDLLiteObject *object,
+                                        const char          *prefix,
+                                        const char          *name,
+                                        const char          *parent_prefix,
+                                        const char          *parent_name)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        if (priv->filter == NULL)
+                return TRUE;
+
+        if (parent_name == NULL)
+                parent_name = (const char *) priv->xml_node->name;
+
+        if (filter_util_is_standard_prop (name, NULL, parent_name))
+                return TRUE;
+
+        return gupnp_didl_lite_filter_is_attribute_allowed (priv->filter,
+                                                            prefix,
+                                                            name,
+                                                            parent_prefix,
+                                                            parent_name);
+}
+
 /**
  * gupnp_didl_lite_object_get_gupnp_xml_doc:
  * @object: The #GUPnPDIDLLiteObject
@@ -999,6 +1258,12 @@ gupnp_didl_lite_object_get_gupnp_xml_doc (GUPnPDIDLLiteObject *object)
  *
  * Get the pointer to object node in XML document.
  *
+ * The objects of the document remember where their properties are, and
+ * forget it whenever this is called. Changes to the tree made through the
+ * returned node are therefore seen by the getters as long as they are made
+ * before the next getter call. Call this again before changing the tree
+ * after that.
+ *
  * Returns: (transfer none): The pointer to object node in XML document.
  **/
 xmlNode *
@@ -1008,6 +1273,22 @@ gupnp_didl_lite_object_get_xml_node (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        av_xml_doc_touch (priv->xml_node->doc);
+
+        return priv->xml_node;
+}
+
+/* Same as gupnp_didl_lite_object_get_xml_node(), for the library's own use,
+ * which changes the tree only through calls that touch the document */
+xmlNode *
+gupnp_didl_lite_object_peek_xml_node (GUPnPDIDLLiteObject *object)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
         return priv->xml_node;
 }
 
@@ -1067,8 +1348,8 @@ gupnp_didl_lite_object_get_upnp_class (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node,
-                                                      "class");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_CLASS);
 }
 
 /**
@@ -1226,7 +1507,8 @@ gupnp_didl_lite_object_get_title (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node, "title");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_TITLE);
 }
 
 /**
@@ -1244,8 +1526,8 @@ gupnp_didl_lite_object_get_creator (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node,
-                                                      "creator");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_CREATOR);
 }
 
 /**
@@ -1284,7 +1566,8 @@ gupnp_didl_lite_object_get_artist (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node, "artist");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_ARTIST);
 }
 
 /**
@@ -1322,7 +1605,8 @@ gupnp_didl_lite_object_get_author (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node, "author");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_AUTHOR);
 }
 
 /**
@@ -1399,7 +1683,8 @@ gupnp_didl_lite_object_get_genre (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node, "genre");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_GENRE);
 }
 
 /**
@@ -1417,8 +1702,8 @@ gupnp_didl_lite_object_get_write_status (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node,
-                                                      "writeStatus");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_WRITE_STATUS);
 }
 
 /**
@@ -1436,7 +1721,8 @@ gupnp_didl_lite_object_get_album (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node, "album");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_ALBUM);
 }
 
 /**
@@ -1454,8 +1740,8 @@ gupnp_didl_lite_object_get_album_art (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node,
-                                                      "albumArtURI");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_ALBUM_ART);
 }
 
 /**
@@ -1473,8 +1759,8 @@ gupnp_didl_lite_object_get_description (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node,
-                                                      "description");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_DESCRIPTION);
 }
 
 /**
@@ -1492,7 +1778,93 @@ gupnp_didl_lite_object_get_date (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_child_element_content (priv->xml_node, "date");
+        return get_property_content (priv,
+                                     GUPNP_DIDL_LITE_PROPERTY_DATE);
+}
+
+/**
+ * gupnp_didl_lite_object_get_date_time:
+ * @object: #GUPnPDIDLLiteObject
+ *
+ * Get the date of the @object as a #GDateTime, in the UTC offset given by
+ * the date. Dates without a time are taken to be at midnight and dates
+ * without an offset to be in UTC.
+ *
+ * The date is parsed once and kept until it changes.
+ *
+ * Return value: (transfer full) (nullable): The date of the @object, or
+ * %NULL if it has none or it is not a valid ISO 8601 date.
+ *
+ * Since: 0.16
+ **/
+GDateTime *
+gupnp_didl_lite_object_get_date_time (GUPnPDIDLLiteObject *object)
+{
+        const DateTimeFields *fields;
+        GDateTime *date_time;
+        GDateTime *ret;
+        GTimeZone *time_zone;
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        fields = get_date_fields (priv);
+        if (fields == NULL)
+                return NULL;
+
+        time_zone = g_time_zone_new_offset (fields->utc_offset);
+        date_time = g_date_time_new (time_zone,
+                                     fields->year,
+                                     fields->month,
+                                     fields->day,
+                                     fields->hour,
+                                     fields->minute,
+                                     fields->second);
+        g_time_zone_unref (time_zone);
+
+        /* GDateTime does not go back to year 0 */
+        if (date_time == NULL)
+                return NULL;
+
+        ret = g_date_time_add (date_time, fields->microsecond);
+        g_date_time_unref (date_time);
+
+        return ret;
+}
+
+/**
+ * gupnp_didl_lite_object_get_date_sort_key:
+ * @object: #GUPnPDIDLLiteObject
+ *
+ * Get the date of the @object as microseconds since the Unix epoch, e.g. to
+ * sort objects by date without parsing their dates over and over. Dates
+ * without a time are taken to be at midnight and dates without an offset to
+ * be in UTC.
+ *
+ * The date is parsed once and kept until it changes.
+ *
+ * Return value: The date of the @object, or %G_MININT64 if it has none or
+ * it is not a valid ISO 8601 date, so those objects sort first.
+ *
+ * Since: 0.16
+ **/
+gint64
+gupnp_didl_lite_object_get_date_sort_key (GUPnPDIDLLiteObject *object)
+{
+        const DateTimeFields *fields;
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), G_MININT64);
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        fields = get_date_fields (priv);
+        if (fields == NULL)
+                return G_MININT64;
+
+        return date_time_to_unix_usec (fields);
 }
 
 /**
@@ -1512,8 +1884,8 @@ gupnp_didl_lite_object_get_track_number (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        str = av_xml_util_get_child_element_content (priv->xml_node,
-                                                     "originalTrackNumber");
+        str = get_property_content (priv,
+                                    GUPNP_DIDL_LITE_PROPERTY_TRACK_NUMBER);
         if (str == NULL)
                 return -1;
 
@@ -1561,14 +1933,19 @@ gupnp_didl_lite_object_get_dlna_managed (GUPnPDIDLLiteObject *object)
 guint
 gupnp_didl_lite_object_get_update_id (GUPnPDIDLLiteObject *object)
 {
+        const char *content;
+
         g_return_val_if_fail (object != NULL, 0);
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), 0);
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return av_xml_util_get_uint_child_element (priv->xml_node,
-                                                   "objectUpdateID",
-                                                   0);
+        content = get_property_content (priv,
+                                        GUPNP_DIDL_LITE_PROPERTY_UPDATE_ID);
+        if (content == NULL)
+                return 0;
+
+        return strtoul (content, NULL, 0);
 }
 
 /**
@@ -1589,11 +1966,197 @@ gupnp_didl_lite_object_update_id_is_set (GUPnPDIDLLiteObject *object)
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        content = av_xml_util_get_child_element_content (priv->xml_node,
-                                                         "objectUpdateID");
+        content = get_property_content (priv,
+                                        GUPNP_DIDL_LITE_PROPERTY_UPDATE_ID);
         return content != NULL;
 }
 
+GType
+gupnp_didl_lite_field_get_type (void)
+{
+        static GType type = 0;
+
+        if (type == 0) {
+                static const GFlagsValue values[] = {
+                        { GUPNP_DIDL_LITE_FIELD_NONE,
+                          "GUPNP_DIDL_LITE_FIELD_NONE",
+                          "none" },
+                        { GUPNP_DIDL_LITE_FIELD_ID,
+                          "GUPNP_DIDL_LITE_FIELD_ID",
+                          "id" },
+                        { GUPNP_DIDL_LITE_FIELD_PARENT_ID,
+                          "GUPNP_DIDL_LITE_FIELD_PARENT_ID",
+                          "parent-id" },
+                        { GUPNP_DIDL_LITE_FIELD_UPNP_CLASS,
+                          "GUPNP_DIDL_LITE_FIELD_UPNP_CLASS",
+                          "upnp-class" },
+                        { GUPNP_DIDL_LITE_FIELD_TITLE,
+                          "GUPNP_DIDL_LITE_FIELD_TITLE",
+                          "title" },
+                        { GUPNP_DIDL_LITE_FIELD_CREATOR,
+                          "GUPNP_DIDL_LITE_FIELD_CREATOR",
+                          "creator" },
+                        { GUPNP_DIDL_LITE_FIELD_ARTIST,
+                          "GUPNP_DIDL_LITE_FIELD_ARTIST",
+                          "artist" },
+                        { GUPNP_DIDL_LITE_FIELD_ALBUM,
+                          "GUPNP_DIDL_LITE_FIELD_ALBUM",
+                          "album" },
+                        { GUPNP_DIDL_LITE_FIELD_ALBUM_ART,
+                          "GUPNP_DIDL_LITE_FIELD_ALBUM_ART",
+                          "album-art" },
+                        { GUPNP_DIDL_LITE_FIELD_GENRE,
+                          "GUPNP_DIDL_LITE_FIELD_GENRE",
+                          "genre" },
+                        { GUPNP_DIDL_LITE_FIELD_DATE,
+                          "GUPNP_DIDL_LITE_FIELD_DATE",
+                          "date" },
+                        { GUPNP_DIDL_LITE_FIELD_DESCRIPTION,
+                          "GUPNP_DIDL_LITE_FIELD_DESCRIPTION",
+                          "description" },
+                        { GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER,
+                          "GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER",
+                          "track-number" },
+                        { GUPNP_DIDL_LITE_FIELD_DURATION,
+                          "GUPNP_DIDL_LITE_FIELD_DURATION",
+                          "duration" },
+                        { 0, NULL, NULL }
+                };
+
+                type = g_flags_register_static
+                                (g_intern_static_string ("GUPnPDIDLLiteField"),
+                                 values);
+        }
+
+        return type;
+}
+
+/* The string fields of GUPnPDIDLLiteFields that come from an indexed
+ * property, and where to store them */
+static const struct {
+        GUPnPDIDLLiteField    field;
+        GUPnPDIDLLiteProperty property;
+        gsize                 offset;
+} string_fields[] = {
+        { GUPNP_DIDL_LITE_FIELD_UPNP_CLASS,
+          GUPNP_DIDL_LITE_PROPERTY_CLASS,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, upnp_class) },
+        { GUPNP_DIDL_LITE_FIELD_TITLE,
+          GUPNP_DIDL_LITE_PROPERTY_TITLE,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, title) },
+        { GUPNP_DIDL_LITE_FIELD_CREATOR,
+          GUPNP_DIDL_LITE_PROPERTY_CREATOR,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, creator) },
+        { GUPNP_DIDL_LITE_FIELD_ARTIST,
+          GUPNP_DIDL_LITE_PROPERTY_ARTIST,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, artist) },
+        { GUPNP_DIDL_LITE_FIELD_ALBUM,
+          GUPNP_DIDL_LITE_PROPERTY_ALBUM,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, album) },
+        { GUPNP_DIDL_LITE_FIELD_ALBUM_ART,
+          GUPNP_DIDL_LITE_PROPERTY_ALBUM_ART,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, album_art) },
+        { GUPNP_DIDL_LITE_FIELD_GENRE,
+          GUPNP_DIDL_LITE_PROPERTY_GENRE,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, genre) },
+        { GUPNP_DIDL_LITE_FIELD_DATE,
+          GUPNP_DIDL_LITE_PROPERTY_DATE,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, date) },
+        { GUPNP_DIDL_LITE_FIELD_DESCRIPTION,
+          GUPNP_DIDL_LITE_PROPERTY_DESCRIPTION,
+          G_STRUCT_OFFSET (GUPnPDIDLLiteFields, description) }
+};
+
+/**
+ * gupnp_didl_lite_object_get_fields:
+ * @object: #GUPnPDIDLLiteObject
+ * @requested: The fields to fetch
+ * @fields: (out caller-allocates): Return location for the fields
+ *
+ * Fetch several fields of @object at once. The result is the same as calling
+ * the individual getters, e.g. gupnp_didl_lite_object_get_title(), but
+ * @object is only walked once and none of the results need to be freed.
+ *
+ * Return value: The subset of @requested that was found in @object.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteField
+gupnp_didl_lite_object_get_fields (GUPnPDIDLLiteObject *object,
+                                   GUPnPDIDLLiteField   requested,
+                                   GUPnPDIDLLiteFields *fields)
+{
+        GUPnPDIDLLiteField found = GUPNP_DIDL_LITE_FIELD_NONE;
+        const char *content;
+        guint i;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object),
+                              GUPNP_DIDL_LITE_FIELD_NONE);
+        g_return_val_if_fail (fields != NULL, GUPNP_DIDL_LITE_FIELD_NONE);
+        GUPnPDIDLLiteObjectPrivate *priv;
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        memset (fields, 0, sizeof (GUPnPDIDLLiteFields));
+        fields->track_number = -1;
+        fields->duration = -1;
+
+        if (requested & GUPNP_DIDL_LITE_FIELD_ID) {
+                fields->id = av_xml_util_get_attribute_content (priv->xml_node,
+                                                                "id");
+                if (fields->id != NULL)
+                        found |= GUPNP_DIDL_LITE_FIELD_ID;
+        }
+
+        if (requested & GUPNP_DIDL_LITE_FIELD_PARENT_ID) {
+                fields->parent_id = av_xml_util_get_attribute_content
+                                                        (priv->xml_node,
+                                                         "parentID");
+                if (fields->parent_id != NULL)
+                        found |= GUPNP_DIDL_LITE_FIELD_PARENT_ID;
+        }
+
+        for (i = 0; i < G_N_ELEMENTS (string_fields); i++) {
+                if (!(requested & string_fields[i].field))
+                        continue;
+
+                content = get_property_content (priv,
+                                                string_fields[i].property);
+                if (content == NULL)
+                        continue;
+
+                G_STRUCT_MEMBER (const char *,
+                                 fields,
+                                 string_fields[i].offset) = content;
+                found |= string_fields[i].field;
+        }
+
+        if (requested & GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER) {
+                content = get_property_content
+                                        (priv,
+                                         GUPNP_DIDL_LITE_PROPERTY_TRACK_NUMBER);
+                if (content != NULL) {
+                        fields->track_number = atoi (content);
+                        found |= GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER;
+                }
+        }
+
+        if (requested & GUPNP_DIDL_LITE_FIELD_DURATION) {
+                xmlNode *res;
+
+                res = get_property_node (priv, GUPNP_DIDL_LITE_PROPERTY_RES);
+                content = res != NULL ?
+                          av_xml_util_get_attribute_content (res, "duration") :
+                          NULL;
+
+                /* Copes with NULL, like gupnp_didl_lite_resource_get_duration() */
+                fields->duration = seconds_from_time (content);
+                if (fields->duration >= 0)
+                        found |= GUPNP_DIDL_LITE_FIELD_DURATION;
+        }
+
+        return found;
+}
+
 /**
  * gupnp_didl_lite_object_get_resources:
  * @object: #GUPnPDIDLLiteObject
@@ -1607,34 +2170,51 @@ gupnp_didl_lite_object_update_id_is_set (GUPnPDIDLLiteObject *object)
 GList *
 gupnp_didl_lite_object_get_resources (GUPnPDIDLLiteObject *object)
 {
-        GList *resources = NULL;
-        GList *res = NULL;
+        GPtrArray *resources;
         GList *ret = NULL;
+        guint i;
 
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        resources = gupnp_didl_lite_object_get_properties (object, "res");
+        resources = get_resource_cache (priv);
 
-        for (res = resources; res; res = res->next) {
-                GUPnPDIDLLiteResource *resource;
-                xmlNode *res_node;
-
-                res_node = (xmlNode *) res->data;
-
-                /* Create a resource struct out of DIDLLite XML */
-                resource = gupnp_didl_lite_resource_new_from_xml (res_node,
-                                                                  priv->xml_doc,
-                                                                  priv->dlna_ns,
-                                                                  priv->pv_ns);
+        /* Walk backwards so prepending keeps the document order */
+        for (i = resources->len; i > 0; i--)
+                ret = g_list_prepend (ret,
+                                      g_object_ref (g_ptr_array_index (resources,
+                                                                       i - 1)));
 
-                ret = g_list_append (ret, resource);
-        }
+        return ret;
+}
 
-        g_list_free (resources);
+/**
+ * gupnp_didl_lite_object_get_resources_as_array:
+ * @object: #GUPnPDIDLLiteObject
+ *
+ * Get the resources of @object, in document order.
+ *
+ * Unlike gupnp_didl_lite_object_get_resources(), the resources are created
+ * once and reused by subsequent calls until the object is modified, e.g. by
+ * gupnp_didl_lite_object_add_resource() or
+ * gupnp_didl_lite_object_apply_fragments(). The returned array is shared and
+ * must not be modified.
+ *
+ * Return value: (element-type GUPnPDIDLLiteResource) (transfer full): The
+ *               resources belonging to @object. Unref with
+ *               g_ptr_array_unref() after usage.
+ *
+ * Since: 0.16
+ **/
+GPtrArray *
+gupnp_didl_lite_object_get_resources_as_array (GUPnPDIDLLiteObject *object)
+{
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+        GUPnPDIDLLiteObjectPrivate *priv;
+        priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return ret;
+        return g_ptr_array_ref (get_resource_cache (priv));
 }
 
 /**
@@ -1662,58 +2242,89 @@ gupnp_didl_lite_object_get_compat_resource
                                  const char          *sink_protocol_info,
                                  gboolean             lenient)
 {
-        GUPnPDIDLLiteResource *resource = NULL;
-        GList  *resources = NULL;
-        GList  *compat_resources = NULL;
-        GList  *res;
-        char **protocols = NULL;
+        GUPnPProtocolInfoMatcher *matcher;
+        GUPnPDIDLLiteResource *resource;
 
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
         g_return_val_if_fail (sink_protocol_info != NULL, NULL);
 
-        resources = gupnp_didl_lite_object_get_resources (object);
-        if (resources == NULL)
+        matcher = gupnp_protocol_info_matcher_new (sink_protocol_info);
+        resource = gupnp_didl_lite_object_get_compat_resource_with_matcher
+                                                                (object,
+                                                                 matcher,
+                                                                 lenient);
+        gupnp_protocol_info_matcher_unref (matcher);
+
+        return resource;
+}
+
+/**
+ * gupnp_didl_lite_object_get_compat_resource_with_matcher:
+ * @object: #GUPnPDIDLLiteObject
+ * @matcher: A [struct@GUPnPAV.ProtocolInfoMatcher] for the sink protocols
+ * @lenient: Enable lenient mode
+ *
+ * Same as gupnp_didl_lite_object_get_compat_resource(), but with the sink
+ * protocols already parsed into @matcher. Use this to pick resources of
+ * many objects for the same MediaRenderer.
+ *
+ * Returns: (transfer full)(nullable): The resource belonging to @object that
+ * is compatible with any of the protocols of @matcher, or %NULL. Unref after
+ * usage.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteResource *
+gupnp_didl_lite_object_get_compat_resource_with_matcher
+                                (GUPnPDIDLLiteObject      *object,
+                                 GUPnPProtocolInfoMatcher *matcher,
+                                 gboolean                  lenient)
+{
+        GUPnPDIDLLiteResource *resource = NULL;
+        GUPnPDIDLLiteResource *first_compat = NULL;
+        GPtrArray *resources;
+        guint i;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+        g_return_val_if_fail (matcher != NULL, NULL);
+        GUPnPDIDLLiteObjectPrivate *priv;
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        resources = get_resource_cache (priv);
+        if (resources->len == 0)
                 return NULL;
 
-        protocols = g_strsplit (sink_protocol_info, ",", -1);
-        for (res = resources;
-             res != NULL;
-             res = res->next) {
-                resource = (GUPnPDIDLLiteResource *) res->data;
+        for (i = 0; i < resources->len; i++) {
+                GUPnPDIDLLiteResource *candidate;
+                GUPnPProtocolInfo *info;
 
-                if (is_resource_compatible (resource, protocols))
-                        compat_resources = g_list_append (compat_resources,
-                                                          resource);
+                candidate = g_ptr_array_index (resources, i);
+                info = gupnp_didl_lite_resource_get_protocol_info (candidate);
+                if (info == NULL ||
+                    !gupnp_protocol_info_matcher_is_compatible (matcher, info))
+                        continue;
+
+                if (first_compat == NULL)
+                        first_compat = candidate;
+
+                /* Prefer the first non-transcoded resource */
+                if (is_non_transcoded_resource (candidate, NULL) == 0) {
+                        resource = candidate;
+
+                        break;
+                }
         }
-        g_strfreev (protocols);
-        protocols = NULL;
-
-        resource = NULL;
-
-        if (compat_resources != NULL) {
-                /* Try to find non-transcoded resource */
-                res = g_list_find_custom (compat_resources,
-                                          NULL,
-                                          (GCompareFunc)
-                                          is_non_transcoded_resource);
-
-                if (res != NULL)
-                        resource = (GUPnPDIDLLiteResource *) res->data;
-                else
-                        /* Just use the first compatible resource */
-                        resource = (GUPnPDIDLLiteResource *)
-                                   compat_resources->data;
-
-        } else if (lenient)
+
+        if (resource == NULL)
+                /* Just use the first compatible resource */
+                resource = first_compat;
+
+        if (resource == NULL && lenient)
                 /* Just use the first resource */
-                resource = (GUPnPDIDLLiteResource *) resources->data;
+                resource = g_ptr_array_index (resources, 0);
 
-        /* Unref all resources except for the one we just took */
-        for (res = resources; res; res = res->next)
-                if (res->data != resource)
-                        g_object_unref (res->data);
-        g_list_free (resources);
-        g_list_free (compat_resources);
+        if (resource != NULL)
+                g_object_ref (resource);
 
         return resource;
 }
@@ -1861,6 +2472,9 @@ gupnp_didl_lite_object_set_creator (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object, "dc", "creator"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_DC,
                                &(priv->dc_ns),
@@ -1891,9 +2505,12 @@ gupnp_didl_lite_object_add_creator (GUPnPDIDLLiteObject *object)
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
         res_node = xmlNewChild (priv->xml_node,
-                                priv->dc_ns,
+                                av_xml_util_get_ns (priv->xml_node->doc,
+                                                    GUPNP_XML_NAMESPACE_DC,
+                                                    &(priv->dc_ns)),
                                 (unsigned char *) "creator",
                                 NULL);
+        av_xml_doc_touch (priv->xml_node->doc);
 
         return gupnp_didl_lite_contributor_new_from_xml (res_node,
                                                          priv->xml_doc);
@@ -1918,6 +2535,9 @@ gupnp_didl_lite_object_set_artist (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object, "upnp", "artist"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_UPNP,
                                &(priv->upnp_ns),
@@ -1948,9 +2568,12 @@ gupnp_didl_lite_object_add_artist (GUPnPDIDLLiteObject *object)
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
         res_node = xmlNewChild (priv->xml_node,
-                                priv->upnp_ns,
+                                av_xml_util_get_ns (priv->xml_node->doc,
+                                                    GUPNP_XML_NAMESPACE_UPNP,
+                                                    &(priv->upnp_ns)),
                                 (unsigned char *) "artist",
                                 NULL);
+        av_xml_doc_touch (priv->xml_node->doc);
 
         return gupnp_didl_lite_contributor_new_from_xml (res_node,
                                                          priv->xml_doc);
@@ -1974,6 +2597,9 @@ gupnp_didl_lite_object_set_author (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object, "upnp", "author"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_DC,
                                &(priv->upnp_ns),
@@ -2004,9 +2630,12 @@ gupnp_didl_lite_object_add_author (GUPnPDIDLLiteObject *object)
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
         res_node = xmlNewChild (priv->xml_node,
-                                priv->upnp_ns,
+                                av_xml_util_get_ns (priv->xml_node->doc,
+                                                    GUPNP_XML_NAMESPACE_UPNP,
+                                                    &(priv->upnp_ns)),
                                 (unsigned char *) "author",
                                 NULL);
+        av_xml_doc_touch (priv->xml_node->doc);
 
         return gupnp_didl_lite_contributor_new_from_xml (res_node,
                                                          priv->xml_doc);
@@ -2028,6 +2657,9 @@ gupnp_didl_lite_object_set_genre (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object, "upnp", "genre"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_UPNP,
                                &(priv->upnp_ns),
@@ -2054,6 +2686,11 @@ gupnp_didl_lite_object_set_write_status (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object,
+                                                    "dc",
+                                                    "writeStatus"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_DC,
                                &(priv->dc_ns),
@@ -2080,6 +2717,9 @@ gupnp_didl_lite_object_set_album (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object, "upnp", "album"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_UPNP,
                                &(priv->upnp_ns),
@@ -2108,6 +2748,11 @@ gupnp_didl_lite_object_set_album_art (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object,
+                                                    "upnp",
+                                                    "albumArtURI"))
+                return;
+
         node = av_xml_util_set_child (priv->xml_node,
                                       GUPNP_XML_NAMESPACE_UPNP,
                                       &(priv->upnp_ns),
@@ -2119,10 +2764,15 @@ gupnp_didl_lite_object_set_album_art (GUPnPDIDLLiteObject *object,
                             GUPNP_XML_NAMESPACE_DLNA,
                             &(priv->dlna_ns));
 
-        xmlSetNsProp (node,
-                      priv->dlna_ns,
-                      (const unsigned char *) "profileID",
-                      (const unsigned char *) "JPEG_TN");
+        if (gupnp_didl_lite_object_wants_attribute (object,
+                                                    "dlna",
+                                                    "profileID",
+                                                    "upnp",
+                                                    "albumArtURI"))
+                xmlSetNsProp (node,
+                              priv->dlna_ns,
+                              (const unsigned char *) "profileID",
+                              (const unsigned char *) "JPEG_TN");
 
         g_object_notify (G_OBJECT (object), "album-art");
 }
@@ -2143,6 +2793,11 @@ gupnp_didl_lite_object_set_description (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object,
+                                                    "dc",
+                                                    "description"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_DC,
                                &(priv->dc_ns),
@@ -2169,6 +2824,9 @@ gupnp_didl_lite_object_set_date (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object, "dc", "date"))
+                return;
+
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_DC,
                                &(priv->dc_ns),
@@ -2197,6 +2855,11 @@ gupnp_didl_lite_object_set_track_number (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object,
+                                                    "upnp",
+                                                    "originalTrackNumber"))
+                return;
+
         str = g_strdup_printf ("%d", track_number);
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_UPNP,
@@ -2227,6 +2890,13 @@ gupnp_didl_lite_object_set_dlna_managed (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_attribute (object,
+                                                     "dlna",
+                                                     "dlnaManaged",
+                                                     NULL,
+                                                     NULL))
+                return;
+
         av_xml_util_get_ns (priv->xml_doc->doc,
                             GUPNP_XML_NAMESPACE_DLNA,
                             &(priv->dlna_ns));
@@ -2259,6 +2929,11 @@ gupnp_didl_lite_object_set_update_id (GUPnPDIDLLiteObject *object,
         GUPnPDIDLLiteObjectPrivate *priv;
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
+        if (!gupnp_didl_lite_object_wants_property (object,
+                                                    "upnp",
+                                                    "objectUpdateID"))
+                return;
+
         str = g_strdup_printf ("%u", update_id);
         av_xml_util_set_child (priv->xml_node,
                                GUPNP_XML_NAMESPACE_UPNP,
@@ -2312,6 +2987,7 @@ gupnp_didl_lite_object_add_resource (GUPnPDIDLLiteObject *object)
                                 NULL,
                                 (unsigned char *) "res",
                                 NULL);
+        av_xml_doc_touch (res_node->doc);
 
         return gupnp_didl_lite_resource_new_from_xml (res_node,
                                                       priv->xml_doc,
@@ -2338,6 +3014,7 @@ gupnp_didl_lite_object_add_descriptor (GUPnPDIDLLiteObject *object)
 
         desc_node =
                 xmlNewChild (priv->xml_node, NULL, (xmlChar *) "desc", NULL);
+        av_xml_doc_touch (desc_node->doc);
 
         return gupnp_didl_lite_descriptor_new_from_xml (desc_node,
                                                         priv->xml_doc);
@@ -2607,7 +3284,7 @@ gupnp_didl_lite_object_apply_fragments (GUPnPDIDLLiteObject  *object,
                                                         &modified,
                                                         current_fragment,
                                                         new_fragment,
-                                                        didl_lite_xsd);
+                                                        get_didl_lite_xsd ());
 
                 if (result != GUPNP_DIDL_LITE_FRAGMENT_RESULT_OK)
                         goto out;
@@ -2616,12 +3293,63 @@ gupnp_didl_lite_object_apply_fragments (GUPnPDIDLLiteObject  *object,
         if (!fragment_util_apply_modification (&priv->xml_node,
                                                &modified))
                 result = GUPNP_DIDL_LITE_FRAGMENT_RESULT_UNKNOWN_ERROR;
+
+        /* Properties were replaced, and so possibly the object node */
+        av_xml_doc_touch (original.doc);
  out:
         if (modified.doc != NULL)
                 xmlFreeDoc (modified.doc);
         return result;
 }
 
+/**
+ * gupnp_didl_lite_object_detach:
+ * @object: #GUPnPDIDLLiteObject
+ *
+ * Move @object into a new XML document of its own, holding a copy of the
+ * object node below a DIDL-Lite root and declaring only the namespaces the
+ * object uses. Afterwards @object no longer keeps the document it was
+ * parsed from alive, so a large Browse result can be freed while a few of
+ * its objects are kept around.
+ *
+ * Resources, contributors and descriptors fetched from @object before are
+ * not affected by changes made after detaching, and vice versa.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_object_detach (GUPnPDIDLLiteObject *object)
+{
+        GUPnPAVXMLNamespaces namespaces = { { NULL, } };
+        xmlNode *root;
+        xmlNode *new_root;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object));
+        GUPnPDIDLLiteObjectPrivate *priv;
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        root = xmlDocGetRootElement (priv->xml_node->doc);
+        if (root == NULL || root == priv->xml_node)
+                return;
+
+        new_root = av_xml_util_copy_node_to_new_doc (priv->xml_node, root);
+        av_xml_util_resolve_namespaces (new_root->doc, &namespaces);
+
+        /* Everything cached refers to the old document */
+        g_clear_pointer (&priv->resources, g_ptr_array_unref);
+        priv->index_valid = FALSE;
+
+        g_clear_pointer (&priv->xml_doc, av_xml_doc_unref);
+        priv->xml_doc = av_xml_doc_new (new_root->doc);
+        priv->xml_node = new_root->children;
+
+        /* Namespaces the object does not use yet are declared on demand */
+        priv->upnp_ns = namespaces.ns[GUPNP_XML_NAMESPACE_UPNP];
+        priv->dc_ns = namespaces.ns[GUPNP_XML_NAMESPACE_DC];
+        priv->dlna_ns = namespaces.ns[GUPNP_XML_NAMESPACE_DLNA];
+        priv->pv_ns = namespaces.ns[GUPNP_XML_NAMESPACE_PV];
+}
+
 /**
  * gupnp_didl_lite_object_get_xml_string:
  * @object: #GUPnPDIDLLiteObject
@@ -2632,19 +3360,97 @@ gupnp_didl_lite_object_apply_fragments (GUPnPDIDLLiteObject  *object,
 char *
 gupnp_didl_lite_object_get_xml_string (GUPnPDIDLLiteObject *object)
 {
-        xmlBuffer *buffer = NULL;
-        char *ret = NULL;
+        GString *string;
+
+        string = g_string_new (NULL);
+        gupnp_didl_lite_object_append_xml_string (object, string);
+
+        return g_string_free (string, FALSE);
+}
+
+/**
+ * gupnp_didl_lite_object_get_xml_bytes:
+ * @object: #GUPnPDIDLLiteObject
+ *
+ * Get the representation of this object as XML, like
+ * gupnp_didl_lite_object_get_xml_string(). The returned #GBytes owns the
+ * buffer the object was serialized into, so the XML is never copied.
+ *
+ * Returns: (transfer full): XML representation of this object.
+ *
+ * Since: 0.16
+ **/
+GBytes *
+gupnp_didl_lite_object_get_xml_bytes (GUPnPDIDLLiteObject *object)
+{
         GUPnPDIDLLiteObjectPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+
         priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        buffer = xmlBufferCreate ();
-        xmlNodeDump (buffer, priv->xml_doc->doc, priv->xml_node, 0, 0);
+        return av_xml_util_dump_node_to_bytes (priv->xml_node->doc,
+                                               priv->xml_node);
+}
+
+/**
+ * gupnp_didl_lite_object_append_xml_string:
+ * @object: #GUPnPDIDLLiteObject
+ * @string: The #GString to append to
+ *
+ * Append the XML representation of this object to @string.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_object_append_xml_string (GUPnPDIDLLiteObject *object,
+                                          GString             *string)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object));
+        g_return_if_fail (string != NULL);
 
-        ret = g_strndup ((char *) xmlBufferContent (buffer),
-                         xmlBufferLength (buffer));
-        xmlBufferFree (buffer);
+        priv = gupnp_didl_lite_object_get_instance_private (object);
 
-        return ret;
+        av_xml_util_dump_node_to_string (string,
+                                         priv->xml_node->doc,
+                                         priv->xml_node);
+}
+
+/**
+ * gupnp_didl_lite_object_write_xml:
+ * @object: #GUPnPDIDLLiteObject
+ * @stream: The #GOutputStream to write to
+ * @cancellable: (nullable): A #GCancellable, or %NULL
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Write the XML representation of this object to @stream. The XML is
+ * written in small chunks as it is serialized.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_object_write_xml (GUPnPDIDLLiteObject *object,
+                                  GOutputStream       *stream,
+                                  GCancellable        *cancellable,
+                                  GError             **error)
+{
+        GUPnPDIDLLiteObjectPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), FALSE);
+        g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), FALSE);
+
+        priv = gupnp_didl_lite_object_get_instance_private (object);
+
+        return av_xml_util_dump_node_to_stream (stream,
+                                                priv->xml_node->doc,
+                                                priv->xml_node,
+                                                cancellable,
+                                                error);
 }
 
 /**
@@ -2661,36 +3467,24 @@ gupnp_didl_lite_object_get_xml_string (GUPnPDIDLLiteObject *object)
 char *
 gupnp_format_date_time_for_didl_lite (GDateTime *date_time, gboolean date_only)
 {
-        g_return_val_if_fail (date_time != NULL, NULL);
-
-        if (date_only) {
-                return g_date_time_format (date_time, "%F");
-        }
+        DateTimeFields fields;
 
-        const char *format = "%FT%H:%M:%S";
-        char *base_string = g_date_time_format (date_time, format);
-        GString *iso_string = g_string_new (base_string);
-
-        // Check if we have sub-second precision. If so, we use that as well,
-        // but cannot use %f since that will use microsecond precision, but DLNA
-        // only allows for millisecond so we append the milliseconds manually
-        if (g_date_time_get_microsecond (date_time) % G_TIME_SPAN_SECOND != 0) {
-                g_string_append_printf (
-                        iso_string,
-                        ".%03d",
-                        g_date_time_get_microsecond (date_time) / 1000);
-        }
-
-        GTimeSpan utc_offset = g_date_time_get_utc_offset (date_time);
-        if (utc_offset == 0) {
-                g_string_append (iso_string, "Z");
-        } else {
-                char *time_zone = g_date_time_format (date_time, "%:z");
-                g_string_append (iso_string, time_zone);
-                g_free (time_zone);
-        }
-
-        g_free (base_string);
+        g_return_val_if_fail (date_time != NULL, NULL);
 
-        return g_string_free (iso_string, FALSE);
+        g_date_time_get_ymd (date_time,
+                             &fields.year,
+                             &fields.month,
+                             &fields.day);
+        fields.has_time = !date_only;
+        fields.hour = g_date_time_get_hour (date_time);
+        fields.minute = g_date_time_get_minute (date_time);
+        fields.second = g_date_time_get_second (date_time);
+        // DLNA only allows for millisecond precision, which
+        // date_time_format() takes care of
+        fields.microsecond = g_date_time_get_microsecond (date_time);
+        fields.has_utc_offset = TRUE;
+        fields.utc_offset = (int) (g_date_time_get_utc_offset (date_time) /
+                                   G_TIME_SPAN_SECOND);
+
+        return date_time_format (&fields, date_only);
 }
@@ -16,13 +16,14 @@
 #define GUPNP_DIDL_LITE_OBJECT_H
 
 #include <stdarg.h>
-#include <glib-object.h>
+#include <gio/gio.h>
 #include <libxml/tree.h>
 
 #include "gupnp-didl-lite-resource.h"
 #include "gupnp-didl-lite-descriptor.h"
 #include "gupnp-didl-lite-contributor.h"
 #include "gupnp-av-enums.h"
+#include "gupnp-protocol-info-matcher.h"
 
 G_BEGIN_DECLS
 
@@ -37,6 +38,93 @@ G_DECLARE_DERIVABLE_TYPE(GUPnPDIDLLiteObject,
 
 typedef struct _GUPnPDIDLLiteObjectPrivate GUPnPDIDLLiteObjectPrivate;
 
+GType
+gupnp_didl_lite_field_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_FIELD (gupnp_didl_lite_field_get_type ())
+
+/**
+ * GUPnPDIDLLiteField:
+ * @GUPNP_DIDL_LITE_FIELD_NONE: No field
+ * @GUPNP_DIDL_LITE_FIELD_ID: The ID of the object
+ * @GUPNP_DIDL_LITE_FIELD_PARENT_ID: The ID of the parent of the object
+ * @GUPNP_DIDL_LITE_FIELD_UPNP_CLASS: The UPnP class of the object
+ * @GUPNP_DIDL_LITE_FIELD_TITLE: The title of the object
+ * @GUPNP_DIDL_LITE_FIELD_CREATOR: The creator of the object
+ * @GUPNP_DIDL_LITE_FIELD_ARTIST: The first artist of the object
+ * @GUPNP_DIDL_LITE_FIELD_ALBUM: The album of the object
+ * @GUPNP_DIDL_LITE_FIELD_ALBUM_ART: The URI of the album art of the object
+ * @GUPNP_DIDL_LITE_FIELD_GENRE: The genre of the object
+ * @GUPNP_DIDL_LITE_FIELD_DATE: The date of the object
+ * @GUPNP_DIDL_LITE_FIELD_DESCRIPTION: The description of the object
+ * @GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER: The original track number of the
+ * object
+ * @GUPNP_DIDL_LITE_FIELD_DURATION: The duration of the first resource of the
+ * object
+ * @GUPNP_DIDL_LITE_FIELD_ALL: All of the above
+ *
+ * Fields of a #GUPnPDIDLLiteObject that can be fetched at once with
+ * gupnp_didl_lite_object_get_fields().
+ *
+ * Since: 0.16
+ **/
+typedef enum {
+        GUPNP_DIDL_LITE_FIELD_NONE         = 0,
+        GUPNP_DIDL_LITE_FIELD_ID           = 1 << 0,
+        GUPNP_DIDL_LITE_FIELD_PARENT_ID    = 1 << 1,
+        GUPNP_DIDL_LITE_FIELD_UPNP_CLASS   = 1 << 2,
+        GUPNP_DIDL_LITE_FIELD_TITLE        = 1 << 3,
+        GUPNP_DIDL_LITE_FIELD_CREATOR      = 1 << 4,
+        GUPNP_DIDL_LITE_FIELD_ARTIST       = 1 << 5,
+        GUPNP_DIDL_LITE_FIELD_ALBUM        = 1 << 6,
+        GUPNP_DIDL_LITE_FIELD_ALBUM_ART    = 1 << 7,
+        GUPNP_DIDL_LITE_FIELD_GENRE        = 1 << 8,
+        GUPNP_DIDL_LITE_FIELD_DATE         = 1 << 9,
+        GUPNP_DIDL_LITE_FIELD_DESCRIPTION  = 1 << 10,
+        GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER = 1 << 11,
+        GUPNP_DIDL_LITE_FIELD_DURATION     = 1 << 12,
+        GUPNP_DIDL_LITE_FIELD_ALL          = (1 << 13) - 1
+} GUPnPDIDLLiteField;
+
+/**
+ * GUPnPDIDLLiteFields:
+ * @id: The ID of the object
+ * @parent_id: The ID of the parent of the object
+ * @upnp_class: The UPnP class of the object
+ * @title: The title of the object
+ * @creator: The creator of the object
+ * @artist: The first artist of the object
+ * @album: The album of the object
+ * @album_art: The URI of the album art of the object
+ * @genre: The genre of the object
+ * @date: The date of the object
+ * @description: The description of the object
+ * @track_number: The original track number of the object, or -1
+ * @duration: The duration (in seconds) of the first resource of the object,
+ * or -1
+ *
+ * Caller-allocated storage for gupnp_didl_lite_object_get_fields(). Fields
+ * that were not requested or not found are %NULL or -1. The strings belong
+ * to the object and are valid until it is modified or freed.
+ *
+ * Since: 0.16
+ **/
+typedef struct {
+        const char *id;
+        const char *parent_id;
+        const char *upnp_class;
+        const char *title;
+        const char *creator;
+        const char *artist;
+        const char *album;
+        const char *album_art;
+        const char *genre;
+        const char *date;
+        const char *description;
+        int         track_number;
+        glong       duration;
+} GUPnPDIDLLiteFields;
+
 struct _GUPnPDIDLLiteObjectClass {
         GObjectClass parent_class;
 
@@ -128,6 +216,13 @@ gupnp_didl_lite_object_get_description  (GUPnPDIDLLiteObject *object);
 const char *
 gupnp_didl_lite_object_get_date         (GUPnPDIDLLiteObject *object);
 
+GDateTime *
+gupnp_didl_lite_object_get_date_time    (GUPnPDIDLLiteObject *object);
+
+gint64
+gupnp_didl_lite_object_get_date_sort_key
+                                        (GUPnPDIDLLiteObject *object);
+
 int
 gupnp_didl_lite_object_get_track_number (GUPnPDIDLLiteObject *object);
 
@@ -140,9 +235,18 @@ gupnp_didl_lite_object_get_update_id    (GUPnPDIDLLiteObject *object);
 gboolean
 gupnp_didl_lite_object_update_id_is_set (GUPnPDIDLLiteObject *object);
 
+GUPnPDIDLLiteField
+gupnp_didl_lite_object_get_fields       (GUPnPDIDLLiteObject *object,
+                                         GUPnPDIDLLiteField   requested,
+                                         GUPnPDIDLLiteFields *fields);
+
 GList *
 gupnp_didl_lite_object_get_resources    (GUPnPDIDLLiteObject *object);
 
+GPtrArray *
+gupnp_didl_lite_object_get_resources_as_array
+                                        (GUPnPDIDLLiteObject *object);
+
 GUPnPDIDLLiteResource *
 gupnp_didl_lite_object_get_compat_resource
                                         (GUPnPDIDLLiteObject *object,
@@ -150,6 +254,12 @@ gupnp_didl_lite_object_get_compat_resource
                                          *sink_protocol_info,
                                          gboolean             lenient);
 
+GUPnPDIDLLiteResource *
+gupnp_didl_lite_object_get_compat_resource_with_matcher
+                                        (GUPnPDIDLLiteObject      *object,
+                                         GUPnPProtocolInfoMatcher *matcher,
+                                         gboolean                  lenient);
+
 GUPnPDIDLLiteResource *
 gupnp_didl_lite_object_add_resource     (GUPnPDIDLLiteObject *object);
 
@@ -274,9 +384,26 @@ gupnp_didl_lite_object_apply_fragments
                                        gchar               **new_fragments,
                                        gint                  new_size);
 
+void
+gupnp_didl_lite_object_detach           (GUPnPDIDLLiteObject *object);
+
 char *
 gupnp_didl_lite_object_get_xml_string   (GUPnPDIDLLiteObject *object);
 
+GBytes *
+gupnp_didl_lite_object_get_xml_bytes    (GUPnPDIDLLiteObject *object);
+
+void
+gupnp_didl_lite_object_append_xml_string
+                                        (GUPnPDIDLLiteObject *object,
+                                         GString             *string);
+
+gboolean
+gupnp_didl_lite_object_write_xml        (GUPnPDIDLLiteObject *object,
+                                         GOutputStream       *stream,
+                                         GCancellable        *cancellable,
+                                         GError             **error);
+
 char *
 gupnp_format_date_time_for_didl_lite (GDateTime *date_time, gboolean date_only);
 
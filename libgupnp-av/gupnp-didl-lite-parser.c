@@ -14,6 +14,17 @@
  *
  * #GUPnPDIDLLiteParser parses DIDL-Lite XML strings.
  *
+ * A single #GUPnPDIDLLiteParser must only be used from one thread at a time,
+ * but separate parsers can be used from different threads concurrently.
+ *
+ * The objects a parser hands out are independent of it, but all objects
+ * returned by one parse call share one XML document. They must be used from
+ * one thread at a time, and that includes releasing them. They may be passed
+ * to another thread together, which is what
+ * gupnp_didl_lite_parser_parse_didl_async() does to parse on a worker thread.
+ * Objects returned by different parse calls can be used from different
+ * threads concurrently.
+ *
  */
 
 #include <config.h>
@@ -22,12 +33,50 @@
 #include <ctype.h>
 #include "gupnp-av.h"
 #include "gupnp-didl-lite-object-private.h"
+#include "gupnp-didl-lite-object-handle-private.h"
+#include "gupnp-av-string-dict-private.h"
+#include "gupnp-didl-lite-scan-result-private.h"
+#include "gupnp-didl-lite-filter-private.h"
+#include "filter-util.h"
 #include "xml-util.h"
 #include "gupnp-didl-lite-parser-private.h"
 
-G_DEFINE_TYPE (GUPnPDIDLLiteParser,
-               gupnp_didl_lite_parser,
-               G_TYPE_OBJECT)
+#include <libxml/SAX2.h>
+
+/* Amount of input handed to the push parser at once in streaming mode */
+#define STREAM_CHUNK_SIZE 65536
+
+/* Amount of input quoted in error messages */
+#define ERROR_EXCERPT_LENGTH 40
+
+/* Number of attributes the filter handles without allocating */
+#define FILTER_STACK_ATTRIBUTES 16
+
+typedef struct _StreamContext StreamContext;
+
+struct _GUPnPDIDLLiteParserPrivate {
+        gboolean       streaming;
+
+        char          *filter;
+        GUPnPDIDLLiteFilter *compiled_filter;
+
+        GUPnPAVStringDict *string_dict;
+
+        /* Document currently being fed through the push API */
+        StreamContext *push_context;
+};
+typedef struct _GUPnPDIDLLiteParserPrivate GUPnPDIDLLiteParserPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GUPnPDIDLLiteParser,
+                            gupnp_didl_lite_parser,
+                            G_TYPE_OBJECT)
+
+enum {
+        PROP_0,
+        PROP_STREAMING,
+        PROP_FILTER,
+        PROP_STRING_DICT
+};
 
 enum {
         OBJECT_AVAILABLE,
@@ -103,31 +152,180 @@ verify_didl_attributes (xmlNode *node)
         return TRUE;
 }
 
+/* Per-run settings shared by the tree and the streaming parser */
+typedef struct {
+        GUPnPDIDLLiteParser          *parser;
+        gboolean                      recursive;
+
+        /* Plain callback replacing the signals, if set */
+        GUPnPDIDLLiteParserObjectFunc func;
+        gpointer                      user_data;
+
+        GCancellable                 *cancellable;
+
+        /* The Browse filter to apply, or NULL for all properties, and the
+         * number of elements still open below a dropped one */
+        GUPnPDIDLLiteFilter          *filter;
+        guint                         skip_depth;
+
+        /* Dictionary to share the strings of the documents in, if any */
+        GUPnPAVStringDict            *string_dict;
+
+        /* Callback taking handles instead of objects, if set */
+        GUPnPDIDLLiteParserHandleFunc handle_func;
+} ParseContext;
+
+static gboolean
+parse_elements (ParseContext  *context,
+                xmlNode       *node,
+                GUPnPAVXMLDoc *xml_doc,
+                xmlNs         *upnp_ns,
+                xmlNs         *dc_ns,
+                xmlNs         *dlna_ns,
+                xmlNs         *pv_ns,
+                GError       **error);
+
+static gboolean
+parse_didl_data (ParseContext *context,
+                 const char   *data,
+                 gsize         length,
+                 GError      **error);
+
+static gboolean
+parse_didl_run (ParseContext *context,
+                const char   *data,
+                gsize         length,
+                GError      **error);
+
+static void
+set_didl_error (GError         **error,
+                GMarkupError     code,
+                const char      *message,
+                const char      *data,
+                gsize            length,
+                const xmlError  *xml_error);
+
+struct _StreamContext {
+        /* Must come first, the filter handlers take the parser's private
+         * data for a ParseContext */
+        ParseContext   parse;
+        xmlParserCtxt *ctxt;
+        gboolean       had_children;
+        GError        *error;
+};
+
+static StreamContext *
+stream_context_new (const ParseContext *parse);
+
+static void
+stream_context_free (StreamContext *context);
+
+static gboolean
+stream_context_feed (StreamContext *context,
+                     const char    *data,
+                     gsize          length);
+
 static gboolean
-parse_elements (GUPnPDIDLLiteParser *parser,
-                xmlNode             *node,
-                GUPnPAVXMLDoc       *xml_doc,
-                xmlNs               *upnp_ns,
-                xmlNs               *dc_ns,
-                xmlNs               *dlna_ns,
-                xmlNs               *pv_ns,
-                gboolean             recursive,
-                GError             **error);
+stream_context_finish (StreamContext *context,
+                       const char    *data,
+                       gsize          length,
+                       GError       **error);
 
 static void
 gupnp_didl_lite_parser_init (G_GNUC_UNUSED GUPnPDIDLLiteParser *parser)
 {
 }
 
+static void
+gupnp_didl_lite_parser_set_property (GObject      *object,
+                                     guint         property_id,
+                                     const GValue *value,
+                                     GParamSpec   *pspec)
+{
+        GUPnPDIDLLiteParser *parser;
+
+        parser = GUPNP_DIDL_LITE_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STREAMING:
+                gupnp_didl_lite_parser_set_streaming (parser,
+                                                      g_value_get_boolean (value));
+                break;
+        case PROP_FILTER:
+                gupnp_didl_lite_parser_set_filter (parser,
+                                                   g_value_get_string (value));
+                break;
+        case PROP_STRING_DICT:
+                gupnp_didl_lite_parser_set_string_dict
+                                        (parser, g_value_get_boxed (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
+static void
+gupnp_didl_lite_parser_get_property (GObject    *object,
+                                     guint       property_id,
+                                     GValue     *value,
+                                     GParamSpec *pspec)
+{
+        GUPnPDIDLLiteParser *parser;
+
+        parser = GUPNP_DIDL_LITE_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STREAMING:
+                g_value_set_boolean
+                        (value, gupnp_didl_lite_parser_get_streaming (parser));
+                break;
+        case PROP_FILTER:
+                g_value_set_string
+                        (value, gupnp_didl_lite_parser_get_filter (parser));
+                break;
+        case PROP_STRING_DICT:
+                g_value_set_boxed
+                        (value, gupnp_didl_lite_parser_get_string_dict (parser));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
 static void
 gupnp_didl_lite_parser_dispose (GObject *object)
 {
         GObjectClass   *gobject_class;
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        priv = gupnp_didl_lite_parser_get_instance_private
+                                        (GUPNP_DIDL_LITE_PARSER (object));
+
+        g_clear_pointer (&priv->push_context, stream_context_free);
+        g_clear_pointer (&priv->string_dict, gupnp_av_string_dict_unref);
 
         gobject_class = G_OBJECT_CLASS (gupnp_didl_lite_parser_parent_class);
         gobject_class->dispose (object);
 }
 
+static void
+gupnp_didl_lite_parser_finalize (GObject *object)
+{
+        GObjectClass   *gobject_class;
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        priv = gupnp_didl_lite_parser_get_instance_private
+                                        (GUPNP_DIDL_LITE_PARSER (object));
+
+        g_free (priv->filter);
+        g_clear_pointer (&priv->compiled_filter, gupnp_didl_lite_filter_unref);
+
+        gobject_class = G_OBJECT_CLASS (gupnp_didl_lite_parser_parent_class);
+        gobject_class->finalize (object);
+}
+
 static void
 gupnp_didl_lite_parser_class_init (GUPnPDIDLLiteParserClass *klass)
 {
@@ -135,7 +333,91 @@ gupnp_didl_lite_parser_class_init (GUPnPDIDLLiteParserClass *klass)
 
         object_class = G_OBJECT_CLASS (klass);
 
+        object_class->set_property = gupnp_didl_lite_parser_set_property;
+        object_class->get_property = gupnp_didl_lite_parser_get_property;
         object_class->dispose = gupnp_didl_lite_parser_dispose;
+        object_class->finalize = gupnp_didl_lite_parser_finalize;
+
+        /* Make sure libxml2's global state is set up before any parser runs
+         * on a worker thread */
+        xmlInitParser ();
+
+        /**
+         * GUPnPDIDLLiteParser:streaming:
+         *
+         * Whether to parse DIDL-Lite documents in streaming mode.
+         *
+         * In streaming mode the document is never built as a whole. Each
+         * top-level item or container is handed out as soon as its closing
+         * tag has been read and is moved into a small document of its own,
+         * so peak memory is bounded by the largest object rather than by
+         * the size of the input.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_STREAMING,
+                 g_param_spec_boolean ("streaming",
+                                       "Streaming",
+                                       "Whether to parse DIDL-Lite documents"
+                                       " object by object.",
+                                       FALSE,
+                                       G_PARAM_READWRITE |
+                                       G_PARAM_STATIC_NAME |
+                                       G_PARAM_STATIC_NICK |
+                                       G_PARAM_STATIC_BLURB));
+
+        /**
+         * GUPnPDIDLLiteParser:filter:
+         *
+         * A Browse or Search filter string restricting the properties that
+         * are kept while parsing, using the same syntax as
+         * gupnp_didl_lite_writer_filter(). %NULL or "*" keep everything.
+         *
+         * Excluded elements and attributes are skipped as they are read and
+         * never become part of the XML tree of the parsed objects.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_FILTER,
+                 g_param_spec_string ("filter",
+                                      "Filter",
+                                      "The properties to keep while parsing.",
+                                      NULL,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_NAME |
+                                      G_PARAM_STATIC_NICK |
+                                      G_PARAM_STATIC_BLURB));
+
+        /**
+         * GUPnPDIDLLiteParser:string-dict:
+         *
+         * The [struct@GUPnPAV.AVStringDict] to intern the strings of parsed
+         * documents in, or %NULL to give each document a dictionary of its
+         * own.
+         *
+         * Sharing one dictionary between the parsers feeding a large object
+         * cache stores names, classes and protocol infos only once.
+         * gupnp_didl_lite_parser_parse_didl_async() does not use it, as a
+         * dictionary must not be used by several threads.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_STRING_DICT,
+                 g_param_spec_boxed ("string-dict",
+                                     "String dictionary",
+                                     "The dictionary shared by the parsed"
+                                     " documents.",
+                                     GUPNP_TYPE_AV_STRING_DICT,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_NAME |
+                                     G_PARAM_STATIC_NICK |
+                                     G_PARAM_STATIC_BLURB));
 
         /**
          * GUPnPDIDLLiteParser::object-available:
@@ -253,160 +535,1898 @@ gupnp_didl_lite_parser_parse_didl_recursive (GUPnPDIDLLiteParser *parser,
                                              gboolean             recursive,
                                              GError             **error)
 {
-        xmlDoc        *doc;
-        xmlNode       *element;
-        xmlNs         *upnp_ns = NULL;
-        xmlNs         *dc_ns   = NULL;
-        xmlNs         *dlna_ns = NULL;
-        xmlNs         *pv_ns   = NULL;
-        GUPnPAVXMLDoc *xml_doc = NULL;
-        gboolean       result;
+        ParseContext context = { parser, recursive, NULL, NULL };
 
-        doc = xmlReadMemory (didl,
-                             strlen (didl),
-                             NULL,
-                             NULL,
-                             XML_PARSE_NONET | XML_PARSE_RECOVER);
-        if (doc == NULL) {
-                g_set_error (error,
-                             G_MARKUP_ERROR,
-                             G_MARKUP_ERROR_PARSE,
-                             "Could not parse DIDL-Lite XML:\n%s",
-                             didl);
+        g_return_val_if_fail (didl != NULL, FALSE);
 
-                return FALSE;
-        }
+        return parse_didl_data (&context, didl, strlen (didl), error);
+}
 
-        /* Get a pointer to root element */
-        element = av_xml_util_get_element ((xmlNode *) doc,
-                                           "DIDL-Lite",
-                                           NULL);
-        if (element == NULL) {
-                g_set_error (error,
-                             G_MARKUP_ERROR,
-                             G_MARKUP_ERROR_PARSE,
-                             "No 'DIDL-Lite' node in the DIDL-Lite XML:\n%s",
-                             didl);
-                xmlFreeDoc (doc);
+/**
+ * gupnp_didl_lite_parser_parse_bytes:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @didl: The DIDL-Lite XML document to be parsed
+ * @recursive: Whether to also emit the signals for objects nested in
+ * containers
+ * @error: The location where to store any error, or %NULL
+ *
+ * Parses the DIDL-Lite XML document in @didl, emitting the ::object-available,
+ * ::item-available and ::container-available signals appropriately during the
+ * process. @didl does not need to be nul-terminated and is not copied.
+ *
+ * Errors point to the offending position and quote a short excerpt of the
+ * document instead of the document itself.
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_parser_parse_bytes (GUPnPDIDLLiteParser *parser,
+                                    GBytes              *didl,
+                                    gboolean             recursive,
+                                    GError             **error)
+{
+        ParseContext  context = { parser, recursive, NULL, NULL };
+        gconstpointer data;
+        gsize         length;
+        gboolean      result;
 
-                return FALSE;
-        }
+        g_return_val_if_fail (didl != NULL, FALSE);
 
-        if (element->children == NULL) {
-                g_set_error (error,
-                             G_MARKUP_ERROR,
-                             G_MARKUP_ERROR_EMPTY,
-                             "Empty 'DIDL-Lite' node in the DIDL-Lite XML:\n%s",
-                             didl);
-                xmlFreeDoc (doc);
+        g_bytes_ref (didl);
+        data = g_bytes_get_data (didl, &length);
+        result = parse_didl_data (&context, data, length, error);
+        g_bytes_unref (didl);
 
-                return FALSE;
-        }
+        return result;
+}
 
-        /* Create namespaces if they don't exist */
-        upnp_ns = av_xml_util_lookup_namespace (doc, GUPNP_XML_NAMESPACE_UPNP);
-        if (! upnp_ns)
-                upnp_ns = av_xml_util_create_namespace
-                                        (xmlDocGetRootElement (doc),
-                                         GUPNP_XML_NAMESPACE_UPNP);
-
-        dc_ns = av_xml_util_lookup_namespace (doc, GUPNP_XML_NAMESPACE_DC);
-        if (! dc_ns)
-                dc_ns = av_xml_util_create_namespace
-                                        (xmlDocGetRootElement (doc),
-                                         GUPNP_XML_NAMESPACE_DC);
-        dlna_ns = av_xml_util_lookup_namespace (doc, GUPNP_XML_NAMESPACE_DLNA);
-        if (! dlna_ns)
-                dlna_ns = av_xml_util_create_namespace
-                                        (xmlDocGetRootElement (doc),
-                                         GUPNP_XML_NAMESPACE_DLNA);
-
-        pv_ns = av_xml_util_lookup_namespace (doc, GUPNP_XML_NAMESPACE_PV);
-        if (! pv_ns)
-                pv_ns = av_xml_util_create_namespace
-                                        (xmlDocGetRootElement (doc),
-                                         GUPNP_XML_NAMESPACE_PV);
+/**
+ * gupnp_didl_lite_parser_parse_didl_foreach:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @didl: The DIDL-Lite XML string to be parsed
+ * @recursive: Whether to also call @func for objects nested in containers
+ * @func: (scope call): Function to call for every object
+ * @user_data: (closure): User data for @func
+ * @error: The location where to store any error, or %NULL
+ *
+ * Parses DIDL-Lite XML string @didl, calling @func for every item and
+ * container in document order instead of emitting the ::object-available,
+ * ::item-available and ::container-available signals. This avoids the
+ * overhead of signal emission for callers that do not need it.
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_parser_parse_didl_foreach
+                                (GUPnPDIDLLiteParser          *parser,
+                                 const char                   *didl,
+                                 gboolean                      recursive,
+                                 GUPnPDIDLLiteParserObjectFunc func,
+                                 gpointer                      user_data,
+                                 GError                      **error)
+{
+        ParseContext context = { parser, recursive, func, user_data };
 
-        xml_doc = av_xml_doc_new (doc);
+        g_return_val_if_fail (didl != NULL, FALSE);
+        g_return_val_if_fail (func != NULL, FALSE);
 
-        result = parse_elements (parser,
-                                 element,
-                                 xml_doc,
-                                 upnp_ns,
-                                 dc_ns,
-                                 dlna_ns,
-                                 pv_ns,
-                                 recursive,
-                                 error);
-        av_xml_doc_unref (xml_doc);
+        return parse_didl_data (&context, didl, strlen (didl), error);
+}
 
-        return result;
+static void
+append_object (GUPnPDIDLLiteObject *object,
+               gpointer             user_data)
+{
+        g_ptr_array_add ((GPtrArray *) user_data, g_object_ref (object));
 }
 
-static gboolean
-parse_elements (GUPnPDIDLLiteParser *parser,
-                xmlNode             *node,
-                GUPnPAVXMLDoc       *xml_doc,
-                xmlNs               *upnp_ns,
-                xmlNs               *dc_ns,
-                xmlNs               *dlna_ns,
-                xmlNs               *pv_ns,
-                gboolean             recursive,
-                GError             **error)
+/**
+ * gupnp_didl_lite_parser_parse_didl_as_array:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @didl: The DIDL-Lite XML string to be parsed
+ * @recursive: Whether to also collect the objects nested in containers
+ * @error: The location where to store any error, or %NULL
+ *
+ * Parses DIDL-Lite XML string @didl and collects all items and containers in
+ * document order, each container followed by its children if @recursive is
+ * %TRUE. No signals are emitted.
+ *
+ * Returns: (transfer container) (element-type GUPnPDIDLLiteObject): The
+ * parsed objects, or %NULL on error. Free with g_ptr_array_unref().
+ *
+ * Since: 0.16
+ **/
+GPtrArray *
+gupnp_didl_lite_parser_parse_didl_as_array (GUPnPDIDLLiteParser *parser,
+                                            const char          *didl,
+                                            gboolean             recursive,
+                                            GError             **error)
 {
-        xmlNode *element;
+        GPtrArray *objects;
 
-        for (element = node->children; element; element = element->next) {
-                GUPnPDIDLLiteObject *object;
+        g_return_val_if_fail (didl != NULL, NULL);
 
-                object = gupnp_didl_lite_object_new_from_xml (element, xml_doc,
-                                                              upnp_ns, dc_ns,
-                                                              dlna_ns, pv_ns);
+        objects = g_ptr_array_new_with_free_func (g_object_unref);
+        if (!gupnp_didl_lite_parser_parse_didl_foreach (parser,
+                                                        didl,
+                                                        recursive,
+                                                        append_object,
+                                                        objects,
+                                                        error))
+                g_clear_pointer (&objects, g_ptr_array_unref);
 
-                if (object == NULL)
-                        continue;
+        return objects;
+}
 
-                if (GUPNP_IS_DIDL_LITE_CONTAINER (object)) {
-                        g_signal_emit (parser,
-                                       signals[CONTAINER_AVAILABLE],
-                                       0,
-                                       object);
-                        if (recursive &&
-                            !parse_elements (parser,
-                                             element,
-                                             xml_doc,
-                                             upnp_ns,
-                                             dc_ns,
-                                             dlna_ns,
-                                             pv_ns,
-                                             recursive,
-                                             error)) {
-                                g_object_unref (object);
+/**
+ * gupnp_didl_lite_parser_parse_didl_lazy:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @didl: The DIDL-Lite XML string to be parsed
+ * @recursive: Whether to also hand out the objects nested in containers
+ * @func: (scope call): Function to call for every object
+ * @user_data: (closure): User data for @func
+ * @error: The location where to store any error, or %NULL
+ *
+ * Parses DIDL-Lite XML string @didl, calling @func with a
+ * [struct@GUPnPAV.DIDLLiteObjectHandle] for every item and container in
+ * document order. No #GUPnPDIDLLiteObject is created until
+ * gupnp_didl_lite_object_handle_get_object() asks for it, so handlers only
+ * interested in a few of the objects do not pay for the others. No signals
+ * are emitted.
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_parser_parse_didl_lazy
+                                (GUPnPDIDLLiteParser          *parser,
+                                 const char                   *didl,
+                                 gboolean                      recursive,
+                                 GUPnPDIDLLiteParserHandleFunc func,
+                                 gpointer                      user_data,
+                                 GError                      **error)
+{
+        ParseContext context = { parser, recursive, NULL, user_data };
 
-                                return FALSE;
-                        }
-                } else if (GUPNP_IS_DIDL_LITE_ITEM (object)) {
-                        node = gupnp_didl_lite_object_get_xml_node (object);
-                        if (!verify_didl_attributes (node)) {
-                                g_object_unref (object);
-                                g_set_error (error,
-                                             G_MARKUP_ERROR,
-                                             G_MARKUP_ERROR_PARSE,
-                                             "Could not parse DIDL-Lite XML");
+        g_return_val_if_fail (didl != NULL, FALSE);
+        g_return_val_if_fail (func != NULL, FALSE);
 
-                                return FALSE;
-                        }
+        context.handle_func = func;
 
-                        g_signal_emit (parser,
-                                       signals[ITEM_AVAILABLE],
-                                       0,
-                                       object);
-                }
+        return parse_didl_data (&context, didl, strlen (didl), error);
+}
+
+/* Input of an asynchronous parse, taken over from the parser when it is
+ * started */
+typedef struct {
+        GBytes              *didl;
+        GUPnPDIDLLiteFilter *filter;
+} ParseTaskData;
+
+static void
+parse_task_data_free (ParseTaskData *task_data)
+{
+        g_bytes_unref (task_data->didl);
+        g_clear_pointer (&task_data->filter, gupnp_didl_lite_filter_unref);
+        g_free (task_data);
+}
+
+static void
+parse_didl_thread (GTask        *task,
+                   gpointer      source_object,
+                   gpointer      task_data,
+                   GCancellable *cancellable)
+{
+        ParseContext context = { source_object, FALSE, append_object, NULL };
+        ParseTaskData *parse_data = (ParseTaskData *) task_data;
+        GPtrArray   *objects;
+        GError      *error = NULL;
+        gconstpointer data;
+        gsize        length;
+
+        objects = g_ptr_array_new_with_free_func (g_object_unref);
+        context.user_data = objects;
+        context.cancellable = cancellable;
+        context.filter = parse_data->filter;
+
+        data = g_bytes_get_data (parse_data->didl, &length);
+        if (parse_didl_run (&context, data, length, &error))
+                g_task_return_pointer (task,
+                                       objects,
+                                       (GDestroyNotify) g_ptr_array_unref);
+        else {
+                g_ptr_array_unref (objects);
+                g_task_return_error (task, error);
+        }
+}
+
+/**
+ * gupnp_didl_lite_parser_parse_didl_async:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @didl: The DIDL-Lite XML string to be parsed
+ * @cancellable: (nullable): A #GCancellable, or %NULL
+ * @callback: (scope async): Callback to call once parsing is done
+ * @user_data: (closure): User data for @callback
+ *
+ * Asynchronously parses DIDL-Lite XML string @didl on a worker thread.
+ * @didl is copied and may be freed right after this call.
+ *
+ * No signals are emitted. @callback is called in the thread-default main
+ * context of the calling thread, where
+ * gupnp_didl_lite_parser_parse_didl_finish() returns the parsed objects.
+ *
+ * @parser must not be used for other parse operations until @callback has
+ * been called.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_parser_parse_didl_async (GUPnPDIDLLiteParser *parser,
+                                         const char          *didl,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+        ParseTaskData *task_data;
+        GTask *task;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser));
+        g_return_if_fail (didl != NULL);
+        g_return_if_fail (cancellable == NULL ||
+                          G_IS_CANCELLABLE (cancellable));
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        task_data = g_new0 (ParseTaskData, 1);
+        task_data->didl = g_bytes_new (didl, strlen (didl));
+        if (priv->compiled_filter != NULL)
+                task_data->filter =
+                        gupnp_didl_lite_filter_ref (priv->compiled_filter);
 
-                g_signal_emit (parser,
-                               signals[OBJECT_AVAILABLE],
-                               0,
-                               object);
+        task = g_task_new (parser, cancellable, callback, user_data);
+        g_task_set_source_tag (task, gupnp_didl_lite_parser_parse_didl_async);
+        g_task_set_task_data (task,
+                              task_data,
+                              (GDestroyNotify) parse_task_data_free);
+        g_task_run_in_thread (task, parse_didl_thread);
+        g_object_unref (task);
+}
+
+/**
+ * gupnp_didl_lite_parser_parse_didl_finish:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @result: The #GAsyncResult passed to the callback
+ * @error: The location where to store any error, or %NULL
+ *
+ * Finishes an operation started with
+ * gupnp_didl_lite_parser_parse_didl_async().
+ *
+ * Returns: (transfer container) (element-type GUPnPDIDLLiteObject): The
+ * parsed objects in document order, or %NULL on error. Free with
+ * g_ptr_array_unref().
+ *
+ * Since: 0.16
+ **/
+GPtrArray *
+gupnp_didl_lite_parser_parse_didl_finish (GUPnPDIDLLiteParser *parser,
+                                          GAsyncResult        *result,
+                                          GError             **error)
+{
+        g_return_val_if_fail (g_task_is_valid (result, parser), NULL);
+
+        return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * gupnp_didl_lite_parser_set_streaming:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @streaming: %TRUE to parse object by object
+ *
+ * Enables or disables streaming mode. See #GUPnPDIDLLiteParser:streaming.
+ *
+ * Objects obtained in streaming mode each live in their own XML document, so
+ * gupnp_didl_lite_object_get_xml_node() of two such objects never returns
+ * sibling nodes.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_parser_set_streaming (GUPnPDIDLLiteParser *parser,
+                                      gboolean             streaming)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser));
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        streaming = !!streaming;
+        if (priv->streaming == streaming)
+                return;
+
+        priv->streaming = streaming;
+        g_object_notify (G_OBJECT (parser), "streaming");
+}
+
+/**
+ * gupnp_didl_lite_parser_get_streaming:
+ * @parser: A #GUPnPDIDLLiteParser
+ *
+ * Get whether @parser is in streaming mode.
+ *
+ * Return value: %TRUE if @parser parses object by object.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_parser_get_streaming (GUPnPDIDLLiteParser *parser)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser), FALSE);
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        return priv->streaming;
+}
+
+/**
+ * gupnp_didl_lite_parser_set_filter:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @filter: (nullable): A filter string, or %NULL
+ *
+ * Restricts the properties kept while parsing to those named in @filter. See
+ * #GUPnPDIDLLiteParser:filter.
+ *
+ * The filter applies to documents parsed after this call. A document that is
+ * being fed through gupnp_didl_lite_parser_feed() keeps the filter it was
+ * started with.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_parser_set_filter (GUPnPDIDLLiteParser *parser,
+                                   const char          *filter)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser));
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        if (g_strcmp0 (priv->filter, filter) == 0)
+                return;
+
+        g_free (priv->filter);
+        g_clear_pointer (&priv->compiled_filter, gupnp_didl_lite_filter_unref);
+        priv->filter = g_strdup (filter);
+        if (filter != NULL) {
+                priv->compiled_filter = gupnp_didl_lite_filter_new (filter);
+
+                /* Nothing to filter out */
+                if (gupnp_didl_lite_filter_is_wildcard (priv->compiled_filter))
+                        g_clear_pointer (&priv->compiled_filter,
+                                         gupnp_didl_lite_filter_unref);
+        }
+
+        g_object_notify (G_OBJECT (parser), "filter");
+}
+
+/**
+ * gupnp_didl_lite_parser_get_filter:
+ * @parser: A #GUPnPDIDLLiteParser
+ *
+ * Get the filter applied by @parser.
+ *
+ * Return value: (nullable): The filter string, or %NULL if all properties are
+ * kept.
+ *
+ * Since: 0.16
+ **/
+const char *
+gupnp_didl_lite_parser_get_filter (GUPnPDIDLLiteParser *parser)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser), NULL);
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        return priv->filter;
+}
+
+/**
+ * gupnp_didl_lite_parser_set_string_dict:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @dict: (nullable): A [struct@GUPnPAV.AVStringDict], or %NULL
+ *
+ * Makes @parser intern the strings of the documents it parses in @dict. See
+ * #GUPnPDIDLLiteParser:string-dict.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_parser_set_string_dict (GUPnPDIDLLiteParser *parser,
+                                        GUPnPAVStringDict   *dict)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser));
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        if (priv->string_dict == dict)
+                return;
+
+        g_clear_pointer (&priv->string_dict, gupnp_av_string_dict_unref);
+        if (dict != NULL)
+                priv->string_dict = gupnp_av_string_dict_ref (dict);
+
+        g_object_notify (G_OBJECT (parser), "string-dict");
+}
+
+/**
+ * gupnp_didl_lite_parser_get_string_dict:
+ * @parser: A #GUPnPDIDLLiteParser
+ *
+ * Get the dictionary @parser interns strings in.
+ *
+ * Return value: (transfer none) (nullable): The [struct@GUPnPAV.AVStringDict],
+ * or %NULL.
+ *
+ * Since: 0.16
+ **/
+GUPnPAVStringDict *
+gupnp_didl_lite_parser_get_string_dict (GUPnPDIDLLiteParser *parser)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser), NULL);
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        return priv->string_dict;
+}
+
+/**
+ * gupnp_didl_lite_parser_feed:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @chunk: (array length=length) (element-type guint8): The next part of the
+ * DIDL-Lite XML document
+ * @length: The length of @chunk in bytes
+ * @error: The location where to store any error, or %NULL
+ *
+ * Feeds the next @length bytes of a DIDL-Lite XML document to @parser, e.g.
+ * as they are read from the network. The ::object-available,
+ * ::item-available and ::container-available signals are emitted for every
+ * object completed by @chunk, regardless of #GUPnPDIDLLiteParser:streaming.
+ *
+ * Call gupnp_didl_lite_parser_finish() once the whole document has been fed.
+ * If feeding fails, the document is abandoned and the next call starts a new
+ * one.
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_parser_feed (GUPnPDIDLLiteParser *parser,
+                             const char          *chunk,
+                             gsize                length,
+                             GError             **error)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser), FALSE);
+        g_return_val_if_fail (chunk != NULL || length == 0, FALSE);
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        if (priv->push_context == NULL) {
+                ParseContext context = { parser, FALSE, NULL, NULL, NULL,
+                                         priv->compiled_filter, 0,
+                                         priv->string_dict };
+
+                priv->push_context = stream_context_new (&context);
+        }
+
+        if (stream_context_feed (priv->push_context, chunk, length))
+                return TRUE;
+
+        return stream_context_finish (g_steal_pointer (&priv->push_context),
+                                      NULL,
+                                      0,
+                                      error);
+}
+
+/**
+ * gupnp_didl_lite_parser_finish:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @error: The location where to store any error, or %NULL
+ *
+ * Completes the document fed to @parser with gupnp_didl_lite_parser_feed(),
+ * emitting the signals for any objects still pending.
+ *
+ * Return value: %TRUE if the complete document was parsed successfully.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_parser_finish (GUPnPDIDLLiteParser *parser,
+                               GError             **error)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+        StreamContext *context;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser), FALSE);
+
+        priv = gupnp_didl_lite_parser_get_instance_private (parser);
+
+        context = g_steal_pointer (&priv->push_context);
+        if (context == NULL) {
+                ParseContext parse = { parser, FALSE, NULL, NULL, NULL,
+                                       priv->compiled_filter, 0,
+                                       priv->string_dict };
+
+                context = stream_context_new (&parse);
+        }
+
+        return stream_context_finish (context, NULL, 0, error);
+}
+
+/* What the text of the current element is collected for in a scan */
+typedef enum {
+        SCAN_FIELD_NONE,
+        SCAN_FIELD_CLASS,
+        SCAN_FIELD_UPDATE_ID,
+        SCAN_FIELD_CONTAINER_UPDATE_ID
+} ScanField;
+
+typedef struct {
+        GUPnPDIDLLiteScanResult *result;
+
+        /* Object currently being scanned, if in_object is set */
+        GUPnPDIDLLiteScanEntry   entry;
+        gboolean                 in_object;
+
+        /* Element depth, the root being 1 */
+        guint                    depth;
+        gboolean                 had_root;
+        gboolean                 wrong_root;
+        gboolean                 had_children;
+
+        ScanField                field;
+        GString                 *text;
+} ScanContext;
+
+/* Returns the character that the reference @name of @length bytes stands
+ * for, or 0 if it is neither a character reference nor a reference to a
+ * predefined entity. @name does not include the '&' and the ';'. */
+static gunichar
+scan_decode_reference (const char *name,
+                       gsize       length)
+{
+        static const struct {
+                const char *name;
+                gunichar    c;
+        } predefined[] = {
+                { "lt", '<' },
+                { "gt", '>' },
+                { "amp", '&' },
+                { "apos", '\'' },
+                { "quot", '"' },
+        };
+        gunichar c = 0;
+        guint base = 10;
+        gsize i;
+
+        if (length == 0)
+                return 0;
+
+        if (name[0] != '#') {
+                for (i = 0; i < G_N_ELEMENTS (predefined); i++)
+                        if (strlen (predefined[i].name) == length &&
+                            strncmp (predefined[i].name, name, length) == 0)
+                                return predefined[i].c;
+
+                return 0;
+        }
+
+        i = 1;
+        if (i < length && name[i] == 'x') {
+                base = 16;
+                i++;
+        }
+
+        if (i == length)
+                return 0;
+
+        for (; i < length; i++) {
+                int digit = base == 16 ? g_ascii_xdigit_value (name[i])
+                                       : g_ascii_digit_value (name[i]);
+
+                if (digit < 0)
+                        return 0;
+
+                c = c * base + digit;
+                if (c > 0x10FFFF)
+                        return 0;
+        }
+
+        return g_unichar_validate (c) ? c : 0;
+}
+
+/* Appends the attribute @value of @length bytes to @text. libxml2 leaves
+ * character references and references to the predefined entities in
+ * attribute values unless it substitutes entities, so those are replaced
+ * here; any other reference is kept as it is */
+static void
+scan_append_attribute_value (GString    *text,
+                             const char *value,
+                             gsize       length)
+{
+        const char *end = value + length;
+
+        while (value < end) {
+                const char *amp;
+                const char *semicolon;
+                gunichar c = 0;
+
+                amp = memchr (value, '&', end - value);
+                if (amp == NULL) {
+                        g_string_append_len (text, value, end - value);
+
+                        break;
+                }
+
+                g_string_append_len (text, value, amp - value);
+
+                semicolon = memchr (amp, ';', end - amp);
+                if (semicolon != NULL)
+                        c = scan_decode_reference (amp + 1,
+                                                   semicolon - amp - 1);
+
+                if (c == 0) {
+                        g_string_append_c (text, '&');
+                        value = amp + 1;
+                } else {
+                        g_string_append_unichar (text, c);
+                        value = semicolon + 1;
+                }
+        }
+}
+
+/* Stores the value of attribute @name of the element started with
+ * @attributes, if present, in the scan result */
+static const char *
+scan_get_attribute (ScanContext    *context,
+                    int             n_attributes,
+                    const xmlChar **attributes,
+                    const char     *name,
+                    gboolean        shared)
+{
+        int i;
+
+        /* libxml2 hands out five pointers per attribute: local name,
+         * prefix, URI, value and end of value */
+        for (i = 0; i < n_attributes; i++) {
+                const xmlChar **attribute = attributes + 5 * i;
+
+                if (attribute[1] != NULL ||
+                    strcmp ((const char *) attribute[0], name) != 0)
+                        continue;
+
+                g_string_truncate (context->text, 0);
+                scan_append_attribute_value (context->text,
+                                             (const char *) attribute[3],
+                                             attribute[4] - attribute[3]);
+
+                if (shared)
+                        return gupnp_didl_lite_scan_result_insert_const
+                                                (context->result,
+                                                 context->text->str);
+
+                return gupnp_didl_lite_scan_result_insert
+                                                (context->result,
+                                                 context->text->str,
+                                                 context->text->len);
+        }
+
+        return NULL;
+}
+
+static void
+scan_start_element_ns (void           *ctx,
+                       const xmlChar  *localname,
+                       const xmlChar  *prefix,
+                       const xmlChar  *uri,
+                       int             nb_namespaces,
+                       const xmlChar **namespaces,
+                       int             nb_attributes,
+                       int             nb_defaulted,
+                       const xmlChar **attributes)
+{
+        xmlParserCtxt *ctxt = (xmlParserCtxt *) ctx;
+        ScanContext   *context = (ScanContext *) ctxt->_private;
+        const char    *name = (const char *) localname;
+
+        context->depth++;
+
+        switch (context->depth) {
+        case 1:
+                context->had_root = TRUE;
+                if (g_ascii_strcasecmp (name, "DIDL-Lite") != 0) {
+                        context->wrong_root = TRUE;
+                        xmlStopParser (ctxt);
+                }
+
+                break;
+        case 2:
+                context->had_children = TRUE;
+                context->in_object =
+                        g_ascii_strcasecmp (name, "item") == 0 ||
+                        g_ascii_strcasecmp (name, "container") == 0;
+                if (!context->in_object)
+                        break;
+
+                memset (&context->entry, 0, sizeof (GUPnPDIDLLiteScanEntry));
+                context->entry.is_container =
+                        g_ascii_strcasecmp (name, "container") == 0;
+                context->entry.id = scan_get_attribute (context,
+                                                        nb_attributes,
+                                                        attributes,
+                                                        "id",
+                                                        FALSE);
+                /* Siblings mostly share their parent */
+                context->entry.parent_id = scan_get_attribute (context,
+                                                               nb_attributes,
+                                                               attributes,
+                                                               "parentID",
+                                                               TRUE);
+
+                break;
+        case 3:
+                if (!context->in_object)
+                        break;
+
+                context->field = SCAN_FIELD_NONE;
+                if (g_ascii_strcasecmp (name, "class") == 0)
+                        context->field = SCAN_FIELD_CLASS;
+                else if (g_ascii_strcasecmp (name, "objectUpdateID") == 0)
+                        context->field = SCAN_FIELD_UPDATE_ID;
+                else if (g_ascii_strcasecmp (name, "containerUpdateID") == 0)
+                        context->field = SCAN_FIELD_CONTAINER_UPDATE_ID;
+
+                g_string_truncate (context->text, 0);
+
+                break;
+        default:
+                break;
+        }
+}
+
+/* Stores the text collected for the property that just ended */
+static void
+scan_end_field (ScanContext *context)
+{
+        GUPnPDIDLLiteScanEntry *entry = &context->entry;
+        guint                   value;
+
+        switch (context->field) {
+        case SCAN_FIELD_CLASS:
+                /* Like the object API, only the first one counts */
+                if (entry->upnp_class == NULL)
+                        entry->upnp_class =
+                                gupnp_didl_lite_scan_result_insert_const
+                                                (context->result,
+                                                 context->text->str);
+
+                break;
+        case SCAN_FIELD_UPDATE_ID:
+                value = strtoul (context->text->str, NULL, 0);
+                if (!entry->update_id_set) {
+                        entry->update_id_set = TRUE;
+                        entry->update_id = value;
+                }
+
+                break;
+        case SCAN_FIELD_CONTAINER_UPDATE_ID:
+                value = strtoul (context->text->str, NULL, 0);
+                if (!entry->container_update_id_set) {
+                        entry->container_update_id_set = TRUE;
+                        entry->container_update_id = value;
+                }
+
+                break;
+        case SCAN_FIELD_NONE:
+        default:
+                break;
+        }
+
+        context->field = SCAN_FIELD_NONE;
+}
+
+static void
+scan_end_element_ns (void          *ctx,
+                     const xmlChar *localname,
+                     const xmlChar *prefix,
+                     const xmlChar *uri)
+{
+        xmlParserCtxt *ctxt = (xmlParserCtxt *) ctx;
+        ScanContext   *context = (ScanContext *) ctxt->_private;
+
+        if (context->depth == 3 && context->in_object)
+                scan_end_field (context);
+        else if (context->depth == 2 && context->in_object) {
+                gupnp_didl_lite_scan_result_append (context->result,
+                                                    &context->entry);
+                context->in_object = FALSE;
+        }
+
+        context->depth--;
+}
+
+static void
+scan_characters (void          *ctx,
+                 const xmlChar *ch,
+                 int            len)
+{
+        xmlParserCtxt *ctxt = (xmlParserCtxt *) ctx;
+        ScanContext   *context = (ScanContext *) ctxt->_private;
+
+        /* Only the text directly inside the property is of interest */
+        if (context->depth == 3 && context->field != SCAN_FIELD_NONE)
+                g_string_append_len (context->text, (const char *) ch, len);
+}
+
+/**
+ * gupnp_didl_lite_parser_scan_bytes:
+ * @parser: A #GUPnPDIDLLiteParser
+ * @didl: The DIDL-Lite XML document to be scanned
+ * @error: The location where to store any error, or %NULL
+ *
+ * Scans the DIDL-Lite XML document in @didl for the ID, parent ID, class
+ * and update IDs of its top-level items and containers, as needed to keep a
+ * local copy of a ContentDirectory in sync. Neither objects nor a document
+ * tree are created, which makes this a lot cheaper than a parse for large
+ * Browse results. No signals are emitted, and #GUPnPDIDLLiteParser:filter
+ * and #GUPnPDIDLLiteParser:string-dict are not used.
+ *
+ * Returns: (transfer full): The entries found, or %NULL on error.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteScanResult *
+gupnp_didl_lite_parser_scan_bytes (GUPnPDIDLLiteParser *parser,
+                                   GBytes              *didl,
+                                   GError             **error)
+{
+        ScanContext    context = { NULL, };
+        xmlSAXHandler  sax;
+        xmlParserCtxt *ctxt;
+        const char    *data;
+        gsize          length;
+        gsize          offset;
+        GMarkupError   code = G_MARKUP_ERROR_PARSE;
+        const char    *message = NULL;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (parser), NULL);
+        g_return_val_if_fail (didl != NULL, NULL);
+
+        /* Only the handlers needed here, so that no tree is built */
+        memset (&sax, 0, sizeof (xmlSAXHandler));
+        sax.initialized = XML_SAX2_MAGIC;
+        sax.startElementNs = scan_start_element_ns;
+        sax.endElementNs = scan_end_element_ns;
+        sax.characters = scan_characters;
+        sax.cdataBlock = scan_characters;
+
+        ctxt = xmlCreatePushParserCtxt (&sax, NULL, NULL, 0, NULL);
+        if (ctxt == NULL) {
+                g_set_error_literal (error,
+                                     G_MARKUP_ERROR,
+                                     G_MARKUP_ERROR_PARSE,
+                                     "Could not parse DIDL-Lite XML");
+
+                return NULL;
+        }
+
+        xmlCtxtUseOptions (ctxt, XML_PARSE_NONET | XML_PARSE_RECOVER);
+
+        g_bytes_ref (didl);
+        data = g_bytes_get_data (didl, &length);
+
+        context.result = gupnp_didl_lite_scan_result_new ();
+        context.text = g_string_new (NULL);
+        ctxt->_private = &context;
+
+        for (offset = 0; offset < length; offset += STREAM_CHUNK_SIZE) {
+                int size = (int) MIN (length - offset, STREAM_CHUNK_SIZE);
+
+                if (ctxt->disableSAX)
+                        break;
+
+                xmlParseChunk (ctxt, data + offset, size, 0);
+        }
+        xmlParseChunk (ctxt, NULL, 0, 1);
+
+        /* Keep what was found of an object cut short by a broken document,
+         * the way the tree parser recovers it */
+        if (context.in_object) {
+                if (context.depth >= 3)
+                        scan_end_field (&context);
+                gupnp_didl_lite_scan_result_append (context.result,
+                                                    &context.entry);
+        }
+
+        if (!context.had_root)
+                message = "Could not parse DIDL-Lite XML";
+        else if (context.wrong_root)
+                message = "No 'DIDL-Lite' node in the DIDL-Lite XML";
+        else if (!context.had_children) {
+                code = G_MARKUP_ERROR_EMPTY;
+                message = "Empty 'DIDL-Lite' node in the DIDL-Lite XML";
+        }
+
+        if (message != NULL) {
+                set_didl_error (error,
+                                code,
+                                message,
+                                data,
+                                length,
+                                &ctxt->lastError);
+                g_clear_pointer (&context.result,
+                                 gupnp_didl_lite_scan_result_unref);
+        }
+
+        g_string_free (context.text, TRUE);
+        xmlFreeParserCtxt (ctxt);
+        g_bytes_unref (didl);
+
+        return context.result;
+}
+
+static void
+create_namespaces (xmlDoc *doc,
+                   xmlNs **upnp_ns,
+                   xmlNs **dc_ns,
+                   xmlNs **dlna_ns,
+                   xmlNs **pv_ns)
+{
+        GUPnPAVXMLNamespaces namespaces = { { NULL, } };
+
+        /* Create namespaces if they don't exist */
+        av_xml_util_ensure_namespaces (doc, &namespaces);
+
+        *upnp_ns = namespaces.ns[GUPNP_XML_NAMESPACE_UPNP];
+        *dc_ns = namespaces.ns[GUPNP_XML_NAMESPACE_DC];
+        *dlna_ns = namespaces.ns[GUPNP_XML_NAMESPACE_DLNA];
+        *pv_ns = namespaces.ns[GUPNP_XML_NAMESPACE_PV];
+}
+
+/* Whether the element @prefix:@name below @parent survives the filter */
+static gboolean
+filter_is_element_allowed (xmlParserCtxt       *ctxt,
+                           GUPnPDIDLLiteFilter *filter,
+                           xmlNode             *parent,
+                           const char          *prefix,
+                           const char          *name)
+{
+        const char *parent_name = (const char *) parent->name;
+
+        /* Only properties are filtered, not the objects themselves */
+        if (parent->parent == (xmlNode *) ctxt->myDoc)
+                return TRUE;
+
+        if (strcmp (parent_name, "container") == 0) {
+                if (strcmp (name, "item") == 0 ||
+                    strcmp (name, "container") == 0)
+                        return TRUE;
+
+                if (g_strcmp0 (prefix, "upnp") == 0 &&
+                    strcmp (name, "storageUsed") == 0) {
+                        const char *upnp_class;
+
+                        /* The class might only follow, keep the storage
+                         * usage until filter_end_container() knows better */
+                        upnp_class = av_xml_util_get_child_element_content
+                                        (parent, "class");
+                        if (upnp_class == NULL ||
+                            filter_util_is_container_standard_prop (name,
+                                                                    prefix,
+                                                                    upnp_class))
+                                return TRUE;
+                }
+        }
+
+        return filter_util_is_standard_prop (name, prefix, parent_name) ||
+               gupnp_didl_lite_filter_is_node_allowed (filter, prefix, name);
+}
+
+/* The filter handlers below drop the parts of each object excluded by the
+ * filter while they are read, so they never make it into the tree */
+static void
+filter_start_element_ns (void           *ctx,
+                         const xmlChar  *localname,
+                         const xmlChar  *prefix,
+                         const xmlChar  *uri,
+                         int             nb_namespaces,
+                         const xmlChar **namespaces,
+                         int             nb_attributes,
+                         int             nb_defaulted,
+                         const xmlChar **attributes)
+{
+        xmlParserCtxt  *ctxt = (xmlParserCtxt *) ctx;
+        ParseContext   *context = (ParseContext *) ctxt->_private;
+        xmlNode        *parent = ctxt->node;
+        const xmlChar  *stack_attributes[5 * FILTER_STACK_ATTRIBUTES];
+        const xmlChar **kept = stack_attributes;
+        int             nb_kept = 0;
+        int             nb_kept_defaulted = 0;
+        int             i;
+
+        if (context->skip_depth > 0) {
+                context->skip_depth++;
+
+                return;
+        }
+
+        /* The root element is left alone */
+        if (parent == NULL) {
+                xmlSAX2StartElementNs (ctx,
+                                       localname,
+                                       prefix,
+                                       uri,
+                                       nb_namespaces,
+                                       namespaces,
+                                       nb_attributes,
+                                       nb_defaulted,
+                                       attributes);
+
+                return;
+        }
+
+        if (!filter_is_element_allowed (ctxt,
+                                        context->filter,
+                                        parent,
+                                        (const char *) prefix,
+                                        (const char *) localname)) {
+                context->skip_depth = 1;
+
+                return;
+        }
+
+        if (nb_attributes > FILTER_STACK_ATTRIBUTES)
+                kept = g_new (const xmlChar *, 5 * nb_attributes);
+
+        /* Attributes come as (localname, prefix, URI, value, end) tuples,
+         * the defaulted ones last */
+        for (i = 0; i < nb_attributes; i++) {
+                const xmlChar **attribute = attributes + 5 * i;
+                const char     *name = (const char *) attribute[0];
+
+                if (!filter_util_is_standard_prop (name,
+                                                   NULL,
+                                                   (const char *) localname) &&
+                    !gupnp_didl_lite_filter_is_attribute_allowed
+                                        (context->filter,
+                                         (const char *) attribute[1],
+                                         name,
+                                         (const char *) prefix,
+                                         (const char *) localname))
+                        continue;
+
+                memcpy (kept + 5 * nb_kept, attribute, 5 * sizeof (xmlChar *));
+                nb_kept++;
+                if (i >= nb_attributes - nb_defaulted)
+                        nb_kept_defaulted++;
+        }
+
+        xmlSAX2StartElementNs (ctx,
+                               localname,
+                               prefix,
+                               uri,
+                               nb_namespaces,
+                               namespaces,
+                               nb_kept,
+                               nb_kept_defaulted,
+                               kept);
+
+        if (kept != stack_attributes)
+                g_free (kept);
+}
+
+/* Returns TRUE if the element being closed has been dropped by the filter */
+static gboolean
+filter_end_skipped (ParseContext *context)
+{
+        if (context->skip_depth == 0)
+                return FALSE;
+
+        context->skip_depth--;
+
+        return TRUE;
+}
+
+/* Drops the storage usage kept by filter_is_element_allowed() from the
+ * container being closed if its class turned out not to allow it, as
+ * gupnp_didl_lite_writer_filter() would */
+static void
+filter_end_container (xmlParserCtxt       *ctxt,
+                      GUPnPDIDLLiteFilter *filter)
+{
+        xmlNode    *node = ctxt->node;
+        xmlNode    *child;
+        xmlNode    *next;
+        const char *upnp_class;
+
+        if (node == NULL ||
+            node->parent == (xmlNode *) ctxt->myDoc ||
+            strcmp ((const char *) node->name, "container") != 0)
+                return;
+
+        upnp_class = av_xml_util_get_child_element_content (node, "class");
+
+        for (child = node->children; child != NULL; child = next) {
+                const char *prefix = NULL;
+
+                next = child->next;
+
+                if (child->type != XML_ELEMENT_NODE ||
+                    strcmp ((const char *) child->name, "storageUsed") != 0)
+                        continue;
+
+                if (child->ns != NULL)
+                        prefix = (const char *) child->ns->prefix;
+
+                if (g_strcmp0 (prefix, "upnp") != 0 ||
+                    filter_util_is_container_standard_prop ("storageUsed",
+                                                            prefix,
+                                                            upnp_class) ||
+                    gupnp_didl_lite_filter_is_node_allowed (filter,
+                                                            prefix,
+                                                            "storageUsed"))
+                        continue;
+
+                xmlUnlinkNode (child);
+                xmlFreeNode (child);
+        }
+}
+
+static void
+filter_end_element_ns (void          *ctx,
+                       const xmlChar *localname,
+                       const xmlChar *prefix,
+                       const xmlChar *uri)
+{
+        xmlParserCtxt *ctxt = (xmlParserCtxt *) ctx;
+        ParseContext  *context = (ParseContext *) ctxt->_private;
+
+        if (filter_end_skipped (context))
+                return;
+
+        filter_end_container (ctxt, context->filter);
+        xmlSAX2EndElementNs (ctx, localname, prefix, uri);
+}
+
+static gboolean
+filter_is_skipping (void *ctx)
+{
+        xmlParserCtxt *ctxt = (xmlParserCtxt *) ctx;
+
+        return ((ParseContext *) ctxt->_private)->skip_depth > 0;
+}
+
+static void
+filter_characters (void          *ctx,
+                   const xmlChar *ch,
+                   int            len)
+{
+        if (!filter_is_skipping (ctx))
+                xmlSAX2Characters (ctx, ch, len);
+}
+
+static void
+filter_cdata_block (void          *ctx,
+                    const xmlChar *value,
+                    int            len)
+{
+        if (!filter_is_skipping (ctx))
+                xmlSAX2CDataBlock (ctx, value, len);
+}
+
+static void
+filter_reference (void          *ctx,
+                  const xmlChar *name)
+{
+        if (!filter_is_skipping (ctx))
+                xmlSAX2Reference (ctx, name);
+}
+
+static void
+filter_comment (void          *ctx,
+                const xmlChar *value)
+{
+        if (!filter_is_skipping (ctx))
+                xmlSAX2Comment (ctx, value);
+}
+
+static void
+filter_processing_instruction (void          *ctx,
+                               const xmlChar *target,
+                               const xmlChar *data)
+{
+        if (!filter_is_skipping (ctx))
+                xmlSAX2ProcessingInstruction (ctx, target, data);
+}
+
+/* Installs the filter handlers, except for the end of elements, which the
+ * caller takes care of */
+static void
+filter_install_handlers (xmlSAXHandler *sax)
+{
+        sax->startElementNs = filter_start_element_ns;
+        sax->characters = filter_characters;
+        sax->ignorableWhitespace = filter_characters;
+        sax->cdataBlock = filter_cdata_block;
+        sax->reference = filter_reference;
+        sax->comment = filter_comment;
+        sax->processingInstruction = filter_processing_instruction;
+}
+
+static gboolean
+parse_didl_tree (ParseContext *context,
+                 const char   *data,
+                 gsize         length,
+                 GError      **error)
+{
+        xmlParserCtxt *ctxt;
+        xmlDoc        *doc = NULL;
+        xmlNode       *element;
+        xmlNs         *upnp_ns = NULL;
+        xmlNs         *dc_ns   = NULL;
+        xmlNs         *dlna_ns = NULL;
+        xmlNs         *pv_ns   = NULL;
+        GUPnPAVXMLDoc *xml_doc = NULL;
+        gboolean       result;
+
+        ctxt = xmlNewParserCtxt ();
+        gupnp_av_string_dict_attach (context->string_dict, ctxt);
+        if (ctxt != NULL && context->filter != NULL) {
+                ctxt->_private = context;
+                filter_install_handlers (ctxt->sax);
+                ctxt->sax->endElementNs = filter_end_element_ns;
+        }
+
+        if (ctxt != NULL && length <= G_MAXINT)
+                doc = xmlCtxtReadMemory (ctxt,
+                                         data,
+                                         (int) length,
+                                         NULL,
+                                         NULL,
+                                         XML_PARSE_NONET | XML_PARSE_RECOVER);
+        if (doc == NULL) {
+                set_didl_error (error,
+                                G_MARKUP_ERROR_PARSE,
+                                "Could not parse DIDL-Lite XML",
+                                data,
+                                length,
+                                ctxt != NULL ? &ctxt->lastError : NULL);
+                g_clear_pointer (&ctxt, xmlFreeParserCtxt);
+
+                return FALSE;
+        }
+
+        /* Get a pointer to root element */
+        element = av_xml_util_get_element ((xmlNode *) doc,
+                                           "DIDL-Lite",
+                                           NULL);
+        if (element == NULL) {
+                set_didl_error (error,
+                                G_MARKUP_ERROR_PARSE,
+                                "No 'DIDL-Lite' node in the DIDL-Lite XML",
+                                data,
+                                length,
+                                &ctxt->lastError);
+                xmlFreeParserCtxt (ctxt);
+                xmlFreeDoc (doc);
+
+                return FALSE;
+        }
+
+        if (element->children == NULL) {
+                set_didl_error (error,
+                                G_MARKUP_ERROR_EMPTY,
+                                "Empty 'DIDL-Lite' node in the DIDL-Lite XML",
+                                data,
+                                length,
+                                &ctxt->lastError);
+                xmlFreeParserCtxt (ctxt);
+                xmlFreeDoc (doc);
+
+                return FALSE;
+        }
+
+        xmlFreeParserCtxt (ctxt);
+
+        create_namespaces (doc, &upnp_ns, &dc_ns, &dlna_ns, &pv_ns);
+
+        xml_doc = av_xml_doc_new (doc);
+
+        result = parse_elements (context,
+                                 element,
+                                 xml_doc,
+                                 upnp_ns,
+                                 dc_ns,
+                                 dlna_ns,
+                                 pv_ns,
+                                 error);
+        av_xml_doc_unref (xml_doc);
+
+        return result;
+}
+
+/* Moves the completed top-level @node into a document of its own and hands
+ * it out */
+static gboolean
+stream_emit_object (StreamContext *context,
+                    xmlNode       *root,
+                    xmlNode       *node)
+{
+        xmlDoc        *doc;
+        xmlNode       *object_root;
+        xmlNs         *upnp_ns = NULL;
+        xmlNs         *dc_ns   = NULL;
+        xmlNs         *dlna_ns = NULL;
+        xmlNs         *pv_ns   = NULL;
+        GUPnPAVXMLDoc *xml_doc;
+        gboolean       result;
+
+        object_root = av_xml_util_move_node_to_new_doc (node, root);
+        doc = object_root->doc;
+
+        create_namespaces (doc, &upnp_ns, &dc_ns, &dlna_ns, &pv_ns);
+
+        xml_doc = av_xml_doc_new (doc);
+        result = parse_elements (&context->parse,
+                                 object_root,
+                                 xml_doc,
+                                 upnp_ns,
+                                 dc_ns,
+                                 dlna_ns,
+                                 pv_ns,
+                                 &context->error);
+        av_xml_doc_unref (xml_doc);
+
+        return result;
+}
+
+static void
+stream_end_element_ns (void          *ctx,
+                       const xmlChar *localname,
+                       const xmlChar *prefix,
+                       const xmlChar *uri)
+{
+        xmlParserCtxt *ctxt = (xmlParserCtxt *) ctx;
+        StreamContext *context = (StreamContext *) ctxt->_private;
+        xmlNode       *node;
+        xmlNode       *root;
+
+        if (filter_end_skipped (&context->parse))
+                return;
+
+        if (context->parse.filter != NULL)
+                filter_end_container (ctxt, context->parse.filter);
+
+        node = ctxt->node;
+        xmlSAX2EndElementNs (ctx, localname, prefix, uri);
+
+        /* Only direct children of the root element are of interest here */
+        if (node == NULL ||
+            node->parent == NULL ||
+            node->parent->type != XML_ELEMENT_NODE ||
+            node->parent->parent != (xmlNode *) ctxt->myDoc)
+                return;
+
+        root = node->parent;
+        if (g_ascii_strcasecmp ((const char *) root->name, "DIDL-Lite") != 0) {
+                /* Reported as missing 'DIDL-Lite' node once we are done */
+                xmlStopParser (ctxt);
+
+                return;
+        }
+
+        if ((g_ascii_strcasecmp ((const char *) node->name, "item") == 0 ||
+             g_ascii_strcasecmp ((const char *) node->name,
+                                 "container") == 0) &&
+            !stream_emit_object (context, root, node))
+                xmlStopParser (ctxt);
+
+        /* Whatever is left below the root has been dealt with. Dropping it
+         * right away keeps memory bounded and makes sure the SAX tree
+         * builder never coalesces text into a node we already released */
+        context->had_children = TRUE;
+        while (root->children != NULL) {
+                xmlNode *child = root->children;
+
+                xmlUnlinkNode (child);
+                xmlFreeNode (child);
+        }
+}
+
+static StreamContext *
+stream_context_new (const ParseContext *parse)
+{
+        StreamContext *context;
+        xmlSAXHandler  sax;
+
+        context = g_new0 (StreamContext, 1);
+        context->parse = *parse;
+        if (parse->filter != NULL)
+                context->parse.filter =
+                        gupnp_didl_lite_filter_ref (parse->filter);
+
+        memset (&sax, 0, sizeof (xmlSAXHandler));
+        xmlSAXVersion (&sax, 2);
+        if (context->parse.filter != NULL)
+                filter_install_handlers (&sax);
+        sax.endElementNs = stream_end_element_ns;
+
+        context->ctxt = xmlCreatePushParserCtxt (&sax, NULL, NULL, 0, NULL);
+        if (context->ctxt != NULL) {
+                gupnp_av_string_dict_attach (context->parse.string_dict,
+                                             context->ctxt);
+                context->ctxt->_private = context;
+                xmlCtxtUseOptions (context->ctxt,
+                                   XML_PARSE_NONET | XML_PARSE_RECOVER);
+        }
+
+        return context;
+}
+
+static void
+stream_context_free (StreamContext *context)
+{
+        if (context->ctxt != NULL) {
+                g_clear_pointer (&context->ctxt->myDoc, xmlFreeDoc);
+                xmlFreeParserCtxt (context->ctxt);
+        }
+
+        g_clear_error (&context->error);
+        g_clear_pointer (&context->parse.filter,
+                         gupnp_didl_lite_filter_unref);
+        g_free (context);
+}
+
+static gboolean
+stream_context_is_stopped (StreamContext *context)
+{
+        return context->ctxt == NULL ||
+               context->ctxt->disableSAX ||
+               context->error != NULL;
+}
+
+static gboolean
+stream_context_feed (StreamContext *context,
+                     const char    *data,
+                     gsize          length)
+{
+        gsize offset;
+
+        /* Feed the input in slices so the push parser never holds a full
+         * copy of it */
+        for (offset = 0; offset < length; offset += STREAM_CHUNK_SIZE) {
+                int size = (int) MIN (length - offset, STREAM_CHUNK_SIZE);
+
+                if (stream_context_is_stopped (context))
+                        break;
+
+                xmlParseChunk (context->ctxt, data + offset, size, 0);
+        }
+
+        return !stream_context_is_stopped (context);
+}
+
+/* Translates a line/column position reported by libxml2 into a byte offset
+ * into @data */
+static gsize
+get_error_offset (const char *data,
+                  gsize       length,
+                  int         line,
+                  int         column)
+{
+        gsize offset = 0;
+
+        for (; line > 1 && offset < length; offset++)
+                if (data[offset] == '\n')
+                        line--;
+
+        if (column > 1)
+                offset += column - 1;
+
+        return MIN (offset, length);
+}
+
+static void
+set_didl_error (GError         **error,
+                GMarkupError     code,
+                const char      *message,
+                const char      *data,
+                gsize            length,
+                const xmlError  *xml_error)
+{
+        gboolean  has_position;
+        gsize     offset = 0;
+        gsize     start;
+        char     *slice;
+        char     *excerpt;
+
+        has_position = xml_error != NULL &&
+                       xml_error->code != XML_ERR_OK &&
+                       xml_error->line > 0;
+
+        if (has_position && data != NULL)
+                offset = get_error_offset (data,
+                                           length,
+                                           xml_error->line,
+                                           xml_error->int2);
+
+        if (data == NULL) {
+                if (has_position)
+                        g_set_error (error,
+                                     G_MARKUP_ERROR,
+                                     code,
+                                     "%s at line %d, column %d",
+                                     message,
+                                     xml_error->line,
+                                     xml_error->int2);
+                else
+                        g_set_error_literal (error,
+                                             G_MARKUP_ERROR,
+                                             code,
+                                             message);
+
+                return;
+        }
+
+        /* Quote a few bytes around the offending position rather than the
+         * whole, potentially huge, document */
+        start = offset > ERROR_EXCERPT_LENGTH / 2 ?
+                offset - ERROR_EXCERPT_LENGTH / 2 : 0;
+        slice = g_strndup (data + start,
+                           MIN (length - start, ERROR_EXCERPT_LENGTH));
+        excerpt = g_strescape (slice, NULL);
+
+        if (has_position)
+                g_set_error (error,
+                             G_MARKUP_ERROR,
+                             code,
+                             "%s at line %d, column %d (byte %"
+                             G_GSIZE_FORMAT "), near \"%s\"",
+                             message,
+                             xml_error->line,
+                             xml_error->int2,
+                             offset,
+                             excerpt);
+        else
+                g_set_error (error,
+                             G_MARKUP_ERROR,
+                             code,
+                             "%s, near \"%s\"",
+                             message,
+                             excerpt);
+
+        g_free (excerpt);
+        g_free (slice);
+}
+
+/* Terminates the document, checks it and frees @context. @data is the
+ * complete input, if available, for error reporting */
+static gboolean
+stream_context_finish (StreamContext *context,
+                       const char    *data,
+                       gsize          length,
+                       GError       **error)
+{
+        xmlDoc         *doc = NULL;
+        xmlNode        *element;
+        const xmlError *xml_error = NULL;
+        gboolean        result = FALSE;
+
+        if (context->ctxt != NULL) {
+                xmlParseChunk (context->ctxt, NULL, 0, 1);
+
+                doc = context->ctxt->myDoc;
+                context->ctxt->myDoc = NULL;
+                xml_error = &context->ctxt->lastError;
+        }
+
+        if (context->error != NULL) {
+                g_propagate_error (error, g_steal_pointer (&context->error));
+
+                goto out;
+        }
+
+        if (doc == NULL) {
+                set_didl_error (error,
+                                G_MARKUP_ERROR_PARSE,
+                                "Could not parse DIDL-Lite XML",
+                                data,
+                                length,
+                                xml_error);
+
+                goto out;
+        }
+
+        element = av_xml_util_get_element ((xmlNode *) doc,
+                                           "DIDL-Lite",
+                                           NULL);
+        if (element == NULL) {
+                set_didl_error (error,
+                                G_MARKUP_ERROR_PARSE,
+                                "No 'DIDL-Lite' node in the DIDL-Lite XML",
+                                data,
+                                length,
+                                xml_error);
+
+                goto out;
+        }
+
+        if (!context->had_children && element->children == NULL) {
+                set_didl_error (error,
+                                G_MARKUP_ERROR_EMPTY,
+                                "Empty 'DIDL-Lite' node in the DIDL-Lite XML",
+                                data,
+                                length,
+                                xml_error);
+
+                goto out;
+        }
+
+        result = TRUE;
+
+out:
+        g_clear_pointer (&doc, xmlFreeDoc);
+        stream_context_free (context);
+
+        return result;
+}
+
+static gboolean
+parse_didl_streaming (ParseContext *parse,
+                      const char   *data,
+                      gsize         length,
+                      GError      **error)
+{
+        StreamContext *context;
+
+        context = stream_context_new (parse);
+        stream_context_feed (context, data, length);
+
+        return stream_context_finish (context, data, length, error);
+}
+
+static gboolean
+parse_didl_data (ParseContext *context,
+                 const char   *data,
+                 gsize         length,
+                 GError      **error)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_PARSER (context->parser),
+                              FALSE);
+
+        priv = gupnp_didl_lite_parser_get_instance_private (context->parser);
+        context->filter = priv->compiled_filter;
+        context->string_dict = priv->string_dict;
+
+        return parse_didl_run (context, data, length, error);
+}
+
+static gboolean
+parse_didl_run (ParseContext *context,
+                const char   *data,
+                gsize         length,
+                GError      **error)
+{
+        GUPnPDIDLLiteParserPrivate *priv;
+
+        priv = gupnp_didl_lite_parser_get_instance_private (context->parser);
+
+        if (priv->streaming)
+                return parse_didl_streaming (context, data, length, error);
+
+        return parse_didl_tree (context, data, length, error);
+}
+
+/* Interns the values repeating across objects, the class and the protocol
+ * info of the resources */
+static void
+intern_object_strings (xmlNode *node)
+{
+        xmlNode *child;
+
+        for (child = node->children; child != NULL; child = child->next) {
+                if (child->type != XML_ELEMENT_NODE)
+                        continue;
+
+                if (strcmp ((const char *) child->name, "class") == 0)
+                        gupnp_av_string_dict_intern_content (child);
+                else if (strcmp ((const char *) child->name, "res") == 0) {
+                        xmlAttr *attr;
+
+                        attr = xmlHasProp (child, (xmlChar *) "protocolInfo");
+                        if (attr != NULL)
+                                gupnp_av_string_dict_intern_content
+                                                        ((xmlNode *) attr);
+                }
+        }
+}
+
+static gboolean
+verify_item (xmlNode *node,
+             GError **error)
+{
+        if (verify_didl_attributes (node))
+                return TRUE;
+
+        g_set_error (error,
+                     G_MARKUP_ERROR,
+                     G_MARKUP_ERROR_PARSE,
+                     "Could not parse DIDL-Lite XML: invalid item at line %ld",
+                     xmlGetLineNo (node));
+
+        return FALSE;
+}
+
+/* Hands out a handle for @element, and for the objects nested in it if
+ * requested, without creating any GObjects */
+static gboolean
+emit_handle (ParseContext  *context,
+             xmlNode       *element,
+             GUPnPAVXMLDoc *xml_doc,
+             xmlNs         *upnp_ns,
+             xmlNs         *dc_ns,
+             xmlNs         *dlna_ns,
+             xmlNs         *pv_ns,
+             GError       **error)
+{
+        GUPnPDIDLLiteObjectHandle *handle;
+        gboolean                   is_container;
+
+        if (element->type != XML_ELEMENT_NODE)
+                return TRUE;
+
+        is_container = g_ascii_strcasecmp ((const char *) element->name,
+                                           "container") == 0;
+        if (!is_container) {
+                if (g_ascii_strcasecmp ((const char *) element->name,
+                                        "item") != 0)
+                        return TRUE;
+
+                if (!verify_item (element, error))
+                        return FALSE;
+        }
+
+        handle = gupnp_didl_lite_object_handle_new (element,
+                                                    xml_doc,
+                                                    upnp_ns,
+                                                    dc_ns,
+                                                    dlna_ns,
+                                                    pv_ns);
+        context->handle_func (handle, context->user_data);
+        gupnp_didl_lite_object_handle_unref (handle);
+
+        if (is_container && context->recursive)
+                return parse_elements (context,
+                                       element,
+                                       xml_doc,
+                                       upnp_ns,
+                                       dc_ns,
+                                       dlna_ns,
+                                       pv_ns,
+                                       error);
+
+        return TRUE;
+}
+
+static gboolean
+parse_elements (ParseContext  *context,
+                xmlNode       *node,
+                GUPnPAVXMLDoc *xml_doc,
+                xmlNs         *upnp_ns,
+                xmlNs         *dc_ns,
+                xmlNs         *dlna_ns,
+                xmlNs         *pv_ns,
+                GError       **error)
+{
+        GUPnPDIDLLiteParser *parser = context->parser;
+        xmlNode *element;
+
+        for (element = node->children; element; element = element->next) {
+                GUPnPDIDLLiteObject *object;
+
+                if (context->cancellable != NULL &&
+                    g_cancellable_set_error_if_cancelled (context->cancellable,
+                                                          error))
+                        return FALSE;
+
+                if (context->string_dict != NULL &&
+                    element->type == XML_ELEMENT_NODE)
+                        intern_object_strings (element);
+
+                if (context->handle_func != NULL) {
+                        if (!emit_handle (context,
+                                          element,
+                                          xml_doc,
+                                          upnp_ns,
+                                          dc_ns,
+                                          dlna_ns,
+                                          pv_ns,
+                                          error))
+                                return FALSE;
+
+                        continue;
+                }
+
+                object = gupnp_didl_lite_object_new_from_xml (element, xml_doc,
+                                                              upnp_ns, dc_ns,
+                                                              dlna_ns, pv_ns);
+
+                if (object == NULL)
+                        continue;
+
+                if (GUPNP_IS_DIDL_LITE_CONTAINER (object)) {
+                        if (context->func != NULL)
+                                context->func (object, context->user_data);
+                        else
+                                g_signal_emit (parser,
+                                               signals[CONTAINER_AVAILABLE],
+                                               0,
+                                               object);
+
+                        if (context->recursive &&
+                            !parse_elements (context,
+                                             element,
+                                             xml_doc,
+                                             upnp_ns,
+                                             dc_ns,
+                                             dlna_ns,
+                                             pv_ns,
+                                             error)) {
+                                g_object_unref (object);
+
+                                return FALSE;
+                        }
+                } else if (GUPNP_IS_DIDL_LITE_ITEM (object)) {
+                        node = gupnp_didl_lite_object_peek_xml_node (object);
+                        if (!verify_item (node, error)) {
+                                g_object_unref (object);
+
+                                return FALSE;
+                        }
+
+                        if (context->func != NULL)
+                                context->func (object, context->user_data);
+                        else
+                                g_signal_emit (parser,
+                                               signals[ITEM_AVAILABLE],
+                                               0,
+                                               object);
+                }
+
+                if (context->func == NULL)
+                        g_signal_emit (parser,
+                                       signals[OBJECT_AVAILABLE],
+                                       0,
+                                       object);
 
                 g_object_unref (object);
         }
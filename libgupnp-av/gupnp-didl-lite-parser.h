@@ -10,11 +10,44 @@
 #ifndef __GUPNP_DIDL_LITE_PARSER_H__
 #define __GUPNP_DIDL_LITE_PARSER_H__
 
+#include <gio/gio.h>
+
+#include "gupnp-av-string-dict.h"
 #include "gupnp-didl-lite-container.h"
 #include "gupnp-didl-lite-item.h"
+#include "gupnp-didl-lite-object-handle.h"
+#include "gupnp-didl-lite-scan-result.h"
 
 G_BEGIN_DECLS
 
+/**
+ * GUPnPDIDLLiteParserObjectFunc:
+ * @object: The parsed #GUPnPDIDLLiteObject
+ * @user_data: User data
+ *
+ * Callback invoked for every object by
+ * gupnp_didl_lite_parser_parse_didl_foreach(). Take a reference on @object to
+ * keep it around.
+ *
+ * Since: 0.16
+ */
+typedef void (*GUPnPDIDLLiteParserObjectFunc) (GUPnPDIDLLiteObject *object,
+                                               gpointer             user_data);
+
+/**
+ * GUPnPDIDLLiteParserHandleFunc:
+ * @handle: A #GUPnPDIDLLiteObjectHandle for the parsed object
+ * @user_data: User data
+ *
+ * Callback invoked for every object by
+ * gupnp_didl_lite_parser_parse_didl_lazy(). Take a reference on @handle to
+ * keep it around.
+ *
+ * Since: 0.16
+ */
+typedef void (*GUPnPDIDLLiteParserHandleFunc) (GUPnPDIDLLiteObjectHandle *handle,
+                                               gpointer                   user_data);
+
 G_DECLARE_DERIVABLE_TYPE(GUPnPDIDLLiteParser,
                           gupnp_didl_lite_parser,
                           GUPNP,
@@ -51,6 +84,85 @@ gupnp_didl_lite_parser_parse_didl       (GUPnPDIDLLiteParser *parser,
                                          const char          *didl,
                                          GError             **error);
 
+gboolean
+gupnp_didl_lite_parser_parse_didl_foreach
+                                        (GUPnPDIDLLiteParser          *parser,
+                                         const char                   *didl,
+                                         gboolean                      recursive,
+                                         GUPnPDIDLLiteParserObjectFunc func,
+                                         gpointer                      user_data,
+                                         GError                      **error);
+
+gboolean
+gupnp_didl_lite_parser_parse_didl_lazy  (GUPnPDIDLLiteParser          *parser,
+                                         const char                   *didl,
+                                         gboolean                      recursive,
+                                         GUPnPDIDLLiteParserHandleFunc func,
+                                         gpointer                      user_data,
+                                         GError                      **error);
+
+GPtrArray *
+gupnp_didl_lite_parser_parse_didl_as_array
+                                        (GUPnPDIDLLiteParser *parser,
+                                         const char          *didl,
+                                         gboolean             recursive,
+                                         GError             **error);
+
+void
+gupnp_didl_lite_parser_parse_didl_async (GUPnPDIDLLiteParser *parser,
+                                         const char          *didl,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data);
+
+GPtrArray *
+gupnp_didl_lite_parser_parse_didl_finish
+                                        (GUPnPDIDLLiteParser *parser,
+                                         GAsyncResult        *result,
+                                         GError             **error);
+
+gboolean
+gupnp_didl_lite_parser_parse_bytes      (GUPnPDIDLLiteParser *parser,
+                                         GBytes              *didl,
+                                         gboolean             recursive,
+                                         GError             **error);
+
+void
+gupnp_didl_lite_parser_set_streaming    (GUPnPDIDLLiteParser *parser,
+                                         gboolean             streaming);
+
+gboolean
+gupnp_didl_lite_parser_get_streaming    (GUPnPDIDLLiteParser *parser);
+
+void
+gupnp_didl_lite_parser_set_filter       (GUPnPDIDLLiteParser *parser,
+                                         const char          *filter);
+
+const char *
+gupnp_didl_lite_parser_get_filter       (GUPnPDIDLLiteParser *parser);
+
+void
+gupnp_didl_lite_parser_set_string_dict  (GUPnPDIDLLiteParser *parser,
+                                         GUPnPAVStringDict   *dict);
+
+GUPnPAVStringDict *
+gupnp_didl_lite_parser_get_string_dict  (GUPnPDIDLLiteParser *parser);
+
+gboolean
+gupnp_didl_lite_parser_feed             (GUPnPDIDLLiteParser *parser,
+                                         const char          *chunk,
+                                         gsize                length,
+                                         GError             **error);
+
+gboolean
+gupnp_didl_lite_parser_finish           (GUPnPDIDLLiteParser *parser,
+                                         GError             **error);
+
+GUPnPDIDLLiteScanResult *
+gupnp_didl_lite_parser_scan_bytes       (GUPnPDIDLLiteParser *parser,
+                                         GBytes              *didl,
+                                         GError             **error);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DIDL_LITE_PARSER_H__ */
@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_SCAN_RESULT_PRIVATE_H
+#define GUPNP_DIDL_LITE_SCAN_RESULT_PRIVATE_H
+
+#include "gupnp-didl-lite-scan-result.h"
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL GUPnPDIDLLiteScanResult *
+gupnp_didl_lite_scan_result_new         (void);
+
+G_GNUC_INTERNAL const char *
+gupnp_didl_lite_scan_result_insert      (GUPnPDIDLLiteScanResult *result,
+                                         const char              *string,
+                                         gssize                   length);
+
+G_GNUC_INTERNAL const char *
+gupnp_didl_lite_scan_result_insert_const
+                                        (GUPnPDIDLLiteScanResult *result,
+                                         const char              *string);
+
+G_GNUC_INTERNAL void
+gupnp_didl_lite_scan_result_append      (GUPnPDIDLLiteScanResult      *result,
+                                         const GUPnPDIDLLiteScanEntry *entry);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_SCAN_RESULT_PRIVATE_H__ */
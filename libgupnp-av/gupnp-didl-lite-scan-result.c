@@ -0,0 +1,215 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPDIDLLiteScanResult:
+ *
+ * The objects found by a scan of a DIDL-Lite document
+ *
+ * A [struct@GUPnPAV.DIDLLiteScanResult] holds one
+ * [struct@GUPnPAV.DIDLLiteScanEntry] for every top-level item and container
+ * of a document, in document order. It is returned by
+ * gupnp_didl_lite_parser_scan_bytes() and only has the fields needed to keep
+ * a copy of a ContentDirectory in sync, stored in a few large blocks rather
+ * than in a #GUPnPDIDLLiteObject each.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include "gupnp-didl-lite-scan-result.h"
+#include "gupnp-didl-lite-scan-result-private.h"
+
+struct _GUPnPDIDLLiteScanResult {
+        GArray       *entries;
+        GStringChunk *strings;
+
+        /* ID to index + 1, built on the first lookup */
+        GHashTable   *index;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteScanResult,
+                     gupnp_didl_lite_scan_result,
+                     gupnp_didl_lite_scan_result_ref,
+                     gupnp_didl_lite_scan_result_unref)
+
+GUPnPDIDLLiteScanResult *
+gupnp_didl_lite_scan_result_new (void)
+{
+        GUPnPDIDLLiteScanResult *result;
+
+        result = g_atomic_rc_box_new0 (GUPnPDIDLLiteScanResult);
+        result->entries = g_array_new (FALSE,
+                                       FALSE,
+                                       sizeof (GUPnPDIDLLiteScanEntry));
+        result->strings = g_string_chunk_new (4096);
+
+        return result;
+}
+
+/**
+ * gupnp_didl_lite_scan_result_ref:
+ * @result: A [struct@GUPnPAV.DIDLLiteScanResult]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteScanResult].
+ *
+ * Returns: (transfer full): The object passed in @result.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteScanResult *
+gupnp_didl_lite_scan_result_ref (GUPnPDIDLLiteScanResult *result)
+{
+        g_return_val_if_fail (result != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (result);
+}
+
+static void
+scan_result_free (GUPnPDIDLLiteScanResult *result)
+{
+        g_clear_pointer (&result->index, g_hash_table_destroy);
+        g_array_free (result->entries, TRUE);
+        g_string_chunk_free (result->strings);
+}
+
+/**
+ * gupnp_didl_lite_scan_result_unref:
+ * @result: A [struct@GUPnPAV.DIDLLiteScanResult]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteScanResult]. If the
+ * reference count drops to 0, @result is freed, along with all its entries.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_scan_result_unref (GUPnPDIDLLiteScanResult *result)
+{
+        g_return_if_fail (result != NULL);
+
+        g_atomic_rc_box_release_full (result, (GDestroyNotify) scan_result_free);
+}
+
+/**
+ * gupnp_didl_lite_scan_result_get_length:
+ * @result: A [struct@GUPnPAV.DIDLLiteScanResult]
+ *
+ * Get the number of objects found by the scan.
+ *
+ * Returns: The number of entries in @result.
+ *
+ * Since: 0.16
+ **/
+guint
+gupnp_didl_lite_scan_result_get_length (GUPnPDIDLLiteScanResult *result)
+{
+        g_return_val_if_fail (result != NULL, 0);
+
+        return result->entries->len;
+}
+
+/**
+ * gupnp_didl_lite_scan_result_get_entry:
+ * @result: A [struct@GUPnPAV.DIDLLiteScanResult]
+ * @index_: The position of the entry, in document order
+ *
+ * Get the entry for the @index_-th object of the document.
+ *
+ * Returns: (transfer none): The entry, valid as long as @result is.
+ *
+ * Since: 0.16
+ **/
+const GUPnPDIDLLiteScanEntry *
+gupnp_didl_lite_scan_result_get_entry (GUPnPDIDLLiteScanResult *result,
+                                       guint                    index_)
+{
+        g_return_val_if_fail (result != NULL, NULL);
+        g_return_val_if_fail (index_ < result->entries->len, NULL);
+
+        return &g_array_index (result->entries,
+                               GUPnPDIDLLiteScanEntry,
+                               index_);
+}
+
+/**
+ * gupnp_didl_lite_scan_result_lookup:
+ * @result: A [struct@GUPnPAV.DIDLLiteScanResult]
+ * @id: The ID of the object to look for
+ *
+ * Look up the entry of the object with ID @id. If the document had several
+ * objects with that ID, the first one is returned.
+ *
+ * The first call builds an index of @result, so later ones take constant
+ * time.
+ *
+ * Returns: (transfer none) (nullable): The entry, or %NULL if @result has no
+ * object @id.
+ *
+ * Since: 0.16
+ **/
+const GUPnPDIDLLiteScanEntry *
+gupnp_didl_lite_scan_result_lookup (GUPnPDIDLLiteScanResult *result,
+                                    const char              *id)
+{
+        guint position;
+
+        g_return_val_if_fail (result != NULL, NULL);
+        g_return_val_if_fail (id != NULL, NULL);
+
+        if (result->index == NULL) {
+                guint i;
+
+                result->index = g_hash_table_new (g_str_hash, g_str_equal);
+                for (i = 0; i < result->entries->len; i++) {
+                        GUPnPDIDLLiteScanEntry *entry;
+
+                        entry = &g_array_index (result->entries,
+                                                GUPnPDIDLLiteScanEntry,
+                                                i);
+                        if (entry->id != NULL &&
+                            !g_hash_table_contains (result->index, entry->id))
+                                g_hash_table_insert (result->index,
+                                                     (gpointer) entry->id,
+                                                     GUINT_TO_POINTER (i + 1));
+                }
+        }
+
+        position = GPOINTER_TO_UINT (g_hash_table_lookup (result->index, id));
+        if (position == 0)
+                return NULL;
+
+        return &g_array_index (result->entries,
+                               GUPnPDIDLLiteScanEntry,
+                               position - 1);
+}
+
+/* Copies @length bytes of @string, or all of it if @length is -1, into
+ * @result */
+const char *
+gupnp_didl_lite_scan_result_insert (GUPnPDIDLLiteScanResult *result,
+                                    const char              *string,
+                                    gssize                   length)
+{
+        return g_string_chunk_insert_len (result->strings, string, length);
+}
+
+/* Like gupnp_didl_lite_scan_result_insert(), but stores every distinct
+ * string only once */
+const char *
+gupnp_didl_lite_scan_result_insert_const (GUPnPDIDLLiteScanResult *result,
+                                          const char              *string)
+{
+        return g_string_chunk_insert_const (result->strings, string);
+}
+
+/* Adds a copy of @entry, whose strings must belong to @result */
+void
+gupnp_didl_lite_scan_result_append (GUPnPDIDLLiteScanResult      *result,
+                                    const GUPnPDIDLLiteScanEntry *entry)
+{
+        g_array_append_vals (result->entries, entry, 1);
+        g_clear_pointer (&result->index, g_hash_table_destroy);
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_SCAN_RESULT_H
+#define GUPNP_DIDL_LITE_SCAN_RESULT_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GUPnPDIDLLiteScanEntry:
+ * @id: The ID of the object, or %NULL if it has none
+ * @parent_id: The ID of the parent of the object, or %NULL
+ * @upnp_class: The UPnP class of the object, or %NULL
+ * @is_container: %TRUE for a container, %FALSE for an item
+ * @update_id_set: Whether the object carries an `upnp:objectUpdateID`
+ * @update_id: The value of `upnp:objectUpdateID`, 0 if not set
+ * @container_update_id_set: Whether the object carries an
+ * `upnp:containerUpdateID`
+ * @container_update_id: The value of `upnp:containerUpdateID`, 0 if not set
+ *
+ * The fields of a single object found by
+ * gupnp_didl_lite_parser_scan_bytes(). The strings are owned by the
+ * [struct@GUPnPAV.DIDLLiteScanResult] the entry belongs to.
+ *
+ * Since: 0.16
+ */
+typedef struct {
+        const char *id;
+        const char *parent_id;
+        const char *upnp_class;
+        gboolean    is_container;
+        gboolean    update_id_set;
+        guint       update_id;
+        gboolean    container_update_id_set;
+        guint       container_update_id;
+} GUPnPDIDLLiteScanEntry;
+
+GType
+gupnp_didl_lite_scan_result_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_SCAN_RESULT \
+                (gupnp_didl_lite_scan_result_get_type ())
+
+typedef struct _GUPnPDIDLLiteScanResult GUPnPDIDLLiteScanResult;
+
+GUPnPDIDLLiteScanResult *
+gupnp_didl_lite_scan_result_ref         (GUPnPDIDLLiteScanResult *result);
+
+void
+gupnp_didl_lite_scan_result_unref       (GUPnPDIDLLiteScanResult *result);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteScanResult,
+                               gupnp_didl_lite_scan_result_unref)
+
+guint
+gupnp_didl_lite_scan_result_get_length  (GUPnPDIDLLiteScanResult *result);
+
+const GUPnPDIDLLiteScanEntry *
+gupnp_didl_lite_scan_result_get_entry   (GUPnPDIDLLiteScanResult *result,
+                                         guint                    index_);
+
+const GUPnPDIDLLiteScanEntry *
+gupnp_didl_lite_scan_result_lookup      (GUPnPDIDLLiteScanResult *result,
+                                         const char              *id);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_SCAN_RESULT_H__ */
@@ -0,0 +1,812 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPDIDLLiteSnapshot:
+ *
+ * An immutable copy of the most common parts of a DIDL-Lite object
+ *
+ * A #GUPnPDIDLLiteObject keeps the whole document it was parsed from alive.
+ * A [struct@GUPnPAV.DIDLLiteSnapshot] instead copies the fields of
+ * [struct@GUPnPAV.DIDLLiteFields], the contributors and the resources of an
+ * object into a single block of memory, so caching a few objects of a large
+ * Browse result does not keep the entire result around. Reading from a
+ * snapshot does not touch any XML.
+ *
+ * Other properties of the object are not kept. Use
+ * gupnp_didl_lite_snapshot_to_object() to turn a snapshot back into an
+ * object, e.g. to serialize it.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "gupnp-didl-lite-snapshot.h"
+#include "xml-util.h"
+
+struct _GUPnPDIDLLiteSnapshot {
+        GUPnPDIDLLiteFields               fields;
+        gboolean                          is_container;
+        gboolean                          restricted;
+
+        guint                             n_contributors;
+        GUPnPDIDLLiteSnapshotContributor *contributors;
+        guint                             n_resources;
+        GUPnPDIDLLiteSnapshotResource    *resources;
+
+        /* The contributors, the resources and then all the strings
+         * follow in the same allocation, unless the strings point into
+         * this variant */
+        GVariant                         *variant;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPDIDLLiteSnapshot,
+                     gupnp_didl_lite_snapshot,
+                     gupnp_didl_lite_snapshot_ref,
+                     gupnp_didl_lite_snapshot_unref)
+
+#define ALIGN_SIZE(size) (((size) + 7) & ~((gsize) 7))
+
+/* Copies strings into the space after the arrays of a snapshot. Without a
+ * position, it only adds up the space needed. */
+typedef struct {
+        char  *position;
+        gsize  size;
+} Arena;
+
+static const char *
+arena_add (Arena      *arena,
+           const char *string)
+{
+        const char *ret;
+        gsize length;
+
+        if (string == NULL)
+                return NULL;
+
+        length = strlen (string) + 1;
+        if (arena->position == NULL) {
+                arena->size += length;
+
+                return NULL;
+        }
+
+        memcpy (arena->position, string, length);
+        ret = arena->position;
+        arena->position += length;
+
+        return ret;
+}
+
+/* Allocates a snapshot with room for the given number of contributors and
+ * resources, followed by @strings_size bytes starting at @strings */
+static GUPnPDIDLLiteSnapshot *
+snapshot_alloc (guint   n_contributors,
+                guint   n_resources,
+                gsize   strings_size,
+                char  **strings)
+{
+        GUPnPDIDLLiteSnapshot *snapshot;
+        gsize contributors_offset;
+        gsize resources_offset;
+        gsize strings_offset;
+
+        contributors_offset = ALIGN_SIZE (sizeof (GUPnPDIDLLiteSnapshot));
+        resources_offset = ALIGN_SIZE
+                (contributors_offset +
+                 n_contributors * sizeof (GUPnPDIDLLiteSnapshotContributor));
+        strings_offset =
+                resources_offset +
+                n_resources * sizeof (GUPnPDIDLLiteSnapshotResource);
+
+        snapshot = g_atomic_rc_box_alloc0 (strings_offset + strings_size);
+        snapshot->n_contributors = n_contributors;
+        snapshot->contributors = (GUPnPDIDLLiteSnapshotContributor *)
+                                 ((char *) snapshot + contributors_offset);
+        snapshot->n_resources = n_resources;
+        snapshot->resources = (GUPnPDIDLLiteSnapshotResource *)
+                              ((char *) snapshot + resources_offset);
+
+        if (strings != NULL)
+                *strings = (char *) snapshot + strings_offset;
+
+        return snapshot;
+}
+
+typedef struct {
+        const char               *element;
+        GUPnPDIDLLiteContributor *contributor;
+} Contributor;
+
+static void
+collect_contributors (GArray     *contributors,
+                      const char *element,
+                      GList      *list)
+{
+        GList *l;
+
+        for (l = list; l != NULL; l = l->next) {
+                Contributor contributor = { element, l->data };
+
+                g_array_append_val (contributors, contributor);
+        }
+
+        g_list_free (list);
+}
+
+static void
+fill_snapshot (GUPnPDIDLLiteSnapshot     *snapshot,
+               Arena                     *arena,
+               const GUPnPDIDLLiteFields *fields,
+               GArray                    *contributors,
+               GPtrArray                 *resources)
+{
+        guint i;
+
+        snapshot->fields = *fields;
+        snapshot->fields.id = arena_add (arena, fields->id);
+        snapshot->fields.parent_id = arena_add (arena, fields->parent_id);
+        snapshot->fields.upnp_class = arena_add (arena, fields->upnp_class);
+        snapshot->fields.title = arena_add (arena, fields->title);
+        snapshot->fields.creator = arena_add (arena, fields->creator);
+        snapshot->fields.artist = arena_add (arena, fields->artist);
+        snapshot->fields.album = arena_add (arena, fields->album);
+        snapshot->fields.album_art = arena_add (arena, fields->album_art);
+        snapshot->fields.genre = arena_add (arena, fields->genre);
+        snapshot->fields.date = arena_add (arena, fields->date);
+        snapshot->fields.description = arena_add (arena,
+                                                  fields->description);
+
+        for (i = 0; i < contributors->len; i++) {
+                GUPnPDIDLLiteSnapshotContributor *dest;
+                Contributor *src;
+
+                src = &g_array_index (contributors, Contributor, i);
+                dest = &snapshot->contributors[i];
+
+                /* The element names are static */
+                dest->element = src->element;
+                dest->name = arena_add
+                                (arena,
+                                 gupnp_didl_lite_contributor_get_name
+                                                        (src->contributor));
+                dest->role = arena_add
+                                (arena,
+                                 gupnp_didl_lite_contributor_get_role
+                                                        (src->contributor));
+        }
+
+        for (i = 0; i < resources->len; i++) {
+                GUPnPDIDLLiteSnapshotResource *dest;
+                GUPnPDIDLLiteResource *src;
+                xmlNode *node;
+
+                src = g_ptr_array_index (resources, i);
+                dest = &snapshot->resources[i];
+                node = gupnp_didl_lite_resource_get_xml_node (src);
+
+                dest->uri = arena_add (arena,
+                                       gupnp_didl_lite_resource_get_uri (src));
+                dest->import_uri = arena_add
+                                (arena,
+                                 gupnp_didl_lite_resource_get_import_uri (src));
+                dest->protocol_info = arena_add
+                                (arena,
+                                 av_xml_util_get_attribute_content
+                                                        (node,
+                                                         "protocolInfo"));
+                dest->protection = arena_add
+                                (arena,
+                                 gupnp_didl_lite_resource_get_protection (src));
+                dest->size = gupnp_didl_lite_resource_get_size64 (src);
+                dest->duration = gupnp_didl_lite_resource_get_duration (src);
+                dest->bitrate = gupnp_didl_lite_resource_get_bitrate (src);
+                dest->sample_freq =
+                        gupnp_didl_lite_resource_get_sample_freq (src);
+                dest->bits_per_sample =
+                        gupnp_didl_lite_resource_get_bits_per_sample (src);
+                dest->audio_channels =
+                        gupnp_didl_lite_resource_get_audio_channels (src);
+                dest->width = gupnp_didl_lite_resource_get_width (src);
+                dest->height = gupnp_didl_lite_resource_get_height (src);
+                dest->color_depth =
+                        gupnp_didl_lite_resource_get_color_depth (src);
+        }
+}
+
+/**
+ * gupnp_didl_lite_snapshot_new:
+ * @object: A #GUPnPDIDLLiteObject
+ *
+ * Copy the fields, the contributors and the resources of @object into a new
+ * [struct@GUPnPAV.DIDLLiteSnapshot]. The snapshot does not reference
+ * @object or its document.
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.DIDLLiteSnapshot].
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_snapshot_new (GUPnPDIDLLiteObject *object)
+{
+        GUPnPDIDLLiteSnapshot *snapshot;
+        GUPnPDIDLLiteSnapshot measure;
+        GUPnPDIDLLiteFields fields;
+        GArray *contributors;
+        GPtrArray *resources;
+        Arena arena = { NULL, 0 };
+        guint i;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_OBJECT (object), NULL);
+
+        gupnp_didl_lite_object_get_fields (object,
+                                           GUPNP_DIDL_LITE_FIELD_ALL,
+                                           &fields);
+
+        contributors = g_array_new (FALSE, FALSE, sizeof (Contributor));
+        collect_contributors (contributors,
+                              "creator",
+                              gupnp_didl_lite_object_get_creators (object));
+        collect_contributors (contributors,
+                              "artist",
+                              gupnp_didl_lite_object_get_artists (object));
+        collect_contributors (contributors,
+                              "author",
+                              gupnp_didl_lite_object_get_authors (object));
+
+        resources = gupnp_didl_lite_object_get_resources_as_array (object);
+
+        /* Find out how much space the strings need first */
+        memset (&measure, 0, sizeof (measure));
+        measure.contributors = g_new0 (GUPnPDIDLLiteSnapshotContributor,
+                                       MAX (contributors->len, 1));
+        measure.resources = g_new0 (GUPnPDIDLLiteSnapshotResource,
+                                    MAX (resources->len, 1));
+        fill_snapshot (&measure, &arena, &fields, contributors, resources);
+        g_free (measure.contributors);
+        g_free (measure.resources);
+
+        snapshot = snapshot_alloc (contributors->len,
+                                   resources->len,
+                                   arena.size,
+                                   &arena.position);
+        snapshot->is_container = GUPNP_IS_DIDL_LITE_CONTAINER (object);
+        snapshot->restricted = gupnp_didl_lite_object_get_restricted (object);
+
+        fill_snapshot (snapshot, &arena, &fields, contributors, resources);
+
+        for (i = 0; i < contributors->len; i++)
+                g_object_unref (g_array_index (contributors,
+                                               Contributor,
+                                               i).contributor);
+        g_array_free (contributors, TRUE);
+        g_ptr_array_unref (resources);
+
+        return snapshot;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_ref:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Increase reference count of a [struct@GUPnPAV.DIDLLiteSnapshot].
+ *
+ * Returns: (transfer full): The object passed in @snapshot.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_snapshot_ref (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_val_if_fail (snapshot != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (snapshot);
+}
+
+static void
+snapshot_free (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_clear_pointer (&snapshot->variant, g_variant_unref);
+}
+
+/**
+ * gupnp_didl_lite_snapshot_unref:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.DIDLLiteSnapshot]. If the
+ * reference count drops to 0, @snapshot is freed.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_snapshot_unref (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_if_fail (snapshot != NULL);
+
+        g_atomic_rc_box_release_full (snapshot,
+                                      (GDestroyNotify) snapshot_free);
+}
+
+/**
+ * gupnp_didl_lite_snapshot_is_container:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Get whether @snapshot was taken of a container.
+ *
+ * Returns: %TRUE for a container, %FALSE for an item.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_snapshot_is_container (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_val_if_fail (snapshot != NULL, FALSE);
+
+        return snapshot->is_container;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_get_restricted:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Get the value of the restricted attribute of the object @snapshot was
+ * taken of.
+ *
+ * Returns: Whether the object was restricted.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_snapshot_get_restricted (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_val_if_fail (snapshot != NULL, FALSE);
+
+        return snapshot->restricted;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_get_fields:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Get the fields of the object @snapshot was taken of, as returned by
+ * gupnp_didl_lite_object_get_fields() for all fields.
+ *
+ * Returns: (transfer none): The fields, valid as long as @snapshot is.
+ *
+ * Since: 0.16
+ **/
+const GUPnPDIDLLiteFields *
+gupnp_didl_lite_snapshot_get_fields (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_val_if_fail (snapshot != NULL, NULL);
+
+        return &snapshot->fields;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_get_n_contributors:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Get the number of creators, artists and authors kept in @snapshot.
+ *
+ * Returns: The number of contributors.
+ *
+ * Since: 0.16
+ **/
+guint
+gupnp_didl_lite_snapshot_get_n_contributors (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_val_if_fail (snapshot != NULL, 0);
+
+        return snapshot->n_contributors;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_get_contributor:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ * @index_: The position of the contributor
+ *
+ * Get a contributor kept in @snapshot. The creators come first, followed by
+ * the artists and the authors, each in document order.
+ *
+ * Returns: (transfer none): The contributor, valid as long as @snapshot is.
+ *
+ * Since: 0.16
+ **/
+const GUPnPDIDLLiteSnapshotContributor *
+gupnp_didl_lite_snapshot_get_contributor (GUPnPDIDLLiteSnapshot *snapshot,
+                                          guint                  index_)
+{
+        g_return_val_if_fail (snapshot != NULL, NULL);
+        g_return_val_if_fail (index_ < snapshot->n_contributors, NULL);
+
+        return &snapshot->contributors[index_];
+}
+
+/**
+ * gupnp_didl_lite_snapshot_get_n_resources:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Get the number of resources kept in @snapshot.
+ *
+ * Returns: The number of resources.
+ *
+ * Since: 0.16
+ **/
+guint
+gupnp_didl_lite_snapshot_get_n_resources (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        g_return_val_if_fail (snapshot != NULL, 0);
+
+        return snapshot->n_resources;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_get_resource:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ * @index_: The position of the resource, in document order
+ *
+ * Get a resource kept in @snapshot.
+ *
+ * Returns: (transfer none): The resource, valid as long as @snapshot is.
+ *
+ * Since: 0.16
+ **/
+const GUPnPDIDLLiteSnapshotResource *
+gupnp_didl_lite_snapshot_get_resource (GUPnPDIDLLiteSnapshot *snapshot,
+                                       guint                  index_)
+{
+        g_return_val_if_fail (snapshot != NULL, NULL);
+        g_return_val_if_fail (index_ < snapshot->n_resources, NULL);
+
+        return &snapshot->resources[index_];
+}
+
+static void
+restore_resource (GUPnPDIDLLiteObject                 *object,
+                  const GUPnPDIDLLiteSnapshotResource *src)
+{
+        GUPnPDIDLLiteResource *resource;
+
+        resource = gupnp_didl_lite_object_add_resource (object);
+
+        if (src->uri != NULL)
+                gupnp_didl_lite_resource_set_uri (resource, src->uri);
+        if (src->import_uri != NULL)
+                gupnp_didl_lite_resource_set_import_uri (resource,
+                                                         src->import_uri);
+        if (src->protocol_info != NULL) {
+                GUPnPProtocolInfo *info;
+
+                info = gupnp_protocol_info_new_from_string (src->protocol_info,
+                                                            NULL);
+                if (info != NULL) {
+                        gupnp_didl_lite_resource_set_protocol_info (resource,
+                                                                    info);
+                        g_object_unref (info);
+                }
+        }
+        if (src->protection != NULL)
+                gupnp_didl_lite_resource_set_protection (resource,
+                                                         src->protection);
+        if (src->size >= 0)
+                gupnp_didl_lite_resource_set_size64 (resource, src->size);
+        if (src->duration >= 0)
+                gupnp_didl_lite_resource_set_duration (resource,
+                                                       src->duration);
+        if (src->bitrate >= 0)
+                gupnp_didl_lite_resource_set_bitrate (resource, src->bitrate);
+        if (src->sample_freq >= 0)
+                gupnp_didl_lite_resource_set_sample_freq (resource,
+                                                          src->sample_freq);
+        if (src->bits_per_sample >= 0)
+                gupnp_didl_lite_resource_set_bits_per_sample
+                                                (resource,
+                                                 src->bits_per_sample);
+        if (src->audio_channels >= 0)
+                gupnp_didl_lite_resource_set_audio_channels
+                                                (resource,
+                                                 src->audio_channels);
+        if (src->width >= 0)
+                gupnp_didl_lite_resource_set_width (resource, src->width);
+        if (src->height >= 0)
+                gupnp_didl_lite_resource_set_height (resource, src->height);
+        if (src->color_depth >= 0)
+                gupnp_didl_lite_resource_set_color_depth (resource,
+                                                          src->color_depth);
+
+        g_object_unref (resource);
+}
+
+/**
+ * gupnp_didl_lite_snapshot_to_object:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ * @writer: The #GUPnPDIDLLiteWriter to add the object to
+ *
+ * Add a new item or container to @writer and fill it with everything kept in
+ * @snapshot.
+ *
+ * Returns: (transfer full): The new #GUPnPDIDLLiteObject. Unref after usage.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteObject *
+gupnp_didl_lite_snapshot_to_object (GUPnPDIDLLiteSnapshot *snapshot,
+                                    GUPnPDIDLLiteWriter   *writer)
+{
+        GUPnPDIDLLiteObject *object;
+        const GUPnPDIDLLiteFields *fields;
+        guint i;
+
+        g_return_val_if_fail (snapshot != NULL, NULL);
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+
+        if (snapshot->is_container)
+                object = GUPNP_DIDL_LITE_OBJECT
+                                (gupnp_didl_lite_writer_add_container (writer));
+        else
+                object = GUPNP_DIDL_LITE_OBJECT
+                                (gupnp_didl_lite_writer_add_item (writer));
+
+        fields = &snapshot->fields;
+        if (fields->id != NULL)
+                gupnp_didl_lite_object_set_id (object, fields->id);
+        if (fields->parent_id != NULL)
+                gupnp_didl_lite_object_set_parent_id (object,
+                                                      fields->parent_id);
+        gupnp_didl_lite_object_set_restricted (object, snapshot->restricted);
+        if (fields->title != NULL)
+                gupnp_didl_lite_object_set_title (object, fields->title);
+        if (fields->upnp_class != NULL)
+                gupnp_didl_lite_object_set_upnp_class (object,
+                                                       fields->upnp_class);
+        if (fields->album != NULL)
+                gupnp_didl_lite_object_set_album (object, fields->album);
+        if (fields->album_art != NULL)
+                gupnp_didl_lite_object_set_album_art (object,
+                                                      fields->album_art);
+        if (fields->genre != NULL)
+                gupnp_didl_lite_object_set_genre (object, fields->genre);
+        if (fields->date != NULL)
+                gupnp_didl_lite_object_set_date (object, fields->date);
+        if (fields->description != NULL)
+                gupnp_didl_lite_object_set_description (object,
+                                                        fields->description);
+        if (fields->track_number >= 0)
+                gupnp_didl_lite_object_set_track_number (object,
+                                                         fields->track_number);
+
+        /* The creator and artist fields are restored along with the other
+         * contributors */
+        for (i = 0; i < snapshot->n_contributors; i++) {
+                const GUPnPDIDLLiteSnapshotContributor *src;
+                GUPnPDIDLLiteContributor *contributor;
+
+                src = &snapshot->contributors[i];
+                if (strcmp (src->element, "creator") == 0)
+                        contributor = gupnp_didl_lite_object_add_creator
+                                                                (object);
+                else if (strcmp (src->element, "artist") == 0)
+                        contributor = gupnp_didl_lite_object_add_artist
+                                                                (object);
+                else
+                        contributor = gupnp_didl_lite_object_add_author
+                                                                (object);
+
+                if (src->name != NULL)
+                        gupnp_didl_lite_contributor_set_name (contributor,
+                                                              src->name);
+                if (src->role != NULL)
+                        gupnp_didl_lite_contributor_set_role (contributor,
+                                                              src->role);
+
+                g_object_unref (contributor);
+        }
+
+        for (i = 0; i < snapshot->n_resources; i++)
+                restore_resource (object, &snapshot->resources[i]);
+
+        return object;
+}
+
+/**
+ * gupnp_didl_lite_snapshot_to_variant:
+ * @snapshot: A [struct@GUPnPAV.DIDLLiteSnapshot]
+ *
+ * Encode everything kept in @snapshot as a #GVariant of type
+ * %GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE. Store or send its serialized
+ * data, e.g. from g_variant_get_data_as_bytes(), and read it back with
+ * gupnp_didl_lite_snapshot_new_from_variant().
+ *
+ * Returns: (transfer floating): A new #GVariant.
+ *
+ * Since: 0.16
+ **/
+GVariant *
+gupnp_didl_lite_snapshot_to_variant (GUPnPDIDLLiteSnapshot *snapshot)
+{
+        const GUPnPDIDLLiteFields *fields;
+        GVariantBuilder contributors;
+        GVariantBuilder resources;
+        guint i;
+
+        g_return_val_if_fail (snapshot != NULL, NULL);
+
+        g_variant_builder_init (&contributors, G_VARIANT_TYPE ("a(smsms)"));
+        for (i = 0; i < snapshot->n_contributors; i++) {
+                const GUPnPDIDLLiteSnapshotContributor *contributor;
+
+                contributor = &snapshot->contributors[i];
+                g_variant_builder_add (&contributors,
+                                       "(smsms)",
+                                       contributor->element,
+                                       contributor->name,
+                                       contributor->role);
+        }
+
+        g_variant_builder_init (&resources,
+                                G_VARIANT_TYPE ("a(msmsmsmsxxiiiiiii)"));
+        for (i = 0; i < snapshot->n_resources; i++) {
+                const GUPnPDIDLLiteSnapshotResource *resource;
+
+                resource = &snapshot->resources[i];
+                g_variant_builder_add (&resources,
+                                       "(msmsmsmsxxiiiiiii)",
+                                       resource->uri,
+                                       resource->import_uri,
+                                       resource->protocol_info,
+                                       resource->protection,
+                                       resource->size,
+                                       (gint64) resource->duration,
+                                       resource->bitrate,
+                                       resource->sample_freq,
+                                       resource->bits_per_sample,
+                                       resource->audio_channels,
+                                       resource->width,
+                                       resource->height,
+                                       resource->color_depth);
+        }
+
+        fields = &snapshot->fields;
+
+        return g_variant_new (GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE,
+                              snapshot->is_container,
+                              snapshot->restricted,
+                              fields->id,
+                              fields->parent_id,
+                              fields->upnp_class,
+                              fields->title,
+                              fields->creator,
+                              fields->artist,
+                              fields->album,
+                              fields->album_art,
+                              fields->genre,
+                              fields->date,
+                              fields->description,
+                              (gint32) fields->track_number,
+                              (gint64) fields->duration,
+                              &contributors,
+                              &resources);
+}
+
+/**
+ * gupnp_didl_lite_snapshot_new_from_variant:
+ * @variant: A #GVariant of type %GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE
+ *
+ * Create a [struct@GUPnPAV.DIDLLiteSnapshot] from a variant made by
+ * gupnp_didl_lite_snapshot_to_variant().
+ *
+ * The strings of the snapshot are not copied but point straight into the
+ * data of @variant, which the snapshot keeps a reference to. For a variant
+ * created with g_variant_new_from_bytes() on a mapped file this means that
+ * none of the strings are read before they are used. If @variant is
+ * floating, the snapshot takes ownership of it.
+ *
+ * Returns: (transfer full) (nullable): A new [struct@GUPnPAV.DIDLLiteSnapshot],
+ * or %NULL if @variant is of the wrong type.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_snapshot_new_from_variant (GVariant *variant)
+{
+        GUPnPDIDLLiteSnapshot *snapshot;
+        GUPnPDIDLLiteFields fields;
+        GVariant *contributors;
+        GVariant *resources;
+        GVariantIter iter;
+        gboolean is_container;
+        gboolean restricted;
+        gint32 track_number;
+        gint64 duration;
+        guint i;
+
+        g_return_val_if_fail (variant != NULL, NULL);
+
+        g_variant_ref_sink (variant);
+
+        if (!g_variant_is_of_type
+                        (variant,
+                         G_VARIANT_TYPE (GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE))) {
+                g_variant_unref (variant);
+
+                return NULL;
+        }
+
+        g_variant_get (variant,
+                       "(bbm&sm&sm&sm&sm&sm&sm&sm&sm&sm&sm&six"
+                       "@a(smsms)@a(msmsmsmsxxiiiiiii))",
+                       &is_container,
+                       &restricted,
+                       &fields.id,
+                       &fields.parent_id,
+                       &fields.upnp_class,
+                       &fields.title,
+                       &fields.creator,
+                       &fields.artist,
+                       &fields.album,
+                       &fields.album_art,
+                       &fields.genre,
+                       &fields.date,
+                       &fields.description,
+                       &track_number,
+                       &duration,
+                       &contributors,
+                       &resources);
+        fields.track_number = track_number;
+        fields.duration = (glong) duration;
+
+        snapshot = snapshot_alloc (g_variant_n_children (contributors),
+                                   g_variant_n_children (resources),
+                                   0,
+                                   NULL);
+        snapshot->fields = fields;
+        snapshot->is_container = is_container;
+        snapshot->restricted = restricted;
+        snapshot->variant = variant;
+
+        g_variant_iter_init (&iter, contributors);
+        for (i = 0; i < snapshot->n_contributors; i++) {
+                GUPnPDIDLLiteSnapshotContributor *contributor;
+
+                contributor = &snapshot->contributors[i];
+                g_variant_iter_next (&iter,
+                                     "(&sm&sm&s)",
+                                     &contributor->element,
+                                     &contributor->name,
+                                     &contributor->role);
+        }
+
+        g_variant_iter_init (&iter, resources);
+        for (i = 0; i < snapshot->n_resources; i++) {
+                GUPnPDIDLLiteSnapshotResource *resource;
+
+                resource = &snapshot->resources[i];
+                g_variant_iter_next (&iter,
+                                     "(m&sm&sm&sm&sxxiiiiiii)",
+                                     &resource->uri,
+                                     &resource->import_uri,
+                                     &resource->protocol_info,
+                                     &resource->protection,
+                                     &resource->size,
+                                     &duration,
+                                     &resource->bitrate,
+                                     &resource->sample_freq,
+                                     &resource->bits_per_sample,
+                                     &resource->audio_channels,
+                                     &resource->width,
+                                     &resource->height,
+                                     &resource->color_depth);
+                resource->duration = (glong) duration;
+        }
+
+        g_variant_unref (contributors);
+        g_variant_unref (resources);
+
+        return snapshot;
+}
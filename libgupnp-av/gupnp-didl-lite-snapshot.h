@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_DIDL_LITE_SNAPSHOT_H
+#define GUPNP_DIDL_LITE_SNAPSHOT_H
+
+#include "gupnp-didl-lite-object.h"
+#include "gupnp-didl-lite-writer.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GUPnPDIDLLiteSnapshotContributor:
+ * @element: The name of the element, i.e. "creator", "artist" or "author"
+ * @name: The name of the contributor, or %NULL
+ * @role: The role of the contributor, or %NULL
+ *
+ * A contributor kept by a [struct@GUPnPAV.DIDLLiteSnapshot].
+ *
+ * Since: 0.16
+ */
+typedef struct {
+        const char *element;
+        const char *name;
+        const char *role;
+} GUPnPDIDLLiteSnapshotContributor;
+
+/**
+ * GUPnPDIDLLiteSnapshotResource:
+ * @uri: The URI of the resource, or %NULL
+ * @import_uri: The import URI of the resource, or %NULL
+ * @protocol_info: The protocolInfo string of the resource, or %NULL
+ * @protection: The protection of the resource, or %NULL
+ * @size: The size (in bytes) of the resource, or -1
+ * @duration: The duration (in seconds) of the resource, or -1
+ * @bitrate: The bitrate (in bytes per second) of the resource, or -1
+ * @sample_freq: The sample frequency of the resource, or -1
+ * @bits_per_sample: The sample size of the resource, or -1
+ * @audio_channels: The number of audio channels of the resource, or -1
+ * @width: The width of the resource, or -1
+ * @height: The height of the resource, or -1
+ * @color_depth: The color depth of the resource, or -1
+ *
+ * A resource kept by a [struct@GUPnPAV.DIDLLiteSnapshot], with the same
+ * values the getters of #GUPnPDIDLLiteResource return.
+ *
+ * Since: 0.16
+ */
+typedef struct {
+        const char *uri;
+        const char *import_uri;
+        const char *protocol_info;
+        const char *protection;
+        gint64      size;
+        glong       duration;
+        int         bitrate;
+        int         sample_freq;
+        int         bits_per_sample;
+        int         audio_channels;
+        int         width;
+        int         height;
+        int         color_depth;
+} GUPnPDIDLLiteSnapshotResource;
+
+/**
+ * GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE:
+ *
+ * The type string of the #GVariant encoding of a
+ * [struct@GUPnPAV.DIDLLiteSnapshot].
+ *
+ * Since: 0.16
+ */
+#define GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE \
+        "(bbmsmsmsmsmsmsmsmsmsmsmsixa(smsms)a(msmsmsmsxxiiiiiii))"
+
+GType
+gupnp_didl_lite_snapshot_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_DIDL_LITE_SNAPSHOT \
+                (gupnp_didl_lite_snapshot_get_type ())
+
+typedef struct _GUPnPDIDLLiteSnapshot GUPnPDIDLLiteSnapshot;
+
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_snapshot_new            (GUPnPDIDLLiteObject *object);
+
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_snapshot_ref            (GUPnPDIDLLiteSnapshot *snapshot);
+
+void
+gupnp_didl_lite_snapshot_unref          (GUPnPDIDLLiteSnapshot *snapshot);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPDIDLLiteSnapshot,
+                               gupnp_didl_lite_snapshot_unref)
+
+gboolean
+gupnp_didl_lite_snapshot_is_container   (GUPnPDIDLLiteSnapshot *snapshot);
+
+gboolean
+gupnp_didl_lite_snapshot_get_restricted (GUPnPDIDLLiteSnapshot *snapshot);
+
+const GUPnPDIDLLiteFields *
+gupnp_didl_lite_snapshot_get_fields     (GUPnPDIDLLiteSnapshot *snapshot);
+
+guint
+gupnp_didl_lite_snapshot_get_n_contributors
+                                        (GUPnPDIDLLiteSnapshot *snapshot);
+
+const GUPnPDIDLLiteSnapshotContributor *
+gupnp_didl_lite_snapshot_get_contributor
+                                        (GUPnPDIDLLiteSnapshot *snapshot,
+                                         guint                  index_);
+
+guint
+gupnp_didl_lite_snapshot_get_n_resources
+                                        (GUPnPDIDLLiteSnapshot *snapshot);
+
+const GUPnPDIDLLiteSnapshotResource *
+gupnp_didl_lite_snapshot_get_resource   (GUPnPDIDLLiteSnapshot *snapshot,
+                                         guint                  index_);
+
+GUPnPDIDLLiteObject *
+gupnp_didl_lite_snapshot_to_object      (GUPnPDIDLLiteSnapshot *snapshot,
+                                         GUPnPDIDLLiteWriter   *writer);
+
+GVariant *
+gupnp_didl_lite_snapshot_to_variant     (GUPnPDIDLLiteSnapshot *snapshot);
+
+GUPnPDIDLLiteSnapshot *
+gupnp_didl_lite_snapshot_new_from_variant
+                                        (GVariant *variant);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DIDL_LITE_SNAPSHOT_H__ */
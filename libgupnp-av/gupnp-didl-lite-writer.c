@@ -15,6 +15,11 @@
  * DIDL-Lite fragment writer
  *
  * #GUPnPDIDLLiteWriter is a helper class for writing DIDL-Lite fragments.
+ *
+ * A writer created with gupnp_didl_lite_writer_new_for_stream() does not
+ * keep the whole fragment in memory. Each item, container or descriptor
+ * added to it is written to its stream once the next one is added, or on
+ * gupnp_didl_lite_writer_flush() and gupnp_didl_lite_writer_finish().
  */
 
 #include <config.h>
@@ -25,23 +30,49 @@
 #include "gupnp-didl-lite-object.h"
 #include "gupnp-didl-lite-object-private.h"
 #include "gupnp-didl-lite-descriptor-private.h"
+#include "gupnp-didl-lite-filter-private.h"
 #include "gupnp-didl-lite-writer-private.h"
 
+#include "filter-util.h"
 #include "xml-util.h"
 
 struct _GUPnPDIDLLiteWriterPrivate {
         xmlNode       *xml_node;
         GUPnPAVXMLDoc *xml_doc;
 
-        xmlNs       *upnp_ns;
-        xmlNs       *dc_ns;
-        xmlNs       *dlna_ns;
-        xmlNs       *pv_ns;
+        /* Namespaces declared on the root element so far, they are only
+         * added once an object needs them */
+        GUPnPAVXMLNamespaces namespaces;
 
         char        *language;
+
+        /* Handed to the objects created from now on, see
+         * gupnp_didl_lite_writer_set_filter() */
+        GUPnPDIDLLiteFilter *filter;
+
+        /* Streaming mode: the document holding the top level element that
+         * was added last, and the first error writing to the stream */
+        GOutputStream *stream;
+        GUPnPAVXMLDoc *pending;
+        gboolean       header_written;
+        gboolean       finished;
+        GError        *stream_error;
+
+        /* Objects added with gupnp_didl_lite_writer_add_serialized(), in
+         * the order they were added, and the number of top level elements
+         * created so far, which is where the next one goes */
+        GArray        *serialized;
+        guint          n_top_level;
 };
 typedef struct _GUPnPDIDLLiteWriterPrivate GUPnPDIDLLiteWriterPrivate;
 
+/* Serialized objects are written out before the top level element at
+ * @position, or after all of them */
+typedef struct {
+        GBytes *bytes;
+        guint   position;
+} SerializedObjects;
+
 G_DEFINE_TYPE_WITH_PRIVATE (GUPnPDIDLLiteWriter,
                             gupnp_didl_lite_writer,
                             G_TYPE_OBJECT)
@@ -50,250 +81,451 @@ enum {
         PROP_0,
         PROP_XML_NODE,
         PROP_LANGUAGE,
+        PROP_STREAM,
 };
 
-static int
-compare_prop (const char *a, xmlAttr *attr)
+static void
+filter_attributes (xmlNode             *node,
+                   GUPnPDIDLLiteFilter *filter)
 {
-        const char *p;
-        char *parent_name;
-        char *attr_name;
-        int ret = -1;
+        xmlAttr *attr;
+        xmlAttr *next;
+
+        /* Unset forbidden properties */
+        for (attr = node->properties; attr != NULL; attr = next) {
+                const char *prefix = NULL;
+                const char *parent_prefix = NULL;
+
+                next = attr->next;
+
+                if (attr->ns != NULL)
+                        prefix = (const char *) attr->ns->prefix;
+                if (node->ns != NULL)
+                        parent_prefix = (const char *) node->ns->prefix;
+
+                if (!filter_util_is_standard_prop ((const char *) attr->name,
+                                                   NULL,
+                                                   (const char *) node->name) &&
+                    !gupnp_didl_lite_filter_is_attribute_allowed
+                                        (filter,
+                                         prefix,
+                                         (const char *) attr->name,
+                                         parent_prefix,
+                                         (const char *) node->name))
+                        xmlRemoveProp (attr);
+        }
+}
 
-        if (attr->ns != NULL)
-                attr_name = g_strjoin (":", attr->ns->prefix, attr->name, NULL);
-        else
-                attr_name = g_strdup ((const char *) attr->name);
+static void
+filter_node (xmlNode             *node,
+             GUPnPDIDLLiteFilter *filter,
+             gboolean             tags_only)
+{
+        xmlNode *child;
+        xmlNode *next;
+        gboolean removed = FALSE;
+        gboolean is_container = FALSE;
+        const char *container_class = NULL;
 
-        if (attr->parent->ns != NULL)
-                parent_name = g_strjoin (":",
-                                         attr->parent->ns->prefix,
-                                         attr->parent->name,
-                                         NULL);
-        else
-                parent_name = g_strdup ((const char *) attr->parent->name);
-
-        p = strstr (a, "@");
-        if (p)
-                if (p == a)
-                        /* Top-level property */
-                        ret = strcmp (a + 1, attr_name);
-                else
-                        ret = strncmp (a, parent_name, p - a) ||
-                              strcmp (p + 1, attr_name);
-        else
-                ret = strcmp (a, attr_name);
+        if (!tags_only)
+                filter_attributes (node, filter);
 
-        g_free (attr_name);
-        g_free (parent_name);
+        if (strcmp ((const char *) node->name, "container") == 0) {
+                is_container = TRUE;
+                container_class = av_xml_util_get_child_element_content
+                                        (node, "class");
+        }
 
-        return ret;
+        /* Remove the forbidden nodes */
+        for (child = node->children; child != NULL; child = next) {
+                const char *ns = NULL;
+
+                next = child->next;
+
+                if (xmlNodeIsText (child))
+                        continue;
+
+                if (child->ns != NULL)
+                        ns = (const char *) child->ns->prefix;
+
+                if (!(is_container && filter_util_is_container_standard_prop
+                                            ((const char *) child->name,
+                                             ns,
+                                             container_class)) &&
+                    !filter_util_is_standard_prop ((const char *) child->name,
+                                                   ns,
+                                                   (const char *) node->name) &&
+                    !gupnp_didl_lite_filter_is_node_allowed
+                                        (filter,
+                                         ns,
+                                         (const char *) child->name)) {
+                        xmlUnlinkNode (child);
+                        xmlFreeNode (child);
+                        removed = TRUE;
+                }
+        }
+
+        if (removed)
+                av_xml_doc_touch (node->doc);
+
+        /* Recurse */
+        for (child = node->children; child != NULL; child = child->next)
+                if (!xmlNodeIsText (child))
+                        filter_node (child, filter, tags_only);
 }
 
-static gboolean
-is_attribute_forbidden (xmlAttr *attr,
-                        GList   *allowed)
+static void
+apply_filter (GUPnPDIDLLiteWriter *writer,
+              GUPnPDIDLLiteFilter *filter,
+              gboolean             tags_only)
 {
-        return g_list_find_custom (allowed,
-                                   attr,
-                                   (GCompareFunc) compare_prop) == NULL;
+        xmlNode *node;
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        if (gupnp_didl_lite_filter_is_wildcard (filter))
+                return;
+
+        for (node = priv->xml_node->children; node != NULL; node = node->next)
+                filter_node (node, filter, tags_only);
 }
 
-static int
-compare_node_name (const char *a, const char *b)
+static void
+apply_filter_string (GUPnPDIDLLiteWriter *writer,
+                     const char          *filter,
+                     gboolean             tags_only)
 {
-        const char *p;
-        int len, result;
+        GUPnPDIDLLiteFilter *compiled;
 
-        if (a[0] == '@')
-                /* Filter is for top-level property */
-                return -1;
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
+        g_return_if_fail (filter != NULL);
 
-        p = strstr (a, "@");
-        if (p != NULL)
-                /* Compare only the string before '@' */
-                len = p - a;
-        else
-                len = strlen (a);
+        compiled = gupnp_didl_lite_filter_new (filter);
+        apply_filter (writer, compiled, tags_only);
+        gupnp_didl_lite_filter_unref (compiled);
+}
 
-        result = strncmp (a, b, len);
+/* Appends the start tag of the root element, with the namespaces and the
+ * language of the writer, to @string */
+static void
+append_start_tag (GUPnPDIDLLiteWriterPrivate *priv,
+                  GString                    *string)
+{
+        xmlNode *root;
+
+        /* A copy without children is an empty element tag that just needs
+         * to be kept open */
+        root = xmlDocCopyNode (priv->xml_node, priv->xml_doc->doc, 2);
+        av_xml_util_dump_node_to_string (string, priv->xml_doc->doc, root);
+        xmlFreeNode (root);
 
-        if (result == 0) {
-            /* Avoid that we return a match although only prefixes match like
-             * in upnp:album and upnp:albumArtUri, cf. bgo#687462 */
-            return strlen (b) - len;
+        if (g_str_has_suffix (string->str, "/>")) {
+                g_string_truncate (string, string->len - 2);
+                g_string_append_c (string, '>');
         }
+}
 
-        return result;
+static void
+append_end_tag (GUPnPDIDLLiteWriterPrivate *priv,
+                GString                    *string)
+{
+        xmlNs *ns = priv->xml_node->ns;
+
+        if (ns != NULL && ns->prefix != NULL)
+                g_string_append_printf (string,
+                                        "</%s:%s>",
+                                        (const char *) ns->prefix,
+                                        (const char *) priv->xml_node->name);
+        else
+                g_string_append_printf (string,
+                                        "</%s>",
+                                        (const char *) priv->xml_node->name);
 }
 
+/* Writes the start tag of the root element to the stream of a streaming
+ * writer */
 static gboolean
-is_node_forbidden (xmlNode     *node,
-                    GList      *allowed,
-                    const char *ns)
+write_header (GUPnPDIDLLiteWriterPrivate *priv,
+              GCancellable               *cancellable,
+              GError                    **error)
 {
-        char *name;
+        GString *header;
         gboolean ret;
 
-        if (ns != NULL)
-                name = g_strjoin (":", ns, node->name, NULL);
-        else
-                name = g_strdup ((const char *) node->name);
+        if (priv->header_written)
+                return TRUE;
 
-        ret = g_list_find_custom (allowed,
-                                  name,
-                                  (GCompareFunc) compare_node_name) == NULL;
+        header = g_string_new (NULL);
+        append_start_tag (priv, header);
 
-        g_free (name);
+        ret = g_output_stream_write_all (priv->stream,
+                                         header->str,
+                                         header->len,
+                                         NULL,
+                                         cancellable,
+                                         error);
+        g_string_free (header, TRUE);
+
+        priv->header_written = ret;
 
         return ret;
 }
 
+/* Writes the top level element of the pending document and drops the
+ * document, which only stays around if objects referring to it do */
 static gboolean
-is_container_standard_prop (const char *name,
-                            const char *namespace,
-                            const char *upnp_class)
+write_pending (GUPnPDIDLLiteWriterPrivate *priv,
+               GCancellable               *cancellable,
+               GError                    **error)
 {
-        return g_strcmp0 (upnp_class, "object.container.storageFolder") == 0 &&
-               g_strcmp0 (namespace, "upnp") == 0 &&
-               strcmp (name, "storageUsed") == 0;
+        GUPnPAVXMLDoc *pending;
+        xmlNode *node;
+        gboolean ret = TRUE;
+
+        if (!write_header (priv, cancellable, error))
+                return FALSE;
+
+        pending = g_steal_pointer (&priv->pending);
+        if (pending == NULL)
+                return TRUE;
+
+        node = xmlDocGetRootElement (pending->doc)->children;
+        for (; node != NULL && ret; node = node->next) {
+                if (priv->filter != NULL &&
+                    !gupnp_didl_lite_filter_is_wildcard (priv->filter))
+                        filter_node (node, priv->filter, FALSE);
+
+                ret = av_xml_util_dump_node_to_stream (priv->stream,
+                                                       pending->doc,
+                                                       node,
+                                                       cancellable,
+                                                       error);
+        }
+
+        av_xml_doc_unref (pending);
+
+        return ret;
 }
 
+/* Writes what is pending unless writing failed before. The first error is
+ * kept, and reported by every later call. */
 static gboolean
-is_standard_prop (const char *name,
-                  const char *namespace,
-                  const char *parent_name)
-{
-        return strcmp (name, "id") == 0 ||
-               strcmp (name, "parentID") == 0 ||
-               strcmp (name, "restricted") == 0 ||
-               strcmp (name, "refID") == 0 ||
-               (g_strcmp0 (namespace, "dc") == 0 &&
-                strcmp (name, "title") == 0) ||
-               (g_strcmp0 (namespace, "upnp") == 0 &&
-                strcmp (name, "class") == 0) ||
-               (g_strcmp0 (parent_name, "res") == 0 &&
-                strcmp (name, "protocolInfo") == 0);
+flush_pending (GUPnPDIDLLiteWriterPrivate *priv,
+               GCancellable               *cancellable,
+               GError                    **error)
+{
+        if (priv->stream_error == NULL)
+                write_pending (priv, cancellable, &priv->stream_error);
+        else
+                g_clear_pointer (&priv->pending, av_xml_doc_unref);
+
+        if (priv->stream_error != NULL) {
+                g_propagate_error (error, g_error_copy (priv->stream_error));
+
+                return FALSE;
+        }
+
+        return TRUE;
 }
 
-static void
-filter_attributes (xmlNode             *node,
-                   GList               *allowed)
+/* Creates a top level element named @name and returns the document it is
+ * in. A streaming writer writes out the previous one and builds the new one
+ * in a document of its own, so only one is held at a time. */
+static xmlNode *
+new_top_level_node (GUPnPDIDLLiteWriterPrivate *priv,
+                    const char                 *name,
+                    GUPnPAVXMLDoc             **xml_doc)
 {
-        xmlAttr *attr;
-        GList   *forbidden = NULL;
-        GList   *l;
+        GUPnPAVXMLNamespaces namespaces = { { NULL, } };
+        xmlDoc *doc;
+        xmlNode *root;
+
+        if (priv->stream == NULL) {
+                *xml_doc = priv->xml_doc;
+                priv->n_top_level++;
+
+                return xmlNewChild (priv->xml_node,
+                                    NULL,
+                                    (unsigned char *) name,
+                                    NULL);
+        }
 
-        /* Find forbidden properties */
-        for (attr = node->properties; attr != NULL; attr = attr->next)
-                if (!is_standard_prop ((const char *) attr->name,
-                                        NULL,
-                                        (const char *) attr->parent->name) &&
-                    is_attribute_forbidden (attr, allowed))
-                        forbidden = g_list_append (forbidden, attr);
+        flush_pending (priv, NULL, NULL);
+
+        doc = xmlNewDoc ((unsigned char *) "1.0");
+        root = xmlNewDocNode (doc, NULL, (unsigned char *) "DIDL-Lite", NULL);
+        xmlDocSetRootElement (doc, root);
+        av_xml_util_create_namespace (root, GUPNP_XML_NAMESPACE_DIDL_LITE);
+        av_xml_util_ensure_namespaces (doc, &namespaces);
 
-        /* Now unset forbidden properties */
-        for (l = forbidden; l != NULL; l = l->next)
-                xmlRemoveProp ((xmlAttr *) l->data);
+        priv->pending = av_xml_doc_new (doc);
+        *xml_doc = priv->pending;
 
-        g_list_free (forbidden);
+        return xmlNewChild (root, NULL, (unsigned char *) name, NULL);
 }
 
 static void
-filter_node (xmlNode             *node,
-             GList               *allowed,
-             gboolean             tags_only)
+serialized_objects_clear (SerializedObjects *objects)
 {
-        xmlNode *child;
-        GList   *forbidden = NULL;
-        GList   *l;
-        gboolean is_container = FALSE;
-        const char *container_class = NULL;
+        g_bytes_unref (objects->bytes);
+}
 
-        if (!tags_only)
-                filter_attributes (node, allowed);
+/* Returns the next serialized objects that go before the top level element
+ * at @position, or NULL if there are none. @index is the position in the
+ * list of serialized objects, which this advances. */
+static GBytes *
+next_serialized (GUPnPDIDLLiteWriterPrivate *priv,
+                 guint                      *index,
+                 guint                       position)
+{
+        SerializedObjects *objects;
 
-        if (strcmp ((const char *) node->name, "container") == 0) {
-                is_container = TRUE;
-                container_class = av_xml_util_get_child_element_content
-                                        (node, "class");
-        }
+        if (*index >= priv->serialized->len)
+                return NULL;
 
-        forbidden = NULL;
-        for (child = node->children; child != NULL; child = child->next) {
-                const char *ns = NULL;
+        objects = &g_array_index (priv->serialized, SerializedObjects, *index);
+        if (objects->position > position)
+                return NULL;
 
-                if (xmlNodeIsText (child))
-                        continue;
+        (*index)++;
 
-                if (child->ns != NULL)
-                        ns = (const char *) child->ns->prefix;
+        return objects->bytes;
+}
 
-                if (!(is_container && is_container_standard_prop
-                                            ((const char *) child->name,
-                                             ns,
-                                             container_class)) &&
-                    !is_standard_prop ((const char *) child->name,
-                                       ns,
-                                       (const char *)  node->name) &&
-                    is_node_forbidden (child, allowed, ns))
-                        forbidden = g_list_append (forbidden, child);
+/* Appends the document to @string, with the serialized objects in their
+ * places */
+static void
+append_document (GUPnPDIDLLiteWriterPrivate *priv,
+                 GString                    *string)
+{
+        xmlNode *node;
+        GBytes *bytes;
+        guint position = 0;
+        guint index = 0;
+
+        if (priv->serialized->len == 0) {
+                av_xml_util_dump_node_to_string (string,
+                                                 priv->xml_doc->doc,
+                                                 priv->xml_node);
+
+                return;
         }
 
-        /* Now remove the forbidden nodes */
-        for (l = forbidden; l != NULL; l = l->next) {
-                xmlNode *n;
+        append_start_tag (priv, string);
 
-                n = (xmlNode *) l->data;
+        for (node = priv->xml_node->children; node; node = node->next) {
+                while ((bytes = next_serialized (priv, &index, position)))
+                        g_string_append_len (string,
+                                             g_bytes_get_data (bytes, NULL),
+                                             g_bytes_get_size (bytes));
 
-                xmlUnlinkNode (n);
-                xmlFreeNode (n);
+                av_xml_util_dump_node_to_string (string,
+                                                 priv->xml_doc->doc,
+                                                 node);
+                position++;
         }
 
-        g_list_free (forbidden);
+        while ((bytes = next_serialized (priv, &index, G_MAXUINT)))
+                g_string_append_len (string,
+                                     g_bytes_get_data (bytes, NULL),
+                                     g_bytes_get_size (bytes));
 
-        /* Recurse */
-        for (child = node->children; child != NULL; child = child->next)
-                if (!xmlNodeIsText (child))
-                        filter_node (child, allowed, tags_only);
+        append_end_tag (priv, string);
 }
 
-static void
-apply_filter (GUPnPDIDLLiteWriter *writer,
-              const char          *filter,
-              gboolean             tags_only)
+static gboolean
+write_bytes (GOutputStream *stream,
+             GBytes        *bytes,
+             GCancellable  *cancellable,
+             GError       **error)
 {
-        char **tokens;
-        GList *allowed = NULL;
-        unsigned short i;
-        xmlNode *node;
-
-        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
-        g_return_if_fail (filter != NULL);
-
-        GUPnPDIDLLiteWriterPrivate *priv =
-                gupnp_didl_lite_writer_get_instance_private (writer);
+        return g_output_stream_write_all (stream,
+                                          g_bytes_get_data (bytes, NULL),
+                                          g_bytes_get_size (bytes),
+                                          NULL,
+                                          cancellable,
+                                          error);
+}
 
-        if (filter[0] == '*')
-                return;         /* Wildcard */
+/* Writes the document to @stream, with the serialized objects in their
+ * places */
+static gboolean
+write_document (GUPnPDIDLLiteWriterPrivate *priv,
+                GOutputStream              *stream,
+                GCancellable               *cancellable,
+                GError                    **error)
+{
+        xmlNode *node;
+        GBytes *bytes;
+        GString *tag;
+        guint position = 0;
+        guint index = 0;
+        gboolean ret;
 
-        tokens = g_strsplit (filter, ",", -1);
-        g_return_if_fail (tokens != NULL);
+        if (priv->serialized->len == 0)
+                return av_xml_util_dump_node_to_stream (stream,
+                                                        priv->xml_doc->doc,
+                                                        priv->xml_node,
+                                                        cancellable,
+                                                        error);
+
+        tag = g_string_new (NULL);
+        append_start_tag (priv, tag);
+        ret = g_output_stream_write_all (stream,
+                                         tag->str,
+                                         tag->len,
+                                         NULL,
+                                         cancellable,
+                                         error);
+
+        node = priv->xml_node->children;
+        for (; node != NULL && ret; node = node->next) {
+                while (ret &&
+                       (bytes = next_serialized (priv, &index, position)))
+                        ret = write_bytes (stream, bytes, cancellable, error);
+
+                if (ret)
+                        ret = av_xml_util_dump_node_to_stream
+                                                (stream,
+                                                 priv->xml_doc->doc,
+                                                 node,
+                                                 cancellable,
+                                                 error);
+                position++;
+        }
 
-        for (i = 0; tokens[i] != NULL; i++)
-                allowed = g_list_append (allowed, tokens[i]);
+        while (ret && (bytes = next_serialized (priv, &index, G_MAXUINT)))
+                ret = write_bytes (stream, bytes, cancellable, error);
+
+        if (ret) {
+                g_string_truncate (tag, 0);
+                append_end_tag (priv, tag);
+                ret = g_output_stream_write_all (stream,
+                                                 tag->str,
+                                                 tag->len,
+                                                 NULL,
+                                                 cancellable,
+                                                 error);
+        }
 
-        for (node = priv->xml_node->children; node != NULL; node = node->next)
-                filter_node (node, allowed, tags_only);
+        g_string_free (tag, TRUE);
 
-        g_list_free (allowed);
-        g_strfreev (tokens);
+        return ret;
 }
 
-
 static void
 gupnp_didl_lite_writer_init (GUPnPDIDLLiteWriter *writer)
 {
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        priv->serialized = g_array_new (FALSE,
+                                        FALSE,
+                                        sizeof (SerializedObjects));
+        g_array_set_clear_func (priv->serialized,
+                                (GDestroyNotify) serialized_objects_clear);
 }
 
 static void
@@ -313,6 +545,9 @@ gupnp_didl_lite_writer_set_property (GObject      *object,
         case PROP_LANGUAGE:
                 priv->language = g_value_dup_string (value);
                 break;
+        case PROP_STREAM:
+                priv->stream = g_value_dup_object (value);
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
                 break;
@@ -338,6 +573,10 @@ gupnp_didl_lite_writer_get_property (GObject    *object,
                 g_value_set_string
                         (value, gupnp_didl_lite_writer_get_language (writer));
                 break;
+        case PROP_STREAM:
+                g_value_set_object
+                        (value, gupnp_didl_lite_writer_get_stream (writer));
+                break;
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
                 break;
@@ -363,14 +602,21 @@ gupnp_didl_lite_writer_constructed (GObject *object)
                                         NULL);
         xmlDocSetRootElement (priv->xml_doc->doc, priv->xml_node);
 
-        av_xml_util_create_namespace (priv->xml_node,
-                                      GUPNP_XML_NAMESPACE_DIDL_LITE);
+        priv->namespaces.ns[GUPNP_XML_NAMESPACE_DIDL_LITE] =
+                av_xml_util_create_namespace (priv->xml_node,
+                                              GUPNP_XML_NAMESPACE_DIDL_LITE);
 
         if (priv->language)
                 xmlSetProp (priv->xml_node,
                             (unsigned char *) "lang",
                             (unsigned char *) priv->language);
 
+        /* The start tag is written before any object, so it has to declare
+         * all the namespaces an object might use */
+        if (priv->stream != NULL)
+                av_xml_util_ensure_namespaces (priv->xml_doc->doc,
+                                               &priv->namespaces);
+
         object_class = G_OBJECT_CLASS (gupnp_didl_lite_writer_parent_class);
         if (object_class->constructed != NULL)
                 object_class->constructed (object);
@@ -385,6 +631,10 @@ gupnp_didl_lite_writer_dispose (GObject *object)
                         GUPNP_DIDL_LITE_WRITER (object));
 
         g_clear_pointer (&priv->xml_doc, av_xml_doc_unref);
+        g_clear_pointer (&priv->filter, gupnp_didl_lite_filter_unref);
+        g_clear_pointer (&priv->pending, av_xml_doc_unref);
+        g_clear_pointer (&priv->serialized, g_array_unref);
+        g_clear_object (&priv->stream);
 
         object_class = G_OBJECT_CLASS (gupnp_didl_lite_writer_parent_class);
         object_class->dispose (object);
@@ -399,6 +649,7 @@ gupnp_didl_lite_writer_finalize (GObject *object)
                         GUPNP_DIDL_LITE_WRITER (object));
 
         g_free (priv->language);
+        g_clear_error (&priv->stream_error);
 
         object_class = G_OBJECT_CLASS (gupnp_didl_lite_writer_parent_class);
         object_class->finalize (object);
@@ -453,6 +704,28 @@ gupnp_didl_lite_writer_class_init (GUPnPDIDLLiteWriterClass *klass)
                                       G_PARAM_STATIC_NAME |
                                       G_PARAM_STATIC_NICK |
                                       G_PARAM_STATIC_BLURB));
+
+        /**
+         * GUPnPDIDLLiteWriter:stream:
+         *
+         * The stream a streaming writer writes the DIDL-Lite fragment to,
+         * or %NULL if the writer keeps the whole fragment in memory.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_STREAM,
+                 g_param_spec_object ("stream",
+                                      "Stream",
+                                      "The stream the DIDL-Lite fragment is"
+                                      " written to.",
+                                      G_TYPE_OUTPUT_STREAM,
+                                      G_PARAM_CONSTRUCT_ONLY |
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_STATIC_NAME |
+                                      G_PARAM_STATIC_NICK |
+                                      G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -472,6 +745,70 @@ gupnp_didl_lite_writer_new (const char *language)
                              NULL);
 }
 
+/* Creates the object for @node in @xml_doc, handing it the namespaces the
+ * document already declares and the filter of the writer */
+static GUPnPDIDLLiteObject *
+new_object (GUPnPDIDLLiteWriterPrivate *priv,
+            GUPnPAVXMLDoc              *xml_doc,
+            xmlNode                    *node)
+{
+        GUPnPAVXMLNamespaces local = { { NULL, } };
+        GUPnPAVXMLNamespaces *namespaces = &priv->namespaces;
+        GUPnPDIDLLiteObject *object;
+
+        if (xml_doc != priv->xml_doc)
+                namespaces = &local;
+        av_xml_util_resolve_namespaces (xml_doc->doc, namespaces);
+
+        object = gupnp_didl_lite_object_new_from_xml
+                                (node,
+                                 xml_doc,
+                                 namespaces->ns[GUPNP_XML_NAMESPACE_UPNP],
+                                 namespaces->ns[GUPNP_XML_NAMESPACE_DC],
+                                 namespaces->ns[GUPNP_XML_NAMESPACE_DLNA],
+                                 namespaces->ns[GUPNP_XML_NAMESPACE_PV]);
+        gupnp_didl_lite_object_set_filter (object, priv->filter);
+
+        return object;
+}
+
+/**
+ * gupnp_didl_lite_writer_new_for_stream:
+ * @language: (allow-none): The language the DIDL-Lite fragment is in, or
+ * %NULL
+ * @stream: The #GOutputStream to write the DIDL-Lite fragment to
+ *
+ * Create a streaming writer. Only the item, container or descriptor added
+ * last is kept in memory; adding the next one writes it to @stream, after
+ * removing what the filter set with gupnp_didl_lite_writer_set_filter()
+ * excludes. Changes to an object made after that are not written, so add
+ * the child items of a container before the next top level object.
+ *
+ * Call gupnp_didl_lite_writer_finish() to write the last object and close
+ * the root element. A #GMemoryOutputStream collects the fragment in a
+ * growing buffer.
+ *
+ * The start tag declares all the namespaces objects might use.
+ * gupnp_didl_lite_writer_get_string() and the other methods serializing the
+ * whole document only see an empty root element, and
+ * gupnp_didl_lite_writer_filter() has no effect on a streaming writer.
+ *
+ * Return value: A new #GUPnPDIDLLiteWriter object.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteWriter *
+gupnp_didl_lite_writer_new_for_stream (const char    *language,
+                                       GOutputStream *stream)
+{
+        g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), NULL);
+
+        return g_object_new (GUPNP_TYPE_DIDL_LITE_WRITER,
+                             "language", language,
+                             "stream", stream,
+                             NULL);
+}
+
 /**
  * gupnp_didl_lite_writer_add_item:
  * @writer: A #GUPnPDIDLLiteWriter
@@ -484,23 +821,17 @@ GUPnPDIDLLiteItem *
 gupnp_didl_lite_writer_add_item (GUPnPDIDLLiteWriter *writer)
 {
         xmlNode *item_node;
+        GUPnPAVXMLDoc *xml_doc;
         GUPnPDIDLLiteObject *object;
         GUPnPDIDLLiteWriterPrivate *priv =
                 gupnp_didl_lite_writer_get_instance_private (writer);
 
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+        g_return_val_if_fail (!priv->finished, NULL);
 
-        item_node = xmlNewChild (priv->xml_node,
-                                 NULL,
-                                 (unsigned char *) "item",
-                                 NULL);
+        item_node = new_top_level_node (priv, "item", &xml_doc);
 
-        object = gupnp_didl_lite_object_new_from_xml (item_node,
-                                                      priv->xml_doc,
-                                                      priv->upnp_ns,
-                                                      priv->dc_ns,
-                                                      priv->dlna_ns,
-                                                      priv->pv_ns);
+        object = new_object (priv, xml_doc, item_node);
         return GUPNP_DIDL_LITE_ITEM (object);
 }
 
@@ -528,19 +859,17 @@ gupnp_didl_lite_writer_add_container_child_item
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_CONTAINER (container), NULL);
 
         object = GUPNP_DIDL_LITE_OBJECT (container);
-        container_node = gupnp_didl_lite_object_get_xml_node (object);
+        container_node = gupnp_didl_lite_object_peek_xml_node (object);
 
         item_node = xmlNewChild (container_node,
                                  NULL,
                                  (xmlChar *) "item",
                                  NULL);
+        av_xml_doc_touch (item_node->doc);
 
-        object = gupnp_didl_lite_object_new_from_xml (item_node,
-                                                      priv->xml_doc,
-                                                      priv->upnp_ns,
-                                                      priv->dc_ns,
-                                                      priv->dlna_ns,
-                                                      priv->pv_ns);
+        object = new_object (priv,
+                             gupnp_didl_lite_object_get_gupnp_xml_doc (object),
+                             item_node);
         return GUPNP_DIDL_LITE_ITEM (object);
 }
 
@@ -556,23 +885,17 @@ GUPnPDIDLLiteContainer *
 gupnp_didl_lite_writer_add_container (GUPnPDIDLLiteWriter *writer)
 {
         xmlNode *container_node;
+        GUPnPAVXMLDoc *xml_doc;
         GUPnPDIDLLiteObject *object;
         GUPnPDIDLLiteWriterPrivate *priv =
                 gupnp_didl_lite_writer_get_instance_private (writer);
 
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+        g_return_val_if_fail (!priv->finished, NULL);
 
-        container_node = xmlNewChild (priv->xml_node,
-                                      NULL,
-                                      (unsigned char *) "container",
-                                      NULL);
-
-        object = gupnp_didl_lite_object_new_from_xml (container_node,
-                                                      priv->xml_doc,
-                                                      priv->upnp_ns,
-                                                      priv->dc_ns,
-                                                      priv->dlna_ns,
-                                                      priv->pv_ns);
+        container_node = new_top_level_node (priv, "container", &xml_doc);
+
+        object = new_object (priv, xml_doc, container_node);
         return GUPNP_DIDL_LITE_CONTAINER (object);
 }
 
@@ -588,18 +911,69 @@ GUPnPDIDLLiteDescriptor *
 gupnp_didl_lite_writer_add_descriptor (GUPnPDIDLLiteWriter *writer)
 {
         xmlNode *desc_node;
+        GUPnPAVXMLDoc *xml_doc;
 
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
         GUPnPDIDLLiteWriterPrivate *priv =
                 gupnp_didl_lite_writer_get_instance_private (writer);
+        g_return_val_if_fail (!priv->finished, NULL);
 
-        desc_node = xmlNewChild (priv->xml_node,
-                                 NULL,
-                                 (unsigned char *) "desc",
-                                 NULL);
+        desc_node = new_top_level_node (priv, "desc", &xml_doc);
 
-        return gupnp_didl_lite_descriptor_new_from_xml (desc_node,
-                                                        priv->xml_doc);
+        return gupnp_didl_lite_descriptor_new_from_xml (desc_node, xml_doc);
+}
+
+/**
+ * gupnp_didl_lite_writer_add_serialized:
+ * @writer: A #GUPnPDIDLLiteWriter
+ * @fragment: Serialized DIDL-Lite objects
+ *
+ * Add objects that have been serialized before, e.g. with
+ * gupnp_didl_lite_object_get_xml_bytes() or
+ * gupnp_didl_lite_fragment_cache_insert_object(), after the ones added so
+ * far. @fragment is copied into the output of @writer as is, so it has to
+ * be well-formed and use the namespace prefixes of #GUPnPDIDLLiteWriter,
+ * which are all declared on the root element from now on.
+ *
+ * @fragment only becomes part of the output, not of the tree returned by
+ * gupnp_didl_lite_writer_get_xml_node(). Filtering @writer later does not
+ * affect it.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_writer_add_serialized (GUPnPDIDLLiteWriter *writer,
+                                       GBytes              *fragment)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+        SerializedObjects objects;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
+        g_return_if_fail (fragment != NULL);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        g_return_if_fail (!priv->finished);
+
+        if (g_bytes_get_size (fragment) == 0)
+                return;
+
+        /* Streaming writers declare all namespaces anyway */
+        if (priv->stream != NULL) {
+                if (flush_pending (priv, NULL, NULL))
+                        write_bytes (priv->stream,
+                                     fragment,
+                                     NULL,
+                                     &priv->stream_error);
+
+                return;
+        }
+
+        av_xml_util_ensure_namespaces (priv->xml_doc->doc, &priv->namespaces);
+
+        objects.bytes = g_bytes_ref (fragment);
+        objects.position = priv->n_top_level;
+        g_array_append_val (priv->serialized, objects);
 }
 
 /**
@@ -613,20 +987,250 @@ gupnp_didl_lite_writer_add_descriptor (GUPnPDIDLLiteWriter *writer)
 char *
 gupnp_didl_lite_writer_get_string (GUPnPDIDLLiteWriter *writer)
 {
-        xmlBuffer *buffer;
-        char      *ret;
+        GString *string;
 
         g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
-        GUPnPDIDLLiteWriterPrivate *priv =
-                gupnp_didl_lite_writer_get_instance_private (writer);
 
-        buffer = xmlBufferCreate ();
-        xmlNodeDump (buffer, priv->xml_doc->doc, priv->xml_node, 0, 0);
-        ret = g_strndup ((char *) xmlBufferContent (buffer),
-                         xmlBufferLength (buffer));
-        xmlBufferFree (buffer);
+        string = g_string_new (NULL);
+        gupnp_didl_lite_writer_append_string (writer, string);
 
-        return ret;
+        return g_string_free (string, FALSE);
+}
+
+/**
+ * gupnp_didl_lite_writer_get_bytes:
+ * @writer: A #GUPnPDIDLLiteWriter
+ *
+ * Like gupnp_didl_lite_writer_get_string(), but the returned #GBytes owns
+ * the buffer the document was serialized into, so the XML is never copied.
+ *
+ * Return value: (transfer full): The DIDL-Lite XML.
+ *
+ * Since: 0.16
+ **/
+GBytes *
+gupnp_didl_lite_writer_get_bytes (GUPnPDIDLLiteWriter *writer)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        if (priv->serialized->len > 0) {
+                GString *string = g_string_new (NULL);
+
+                append_document (priv, string);
+
+                return g_string_free_to_bytes (string);
+        }
+
+        return av_xml_util_dump_node_to_bytes (priv->xml_doc->doc,
+                                               priv->xml_node);
+}
+
+/**
+ * gupnp_didl_lite_writer_append_string:
+ * @writer: A #GUPnPDIDLLiteWriter
+ * @string: The #GString to append to
+ *
+ * Append the DIDL-Lite XML document to @string, e.g. to build a Browse
+ * response around it.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_writer_append_string (GUPnPDIDLLiteWriter *writer,
+                                      GString             *string)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
+        g_return_if_fail (string != NULL);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        append_document (priv, string);
+}
+
+/**
+ * gupnp_didl_lite_writer_write_to_stream:
+ * @writer: A #GUPnPDIDLLiteWriter
+ * @stream: The #GOutputStream to write to
+ * @cancellable: (nullable): A #GCancellable, or %NULL
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Write the DIDL-Lite XML document to @stream. The document is written in
+ * small chunks as it is serialized and never held in memory as a whole.
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_writer_write_to_stream (GUPnPDIDLLiteWriter *writer,
+                                        GOutputStream       *stream,
+                                        GCancellable        *cancellable,
+                                        GError             **error)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), FALSE);
+        g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), FALSE);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        return write_document (priv, stream, cancellable, error);
+}
+
+/**
+ * gupnp_didl_lite_writer_reset:
+ * @writer: A #GUPnPDIDLLiteWriter
+ *
+ * Remove all items, containers and descriptors from @writer, so it can be
+ * used for the next response instead of creating a new one. The document,
+ * its root element with the namespaces declared so far, and the language
+ * are kept. The filter set with gupnp_didl_lite_writer_set_filter() is
+ * unset.
+ *
+ * The elements are freed, so objects created by @writer before must not be
+ * used anymore. This is not supported for streaming writers.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_writer_reset (GUPnPDIDLLiteWriter *writer)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+        xmlNode *child;
+        xmlNode *next;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        g_return_if_fail (priv->stream == NULL);
+
+        for (child = priv->xml_node->children; child != NULL; child = next) {
+                next = child->next;
+
+                xmlUnlinkNode (child);
+                xmlFreeNode (child);
+        }
+        av_xml_doc_touch (priv->xml_doc->doc);
+
+        g_array_set_size (priv->serialized, 0);
+        priv->n_top_level = 0;
+
+        g_clear_pointer (&priv->filter, gupnp_didl_lite_filter_unref);
+}
+
+/**
+ * gupnp_didl_lite_writer_get_stream:
+ * @writer: A #GUPnPDIDLLiteWriter
+ *
+ * Get the stream of a writer created with
+ * gupnp_didl_lite_writer_new_for_stream().
+ *
+ * Returns: (transfer none) (nullable): The stream @writer writes to, or
+ * %NULL if it is not a streaming writer.
+ *
+ * Since: 0.16
+ **/
+GOutputStream *
+gupnp_didl_lite_writer_get_stream (GUPnPDIDLLiteWriter *writer)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        return priv->stream;
+}
+
+/**
+ * gupnp_didl_lite_writer_flush:
+ * @writer: A streaming #GUPnPDIDLLiteWriter
+ * @cancellable: (nullable): A #GCancellable, or %NULL
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Write the objects added to @writer so far to its stream, including the
+ * one added last, which then can't be changed anymore.
+ *
+ * Writing stops at the first error, which is then also reported by all
+ * later calls of this function and of gupnp_didl_lite_writer_finish().
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_writer_flush (GUPnPDIDLLiteWriter *writer,
+                              GCancellable        *cancellable,
+                              GError             **error)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), FALSE);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        g_return_val_if_fail (priv->stream != NULL, FALSE);
+        g_return_val_if_fail (!priv->finished, FALSE);
+
+        return flush_pending (priv, cancellable, error);
+}
+
+/**
+ * gupnp_didl_lite_writer_finish:
+ * @writer: A streaming #GUPnPDIDLLiteWriter
+ * @cancellable: (nullable): A #GCancellable, or %NULL
+ * @error: (inout) (optional) (nullable): The location where to store any
+ * error, or %NULL
+ *
+ * Write the object added last and the end tag of the root element to the
+ * stream of @writer. No objects can be added afterwards. The stream is
+ * left open.
+ *
+ * Return value: %TRUE on success.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_didl_lite_writer_finish (GUPnPDIDLLiteWriter *writer,
+                               GCancellable        *cancellable,
+                               GError             **error)
+{
+        static const char end_tag[] = "</DIDL-Lite>";
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), FALSE);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        g_return_val_if_fail (priv->stream != NULL, FALSE);
+        g_return_val_if_fail (!priv->finished, FALSE);
+
+        if (!flush_pending (priv, cancellable, error))
+                return FALSE;
+
+        priv->finished = TRUE;
+
+        if (!g_output_stream_write_all (priv->stream,
+                                        end_tag,
+                                        sizeof (end_tag) - 1,
+                                        NULL,
+                                        cancellable,
+                                        &priv->stream_error)) {
+                g_propagate_error (error, g_error_copy (priv->stream_error));
+
+                return FALSE;
+        }
+
+        return TRUE;
 }
 
 /**
@@ -635,6 +1239,9 @@ gupnp_didl_lite_writer_get_string (GUPnPDIDLLiteWriter *writer)
  *
  * Get the pointer to root node in XML document.
  *
+ * As with gupnp_didl_lite_object_get_xml_node(), the objects of @writer see
+ * changes made through the returned node until their next getter call.
+ *
  * Returns: (transfer none): The pointer to root node in XML document.
  **/
 xmlNode *
@@ -644,6 +1251,8 @@ gupnp_didl_lite_writer_get_xml_node (GUPnPDIDLLiteWriter *writer)
         GUPnPDIDLLiteWriterPrivate *priv =
                 gupnp_didl_lite_writer_get_instance_private (writer);
 
+        av_xml_doc_touch (priv->xml_node->doc);
+
         return priv->xml_node;
 }
 
@@ -680,9 +1289,88 @@ void
 gupnp_didl_lite_writer_filter (GUPnPDIDLLiteWriter *writer,
                                const char          *filter)
 {
+        apply_filter_string (writer, filter, FALSE);
+}
+
+/**
+ * gupnp_didl_lite_writer_apply_filter:
+ * @writer: A #GUPnPDIDLLiteWriter
+ * @filter: A [struct@GUPnPAV.DIDLLiteFilter]
+ *
+ * Like gupnp_didl_lite_writer_filter(), but with a filter that has been
+ * compiled before, e.g. once for all requests of a control point.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_writer_apply_filter (GUPnPDIDLLiteWriter *writer,
+                                     GUPnPDIDLLiteFilter *filter)
+{
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
+        g_return_if_fail (filter != NULL);
+
         apply_filter (writer, filter, FALSE);
 }
 
+/**
+ * gupnp_didl_lite_writer_set_filter:
+ * @writer: A #GUPnPDIDLLiteWriter
+ * @filter: (nullable): A [struct@GUPnPAV.DIDLLiteFilter], or %NULL
+ *
+ * Set the filter the result of @writer is going to be filtered with, before
+ * adding objects to it. The setters of the items and containers created by
+ * @writer afterwards then skip the properties @filter would remove, instead
+ * of adding them to the document in the first place.
+ *
+ * The methods returning a new resource, contributor or descriptor still
+ * add it, so call gupnp_didl_lite_writer_apply_filter() with the same
+ * filter if you use them. Set the class of a container before its storage
+ * used, which depends on the class.
+ *
+ * Objects created before are not affected. %NULL or the wildcard filter
+ * make the setters write all properties again.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_didl_lite_writer_set_filter (GUPnPDIDLLiteWriter *writer,
+                                   GUPnPDIDLLiteFilter *filter)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer));
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        if (filter != NULL)
+                gupnp_didl_lite_filter_ref (filter);
+
+        g_clear_pointer (&priv->filter, gupnp_didl_lite_filter_unref);
+        priv->filter = filter;
+}
+
+/**
+ * gupnp_didl_lite_writer_get_filter:
+ * @writer: A #GUPnPDIDLLiteWriter
+ *
+ * Get the filter set with gupnp_didl_lite_writer_set_filter().
+ *
+ * Returns: (transfer none) (nullable): The filter of @writer, or %NULL.
+ *
+ * Since: 0.16
+ **/
+GUPnPDIDLLiteFilter *
+gupnp_didl_lite_writer_get_filter (GUPnPDIDLLiteWriter *writer)
+{
+        GUPnPDIDLLiteWriterPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_DIDL_LITE_WRITER (writer), NULL);
+
+        priv = gupnp_didl_lite_writer_get_instance_private (writer);
+
+        return priv->filter;
+}
+
 /**
  * gupnp_didl_lite_writer_filter_tags:
  * @writer: A #GUPnPDIDLLiteWriter
@@ -703,5 +1391,5 @@ void
 gupnp_didl_lite_writer_filter_tags (GUPnPDIDLLiteWriter *writer,
                                     const char          *filter)
 {
-        apply_filter (writer, filter, TRUE);
+        apply_filter_string (writer, filter, TRUE);
 }
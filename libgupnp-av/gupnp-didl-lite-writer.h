@@ -11,13 +11,14 @@
 #define GUPNP_DIDL_LITE_WRITER_H
 
 #include <stdarg.h>
-#include <glib-object.h>
+#include <gio/gio.h>
 
 #include "gupnp-dlna.h"
 #include "gupnp-didl-lite-item.h"
 #include "gupnp-didl-lite-container.h"
 #include "gupnp-didl-lite-resource.h"
 #include "gupnp-didl-lite-descriptor.h"
+#include "gupnp-didl-lite-filter.h"
 
 G_BEGIN_DECLS
 
@@ -49,6 +50,10 @@ struct _GUPnPDIDLLiteWriterClass {
 GUPnPDIDLLiteWriter *
 gupnp_didl_lite_writer_new              (const char *language);
 
+GUPnPDIDLLiteWriter *
+gupnp_didl_lite_writer_new_for_stream   (const char    *language,
+                                         GOutputStream *stream);
+
 GUPnPDIDLLiteItem *
 gupnp_didl_lite_writer_add_item         (GUPnPDIDLLiteWriter *writer);
 
@@ -58,19 +63,63 @@ gupnp_didl_lite_writer_add_container    (GUPnPDIDLLiteWriter *writer);
 GUPnPDIDLLiteDescriptor *
 gupnp_didl_lite_writer_add_descriptor   (GUPnPDIDLLiteWriter *writer);
 
+void
+gupnp_didl_lite_writer_add_serialized   (GUPnPDIDLLiteWriter *writer,
+                                         GBytes              *fragment);
+
 xmlNode *
 gupnp_didl_lite_writer_get_xml_node     (GUPnPDIDLLiteWriter   *writer);
 
 char *
 gupnp_didl_lite_writer_get_string       (GUPnPDIDLLiteWriter   *writer);
 
+GBytes *
+gupnp_didl_lite_writer_get_bytes        (GUPnPDIDLLiteWriter   *writer);
+
+void
+gupnp_didl_lite_writer_append_string    (GUPnPDIDLLiteWriter   *writer,
+                                         GString               *string);
+
+gboolean
+gupnp_didl_lite_writer_write_to_stream  (GUPnPDIDLLiteWriter   *writer,
+                                         GOutputStream         *stream,
+                                         GCancellable          *cancellable,
+                                         GError               **error);
+
 const char *
 gupnp_didl_lite_writer_get_language     (GUPnPDIDLLiteWriter   *writer);
 
+void
+gupnp_didl_lite_writer_reset            (GUPnPDIDLLiteWriter   *writer);
+
+GOutputStream *
+gupnp_didl_lite_writer_get_stream       (GUPnPDIDLLiteWriter   *writer);
+
+gboolean
+gupnp_didl_lite_writer_flush            (GUPnPDIDLLiteWriter   *writer,
+                                         GCancellable          *cancellable,
+                                         GError               **error);
+
+gboolean
+gupnp_didl_lite_writer_finish           (GUPnPDIDLLiteWriter   *writer,
+                                         GCancellable          *cancellable,
+                                         GError               **error);
+
 void
 gupnp_didl_lite_writer_filter           (GUPnPDIDLLiteWriter   *writer,
                                          const char            *filter);
 
+void
+gupnp_didl_lite_writer_apply_filter     (GUPnPDIDLLiteWriter   *writer,
+                                         GUPnPDIDLLiteFilter   *filter);
+
+void
+gupnp_didl_lite_writer_set_filter       (GUPnPDIDLLiteWriter   *writer,
+                                         GUPnPDIDLLiteFilter   *filter);
+
+GUPnPDIDLLiteFilter *
+gupnp_didl_lite_writer_get_filter       (GUPnPDIDLLiteWriter   *writer);
+
 G_END_DECLS
 
 #endif /* GUPNP_DIDL_LITE_WRITER_H */
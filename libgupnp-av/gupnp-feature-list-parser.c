@@ -22,10 +22,13 @@
 #include <string.h>
 #include "gupnp-feature-list-parser.h"
 #include "gupnp-av.h"
+#include "gupnp-av-string-dict-private.h"
 #include "xml-util.h"
 
 struct _GUPnPFeatureListParser {
         GObject parent;
+
+        GUPnPAVStringDict *string_dict;
 };
 
 /* GUPnPFeatureListParser */
@@ -33,16 +36,63 @@ G_DEFINE_TYPE (GUPnPFeatureListParser,
                gupnp_feature_list_parser,
                G_TYPE_OBJECT)
 
+enum {
+        PROP_0,
+        PROP_STRING_DICT
+};
+
 static void
 gupnp_feature_list_parser_init (G_GNUC_UNUSED GUPnPFeatureListParser *parser)
 {
         /* Nothing to do here */
 }
 
+static void
+gupnp_feature_list_parser_set_property (GObject      *object,
+                                        guint         property_id,
+                                        const GValue *value,
+                                        GParamSpec   *pspec)
+{
+        GUPnPFeatureListParser *parser = GUPNP_FEATURE_LIST_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STRING_DICT:
+                gupnp_feature_list_parser_set_string_dict
+                                        (parser, g_value_get_boxed (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
+static void
+gupnp_feature_list_parser_get_property (GObject    *object,
+                                        guint       property_id,
+                                        GValue     *value,
+                                        GParamSpec *pspec)
+{
+        GUPnPFeatureListParser *parser = GUPNP_FEATURE_LIST_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STRING_DICT:
+                g_value_set_boxed (value,
+                                   gupnp_feature_list_parser_get_string_dict
+                                        (parser));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
 static void
 gupnp_feature_list_parser_finalize (GObject *object)
 {
         GObjectClass *object_class;
+        GUPnPFeatureListParser *parser = GUPNP_FEATURE_LIST_PARSER (object);
+
+        g_clear_pointer (&parser->string_dict, gupnp_av_string_dict_unref);
 
         object_class = G_OBJECT_CLASS (gupnp_feature_list_parser_parent_class);
         object_class->finalize (object);
@@ -55,7 +105,31 @@ gupnp_feature_list_parser_class_init (GUPnPFeatureListParserClass *klass)
 
         object_class = G_OBJECT_CLASS (klass);
 
+        object_class->set_property = gupnp_feature_list_parser_set_property;
+        object_class->get_property = gupnp_feature_list_parser_get_property;
         object_class->finalize = gupnp_feature_list_parser_finalize;
+
+        /**
+         * GUPnPFeatureListParser:string-dict:
+         *
+         * The [struct@GUPnPAV.AVStringDict] to intern the names of parsed
+         * FeatureList documents in, or %NULL to give each document a
+         * dictionary of its own.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_STRING_DICT,
+                 g_param_spec_boxed ("string-dict",
+                                     "String dictionary",
+                                     "The dictionary shared by the parsed"
+                                     " documents.",
+                                     GUPNP_TYPE_AV_STRING_DICT,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_NAME |
+                                     G_PARAM_STATIC_NICK |
+                                     G_PARAM_STATIC_BLURB));
 }
 
 /**
@@ -107,7 +181,7 @@ get_feature_object_ids (xmlNode *feature)
  **/
 GList *
 gupnp_feature_list_parser_parse_text
-                                 (G_GNUC_UNUSED GUPnPFeatureListParser *parser,
+                                 (GUPnPFeatureListParser *parser,
                                   const char             *text,
                                   GError                **error)
 {
@@ -115,11 +189,21 @@ gupnp_feature_list_parser_parse_text
         xmlNode      *element;
         GList        *feature_list = NULL;
 
-        doc = xmlReadMemory (text,
-                             strlen (text),
-                             NULL,
-                             NULL,
-                             XML_PARSE_NONET | XML_PARSE_RECOVER);
+        g_return_val_if_fail (GUPNP_IS_FEATURE_LIST_PARSER (parser), NULL);
+        g_return_val_if_fail (text != NULL, NULL);
+
+        if (parser->string_dict != NULL)
+                doc = gupnp_av_string_dict_read_memory
+                                        (parser->string_dict,
+                                         text,
+                                         strlen (text),
+                                         XML_PARSE_NONET | XML_PARSE_RECOVER);
+        else
+                doc = xmlReadMemory (text,
+                                     strlen (text),
+                                     NULL,
+                                     NULL,
+                                     XML_PARSE_NONET | XML_PARSE_RECOVER);
         if (doc == NULL) {
                 g_set_error (error,
                              G_MARKUP_ERROR,
@@ -189,3 +273,49 @@ gupnp_feature_list_parser_parse_text
 
         return feature_list;
 }
+
+/**
+ * gupnp_feature_list_parser_set_string_dict:
+ * @parser: A #GUPnPFeatureListParser
+ * @dict: (nullable): A [struct@GUPnPAV.AVStringDict], or %NULL
+ *
+ * Makes @parser intern the names in the documents it parses in @dict instead
+ * of a dictionary private to each document. See
+ * #GUPnPFeatureListParser:string-dict.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_feature_list_parser_set_string_dict (GUPnPFeatureListParser *parser,
+                                           GUPnPAVStringDict      *dict)
+{
+        g_return_if_fail (GUPNP_IS_FEATURE_LIST_PARSER (parser));
+
+        if (parser->string_dict == dict)
+                return;
+
+        g_clear_pointer (&parser->string_dict, gupnp_av_string_dict_unref);
+        if (dict != NULL)
+                parser->string_dict = gupnp_av_string_dict_ref (dict);
+
+        g_object_notify (G_OBJECT (parser), "string-dict");
+}
+
+/**
+ * gupnp_feature_list_parser_get_string_dict:
+ * @parser: A #GUPnPFeatureListParser
+ *
+ * Get the dictionary @parser interns names in.
+ *
+ * Return value: (transfer none) (nullable): The [struct@GUPnPAV.AVStringDict],
+ * or %NULL.
+ *
+ * Since: 0.16
+ **/
+GUPnPAVStringDict *
+gupnp_feature_list_parser_get_string_dict (GUPnPFeatureListParser *parser)
+{
+        g_return_val_if_fail (GUPNP_IS_FEATURE_LIST_PARSER (parser), NULL);
+
+        return parser->string_dict;
+}
@@ -11,6 +11,7 @@
 #define GUPNP_FEATURE_LIST_PARSER_H
 
 #include <glib-object.h>
+#include "gupnp-av-string-dict.h"
 #include "gupnp-feature.h"
 
 G_BEGIN_DECLS
@@ -31,6 +32,15 @@ gupnp_feature_list_parser_parse_text (GUPnPFeatureListParser *parser,
                                       const char             *text,
                                       GError                 **error);
 
+void
+gupnp_feature_list_parser_set_string_dict
+                                     (GUPnPFeatureListParser *parser,
+                                      GUPnPAVStringDict      *dict);
+
+GUPnPAVStringDict *
+gupnp_feature_list_parser_get_string_dict
+                                     (GUPnPFeatureListParser *parser);
+
 G_END_DECLS
 
 #endif /* __GUPNP_FEATURE_LIST_PARSER_H_ */
@@ -20,26 +20,83 @@
  */
 #include <config.h>
 
+#include <string.h>
 
 #include <gobject/gvaluecollector.h>
 
 #include "gupnp-last-change-parser.h"
+#include "gupnp-av-string-dict-private.h"
 #include "gvalue-util.h"
 #include "xml-util.h"
 
-G_DEFINE_TYPE (GUPnPLastChangeParser,
-               gupnp_last_change_parser,
-               G_TYPE_OBJECT)
+struct _GUPnPLastChangeParserPrivate {
+        GUPnPAVStringDict *string_dict;
+};
+typedef struct _GUPnPLastChangeParserPrivate GUPnPLastChangeParserPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GUPnPLastChangeParser,
+                            gupnp_last_change_parser,
+                            G_TYPE_OBJECT)
+
+enum {
+        PROP_0,
+        PROP_STRING_DICT
+};
 
 static void
 gupnp_last_change_parser_init (G_GNUC_UNUSED GUPnPLastChangeParser *parser)
 {
 }
 
+static void
+gupnp_last_change_parser_set_property (GObject      *object,
+                                       guint         property_id,
+                                       const GValue *value,
+                                       GParamSpec   *pspec)
+{
+        GUPnPLastChangeParser *parser = GUPNP_LAST_CHANGE_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STRING_DICT:
+                gupnp_last_change_parser_set_string_dict
+                                        (parser, g_value_get_boxed (value));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
+static void
+gupnp_last_change_parser_get_property (GObject    *object,
+                                       guint       property_id,
+                                       GValue     *value,
+                                       GParamSpec *pspec)
+{
+        GUPnPLastChangeParser *parser = GUPNP_LAST_CHANGE_PARSER (object);
+
+        switch (property_id) {
+        case PROP_STRING_DICT:
+                g_value_set_boxed (value,
+                                   gupnp_last_change_parser_get_string_dict
+                                        (parser));
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+                break;
+        }
+}
+
 static void
 gupnp_last_change_parser_dispose (GObject *object)
 {
         GObjectClass   *gobject_class;
+        GUPnPLastChangeParserPrivate *priv;
+
+        priv = gupnp_last_change_parser_get_instance_private
+                                        (GUPNP_LAST_CHANGE_PARSER (object));
+
+        g_clear_pointer (&priv->string_dict, gupnp_av_string_dict_unref);
 
         gobject_class = G_OBJECT_CLASS (gupnp_last_change_parser_parent_class);
         gobject_class->dispose (object);
@@ -52,7 +109,31 @@ gupnp_last_change_parser_class_init (GUPnPLastChangeParserClass *klass)
 
         object_class = G_OBJECT_CLASS (klass);
 
+        object_class->set_property = gupnp_last_change_parser_set_property;
+        object_class->get_property = gupnp_last_change_parser_get_property;
         object_class->dispose = gupnp_last_change_parser_dispose;
+
+        /**
+         * GUPnPLastChangeParser:string-dict:
+         *
+         * The [struct@GUPnPAV.AVStringDict] to intern the names of parsed
+         * LastChange documents in, or %NULL to give each document a
+         * dictionary of its own.
+         *
+         * Since: 0.16
+         **/
+        g_object_class_install_property
+                (object_class,
+                 PROP_STRING_DICT,
+                 g_param_spec_boxed ("string-dict",
+                                     "String dictionary",
+                                     "The dictionary shared by the parsed"
+                                     " documents.",
+                                     GUPNP_TYPE_AV_STRING_DICT,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_STATIC_NAME |
+                                     G_PARAM_STATIC_NICK |
+                                     G_PARAM_STATIC_BLURB));
 }
 
 /* Reads a value of state variable @variable_name to an initialised GValue pair
@@ -138,19 +219,30 @@ gupnp_last_change_parser_new (void)
  **/
 gboolean
 gupnp_last_change_parser_parse_last_change_valist
-                         (G_GNUC_UNUSED GUPnPLastChangeParser *parser,
+                         (GUPnPLastChangeParser               *parser,
                           guint                                instance_id,
                           const char                          *last_change_xml,
                           GError                             **error,
                           va_list                              var_args)
 {
+        GUPnPLastChangeParserPrivate *priv;
         const char *variable_name;
         xmlDoc  *doc;
         xmlNode *instance_node;
 
+        g_return_val_if_fail (GUPNP_IS_LAST_CHANGE_PARSER (parser), FALSE);
         g_return_val_if_fail (last_change_xml, FALSE);
 
-        doc = xmlParseDoc ((const xmlChar *) last_change_xml);
+        priv = gupnp_last_change_parser_get_instance_private (parser);
+
+        if (priv->string_dict != NULL)
+                doc = gupnp_av_string_dict_read_memory
+                                        (priv->string_dict,
+                                         last_change_xml,
+                                         strlen (last_change_xml),
+                                         0);
+        else
+                doc = xmlParseDoc ((const xmlChar *) last_change_xml);
         if (doc == NULL) {
                 g_set_error (error,
                              G_MARKUP_ERROR,
@@ -244,3 +336,56 @@ gupnp_last_change_parser_parse_last_change
         return ret;
 }
 
+/**
+ * gupnp_last_change_parser_set_string_dict:
+ * @parser: A [class@GUPnPAV.LastChangeParser]
+ * @dict: (nullable): A [struct@GUPnPAV.AVStringDict], or %NULL
+ *
+ * Makes @parser intern the names in the documents it parses in @dict instead
+ * of a dictionary private to each document. See
+ * #GUPnPLastChangeParser:string-dict.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_last_change_parser_set_string_dict (GUPnPLastChangeParser *parser,
+                                          GUPnPAVStringDict     *dict)
+{
+        GUPnPLastChangeParserPrivate *priv;
+
+        g_return_if_fail (GUPNP_IS_LAST_CHANGE_PARSER (parser));
+
+        priv = gupnp_last_change_parser_get_instance_private (parser);
+
+        if (priv->string_dict == dict)
+                return;
+
+        g_clear_pointer (&priv->string_dict, gupnp_av_string_dict_unref);
+        if (dict != NULL)
+                priv->string_dict = gupnp_av_string_dict_ref (dict);
+
+        g_object_notify (G_OBJECT (parser), "string-dict");
+}
+
+/**
+ * gupnp_last_change_parser_get_string_dict:
+ * @parser: A [class@GUPnPAV.LastChangeParser]
+ *
+ * Get the dictionary @parser interns names in.
+ *
+ * Return value: (transfer none) (nullable): The [struct@GUPnPAV.AVStringDict],
+ * or %NULL.
+ *
+ * Since: 0.16
+ **/
+GUPnPAVStringDict *
+gupnp_last_change_parser_get_string_dict (GUPnPLastChangeParser *parser)
+{
+        GUPnPLastChangeParserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_IS_LAST_CHANGE_PARSER (parser), NULL);
+
+        priv = gupnp_last_change_parser_get_instance_private (parser);
+
+        return priv->string_dict;
+}
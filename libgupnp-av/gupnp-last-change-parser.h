@@ -14,6 +14,8 @@
 
 #include <glib-object.h>
 
+#include "gupnp-av-string-dict.h"
+
 G_BEGIN_DECLS
 
 G_DECLARE_DERIVABLE_TYPE (GUPnPLastChangeParser,
@@ -53,6 +55,15 @@ gupnp_last_change_parser_parse_last_change
                                         GError               **error,
                                         ...) G_GNUC_NULL_TERMINATED;
 
+void
+gupnp_last_change_parser_set_string_dict
+                                       (GUPnPLastChangeParser *parser,
+                                        GUPnPAVStringDict     *dict);
+
+GUPnPAVStringDict *
+gupnp_last_change_parser_get_string_dict
+                                       (GUPnPLastChangeParser *parser);
+
 G_END_DECLS
 
 #endif /* __GUPNP_LAST_CHANGE_PARSER_H__ */
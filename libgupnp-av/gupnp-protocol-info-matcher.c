@@ -0,0 +1,247 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+/**
+ * GUPnPProtocolInfoMatcher:
+ *
+ * A parsed SinkProtocolInfo list
+ *
+ * A [struct@GUPnPAV.ProtocolInfoMatcher] parses the protocols a
+ * MediaRenderer can play once and groups them by MIME type, so checking a
+ * resource against it only compares with the few protocols that could
+ * possibly match. Create one per renderer and pass it to
+ * gupnp_didl_lite_object_get_compat_resource_with_matcher() for every object
+ * instead of handing the SinkProtocolInfo string to
+ * gupnp_didl_lite_object_get_compat_resource().
+ *
+ * A matcher is immutable once created and can be shared between threads.
+ *
+ * Since: 0.16
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "gupnp-protocol-info-matcher.h"
+
+struct _GUPnPProtocolInfoMatcher {
+        /* All the parsed protocols, in the order of the sink list */
+        GPtrArray  *infos;
+
+        /* Lower-cased MIME type to the protocols with that type. The
+         * arrays do not hold references of their own. */
+        GHashTable *by_mime_type;
+
+        /* Protocols accepting any MIME type */
+        GPtrArray  *any_mime_type;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPProtocolInfoMatcher,
+                     gupnp_protocol_info_matcher,
+                     gupnp_protocol_info_matcher_ref,
+                     gupnp_protocol_info_matcher_unref)
+
+/* The bucket of a MIME type. LPCM types carry parameters that
+ * gupnp_protocol_info_is_compatible() ignores, so they all share one. */
+static char *
+mime_type_key (const char *mime_type)
+{
+        if (g_ascii_strncasecmp (mime_type, "audio/L16", 9) == 0)
+                return g_strdup ("audio/l16");
+
+        return g_ascii_strdown (mime_type, -1);
+}
+
+/**
+ * gupnp_protocol_info_matcher_new:
+ * @sink_protocol_info: A comma-separated list of protocolInfo strings, as
+ * found in the 'Sink' argument of the 'GetProtocolInfo' action
+ *
+ * Parse @sink_protocol_info into a [struct@GUPnPAV.ProtocolInfoMatcher].
+ * Entries that are not valid protocolInfo strings are ignored.
+ *
+ * Returns: (transfer full): A new [struct@GUPnPAV.ProtocolInfoMatcher].
+ *
+ * Since: 0.16
+ **/
+GUPnPProtocolInfoMatcher *
+gupnp_protocol_info_matcher_new (const char *sink_protocol_info)
+{
+        GUPnPProtocolInfoMatcher *matcher;
+        char **protocols;
+        char **it;
+
+        g_return_val_if_fail (sink_protocol_info != NULL, NULL);
+
+        matcher = g_atomic_rc_box_new0 (GUPnPProtocolInfoMatcher);
+        matcher->infos = g_ptr_array_new_with_free_func (g_object_unref);
+        matcher->by_mime_type = g_hash_table_new_full
+                                        (g_str_hash,
+                                         g_str_equal,
+                                         g_free,
+                                         (GDestroyNotify) g_ptr_array_unref);
+        matcher->any_mime_type = g_ptr_array_new ();
+
+        protocols = g_strsplit (sink_protocol_info, ",", -1);
+        for (it = protocols; *it != NULL; it++) {
+                GUPnPProtocolInfo *info;
+                const char *mime_type;
+                GPtrArray *bucket;
+                char *key;
+
+                info = gupnp_protocol_info_new_from_string (*it, NULL);
+                if (info == NULL)
+                        continue;
+
+                g_ptr_array_add (matcher->infos, info);
+
+                mime_type = gupnp_protocol_info_get_mime_type (info);
+                if (mime_type[0] == '*') {
+                        g_ptr_array_add (matcher->any_mime_type, info);
+
+                        continue;
+                }
+
+                key = mime_type_key (mime_type);
+                bucket = g_hash_table_lookup (matcher->by_mime_type, key);
+                if (bucket == NULL) {
+                        bucket = g_ptr_array_new ();
+                        g_hash_table_insert (matcher->by_mime_type,
+                                             key,
+                                             bucket);
+                } else {
+                        g_free (key);
+                }
+
+                g_ptr_array_add (bucket, info);
+        }
+        g_strfreev (protocols);
+
+        return matcher;
+}
+
+/**
+ * gupnp_protocol_info_matcher_ref:
+ * @matcher: A [struct@GUPnPAV.ProtocolInfoMatcher]
+ *
+ * Increase reference count of a [struct@GUPnPAV.ProtocolInfoMatcher].
+ *
+ * Returns: (transfer full): The object passed in @matcher.
+ *
+ * Since: 0.16
+ **/
+GUPnPProtocolInfoMatcher *
+gupnp_protocol_info_matcher_ref (GUPnPProtocolInfoMatcher *matcher)
+{
+        g_return_val_if_fail (matcher != NULL, NULL);
+
+        return g_atomic_rc_box_acquire (matcher);
+}
+
+static void
+protocol_info_matcher_free (GUPnPProtocolInfoMatcher *matcher)
+{
+        g_hash_table_destroy (matcher->by_mime_type);
+        g_ptr_array_unref (matcher->any_mime_type);
+        g_ptr_array_unref (matcher->infos);
+}
+
+/**
+ * gupnp_protocol_info_matcher_unref:
+ * @matcher: A [struct@GUPnPAV.ProtocolInfoMatcher]
+ *
+ * Decrease reference count of a [struct@GUPnPAV.ProtocolInfoMatcher]. If the
+ * reference count drops to 0, @matcher is freed.
+ *
+ * Since: 0.16
+ **/
+void
+gupnp_protocol_info_matcher_unref (GUPnPProtocolInfoMatcher *matcher)
+{
+        g_return_if_fail (matcher != NULL);
+
+        g_atomic_rc_box_release_full
+                                (matcher,
+                                 (GDestroyNotify) protocol_info_matcher_free);
+}
+
+/**
+ * gupnp_protocol_info_matcher_get_length:
+ * @matcher: A [struct@GUPnPAV.ProtocolInfoMatcher]
+ *
+ * Get the number of valid protocolInfo strings in the sink list @matcher was
+ * created from.
+ *
+ * Returns: The number of protocols in @matcher.
+ *
+ * Since: 0.16
+ **/
+guint
+gupnp_protocol_info_matcher_get_length (GUPnPProtocolInfoMatcher *matcher)
+{
+        g_return_val_if_fail (matcher != NULL, 0);
+
+        return matcher->infos->len;
+}
+
+static gboolean
+any_compatible (GPtrArray         *infos,
+                GUPnPProtocolInfo *info)
+{
+        guint i;
+
+        if (infos == NULL)
+                return FALSE;
+
+        for (i = 0; i < infos->len; i++)
+                if (gupnp_protocol_info_is_compatible
+                                        (g_ptr_array_index (infos, i), info))
+                        return TRUE;
+
+        return FALSE;
+}
+
+/**
+ * gupnp_protocol_info_matcher_is_compatible:
+ * @matcher: A [struct@GUPnPAV.ProtocolInfoMatcher]
+ * @info: The #GUPnPProtocolInfo of a resource
+ *
+ * Checks whether @info is compatible with any of the protocols of @matcher,
+ * in the sense of gupnp_protocol_info_is_compatible().
+ *
+ * Returns: %TRUE if the sink can play a resource with @info, %FALSE
+ * otherwise.
+ *
+ * Since: 0.16
+ **/
+gboolean
+gupnp_protocol_info_matcher_is_compatible (GUPnPProtocolInfoMatcher *matcher,
+                                           GUPnPProtocolInfo        *info)
+{
+        const char *mime_type;
+        gboolean ret;
+        char *key;
+
+        g_return_val_if_fail (matcher != NULL, FALSE);
+        g_return_val_if_fail (GUPNP_IS_PROTOCOL_INFO (info), FALSE);
+
+        mime_type = gupnp_protocol_info_get_mime_type (info);
+        if (mime_type == NULL)
+                return FALSE;
+
+        if (mime_type[0] == '*')
+                return any_compatible (matcher->infos, info);
+
+        if (any_compatible (matcher->any_mime_type, info))
+                return TRUE;
+
+        key = mime_type_key (mime_type);
+        ret = any_compatible (g_hash_table_lookup (matcher->by_mime_type, key),
+                              info);
+        g_free (key);
+
+        return ret;
+}
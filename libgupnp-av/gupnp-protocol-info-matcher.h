@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#ifndef GUPNP_PROTOCOL_INFO_MATCHER_H
+#define GUPNP_PROTOCOL_INFO_MATCHER_H
+
+#include <glib-object.h>
+
+#include "gupnp-protocol-info.h"
+
+G_BEGIN_DECLS
+
+GType
+gupnp_protocol_info_matcher_get_type (void) G_GNUC_CONST;
+
+#define GUPNP_TYPE_PROTOCOL_INFO_MATCHER \
+                (gupnp_protocol_info_matcher_get_type ())
+
+typedef struct _GUPnPProtocolInfoMatcher GUPnPProtocolInfoMatcher;
+
+GUPnPProtocolInfoMatcher *
+gupnp_protocol_info_matcher_new         (const char *sink_protocol_info);
+
+GUPnPProtocolInfoMatcher *
+gupnp_protocol_info_matcher_ref         (GUPnPProtocolInfoMatcher *matcher);
+
+void
+gupnp_protocol_info_matcher_unref       (GUPnPProtocolInfoMatcher *matcher);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GUPnPProtocolInfoMatcher,
+                               gupnp_protocol_info_matcher_unref)
+
+guint
+gupnp_protocol_info_matcher_get_length  (GUPnPProtocolInfoMatcher *matcher);
+
+gboolean
+gupnp_protocol_info_matcher_is_compatible
+                                        (GUPnPProtocolInfoMatcher *matcher,
+                                         GUPnPProtocolInfo        *info);
+
+G_END_DECLS
+
+#endif /* __GUPNP_PROTOCOL_INFO_MATCHER_H__ */
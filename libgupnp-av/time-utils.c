@@ -9,12 +9,15 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include <glib.h>
 
 #include "time-utils.h"
 
 #define SEC_PER_MIN 60
 #define SEC_PER_HOUR 3600
+#define SEC_PER_DAY 86400
 
 long
 seconds_from_time (const char *time_str)
@@ -56,3 +59,238 @@ seconds_to_time (long seconds)
 
         return str;
 }
+
+/* Reads between @min and @max digits into @value, returns the position
+ * after them or NULL */
+static const char *
+parse_digits (const char *str,
+              int         min,
+              int         max,
+              int        *value)
+{
+        int count = 0;
+
+        *value = 0;
+        while (count < max && g_ascii_isdigit (str[count])) {
+                *value = *value * 10 + (str[count] - '0');
+                count++;
+        }
+
+        if (count < min)
+                return NULL;
+
+        return str + count;
+}
+
+/* Reads the leading YYYY-M(M)-D(D) of @date_string into @fields, without
+ * checking the ranges of the values. Returns the position after the date,
+ * or NULL if @date_string does not start with a date. */
+static const char *
+date_time_parse_date (const char     *date_string,
+                      DateTimeFields *fields)
+{
+        const char *ptr = date_string;
+
+        memset (fields, 0, sizeof (DateTimeFields));
+
+        ptr = parse_digits (ptr, 4, 4, &fields->year);
+        if (ptr == NULL || *ptr != '-')
+                return NULL;
+
+        ptr = parse_digits (ptr + 1, 1, 2, &fields->month);
+        if (ptr == NULL || *ptr != '-')
+                return NULL;
+
+        return parse_digits (ptr + 1, 1, 2, &fields->day);
+}
+
+static gboolean
+is_leap_year (int year)
+{
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int
+days_in_month (int year,
+               int month)
+{
+        static const int days[] = {
+                31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+        };
+
+        if (month == 2 && is_leap_year (year))
+                return 29;
+
+        return days[month - 1];
+}
+
+/* Parses all of @date_string, i.e. a date optionally followed by
+ * "Thh:mm[:ss[.fraction]]" and "Z" or "+hh[:mm]"/"-hh[:mm]", without
+ * allocating. Returns FALSE unless every part is in range. */
+gboolean
+date_time_parse (const char     *date_string,
+                 DateTimeFields *fields)
+{
+        const char *ptr;
+
+        if (date_string == NULL)
+                return FALSE;
+
+        ptr = date_time_parse_date (date_string, fields);
+        if (ptr == NULL)
+                return FALSE;
+
+        if (fields->month < 1 || fields->month > 12 ||
+            fields->day < 1 ||
+            fields->day > days_in_month (fields->year, fields->month))
+                return FALSE;
+
+        if (*ptr == '\0')
+                return TRUE;
+
+        if (*ptr != 'T')
+                return FALSE;
+
+        fields->has_time = TRUE;
+        ptr = parse_digits (ptr + 1, 2, 2, &fields->hour);
+        if (ptr == NULL || *ptr != ':')
+                return FALSE;
+
+        ptr = parse_digits (ptr + 1, 2, 2, &fields->minute);
+        if (ptr == NULL)
+                return FALSE;
+
+        if (*ptr == ':') {
+                ptr = parse_digits (ptr + 1, 2, 2, &fields->second);
+                if (ptr == NULL)
+                        return FALSE;
+
+                if (*ptr == '.') {
+                        int scale = 100000;
+
+                        ptr++;
+                        if (!g_ascii_isdigit (*ptr))
+                                return FALSE;
+
+                        /* Anything below a microsecond is dropped */
+                        for (; g_ascii_isdigit (*ptr); ptr++) {
+                                fields->microsecond += (*ptr - '0') * scale;
+                                scale /= 10;
+                        }
+                }
+        }
+
+        if (fields->hour > 23 || fields->minute > 59 || fields->second > 59)
+                return FALSE;
+
+        if (*ptr == 'Z') {
+                fields->has_utc_offset = TRUE;
+                ptr++;
+        } else if (*ptr == '+' || *ptr == '-') {
+                int sign = *ptr == '-' ? -1 : 1;
+                int hours;
+                int minutes = 0;
+
+                ptr = parse_digits (ptr + 1, 2, 2, &hours);
+                if (ptr == NULL)
+                        return FALSE;
+
+                if (*ptr == ':')
+                        ptr++;
+                if (g_ascii_isdigit (*ptr)) {
+                        ptr = parse_digits (ptr, 2, 2, &minutes);
+                        if (ptr == NULL)
+                                return FALSE;
+                }
+
+                if (hours > 23 || minutes > 59)
+                        return FALSE;
+
+                fields->has_utc_offset = TRUE;
+                fields->utc_offset = sign * (hours * SEC_PER_HOUR +
+                                             minutes * SEC_PER_MIN);
+        }
+
+        return *ptr == '\0';
+}
+
+/* Days since 1970-01-01 of a date in the proleptic Gregorian calendar */
+static gint64
+days_from_civil (gint64 year,
+                 int    month,
+                 int    day)
+{
+        gint64 era;
+        int year_of_era;
+        int day_of_year;
+        int day_of_era;
+
+        if (month <= 2)
+                year--;
+        era = (year >= 0 ? year : year - 399) / 400;
+        year_of_era = (int) (year - era * 400);
+        day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 +
+                      day - 1;
+        day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 +
+                     day_of_year;
+
+        return era * 146097 + day_of_era - 719468;
+}
+
+/* Microseconds since the Unix epoch of the instant in @fields. Dates
+ * without a UTC offset are taken to be in UTC. */
+gint64
+date_time_to_unix_usec (const DateTimeFields *fields)
+{
+        gint64 seconds;
+
+        seconds = days_from_civil (fields->year, fields->month, fields->day) *
+                  SEC_PER_DAY;
+        seconds += fields->hour * SEC_PER_HOUR +
+                   fields->minute * SEC_PER_MIN +
+                   fields->second;
+        seconds -= fields->utc_offset;
+
+        return seconds * G_USEC_PER_SEC + fields->microsecond;
+}
+
+/* Formats @fields the way DLNA wants dc:date, with the time in
+ * milliseconds at most */
+char *
+date_time_format (const DateTimeFields *fields,
+                  gboolean              date_only)
+{
+        char fraction[8] = "";
+        char offset[8] = "Z";
+
+        if (date_only)
+                return g_strdup_printf ("%d-%02d-%02d",
+                                        fields->year,
+                                        fields->month,
+                                        fields->day);
+
+        if (fields->microsecond != 0)
+                g_snprintf (fraction,
+                            sizeof (fraction),
+                            ".%03d",
+                            fields->microsecond / 1000);
+
+        if (fields->utc_offset != 0)
+                g_snprintf (offset,
+                            sizeof (offset),
+                            "%c%02d:%02d",
+                            fields->utc_offset < 0 ? '-' : '+',
+                            ABS (fields->utc_offset) / SEC_PER_HOUR,
+                            ABS (fields->utc_offset) % SEC_PER_HOUR /
+                            SEC_PER_MIN);
+
+        return g_strdup_printf ("%d-%02d-%02dT%02d:%02d:%02d%s%s",
+                                fields->year,
+                                fields->month,
+                                fields->day,
+                                fields->hour,
+                                fields->minute,
+                                fields->second,
+                                fraction,
+                                offset);
+}
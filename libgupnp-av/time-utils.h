@@ -12,12 +12,38 @@
 
 G_BEGIN_DECLS
 
+/* The parts of a date as found in dc:date, i.e. an ISO 8601 date with an
+ * optional time and UTC offset */
+typedef struct {
+        int      year;
+        int      month;
+        int      day;
+        gboolean has_time;
+        int      hour;
+        int      minute;
+        int      second;
+        int      microsecond;
+        gboolean has_utc_offset;
+        int      utc_offset; /* In seconds east of UTC */
+} DateTimeFields;
+
 G_GNUC_INTERNAL long
 seconds_from_time (const char *time_string);
 
 G_GNUC_INTERNAL char *
 seconds_to_time (long seconds);
 
+G_GNUC_INTERNAL gboolean
+date_time_parse (const char     *date_string,
+                 DateTimeFields *fields);
+
+G_GNUC_INTERNAL gint64
+date_time_to_unix_usec (const DateTimeFields *fields);
+
+G_GNUC_INTERNAL char *
+date_time_format (const DateTimeFields *fields,
+                  gboolean              date_only);
+
 G_END_DECLS
 
 #endif /* __TIME_UTILS_H__ */
@@ -44,6 +44,7 @@ av_xml_doc_new (xmlDoc *doc)
 
         ret = g_rc_box_new0(GUPnPAVXMLDoc);
         ret->doc = doc;
+        doc->_private = ret;
 
         return ret;
 }
@@ -60,6 +61,20 @@ av_xml_doc_unref (GUPnPAVXMLDoc *doc)
         g_rc_box_release_full (doc, (GFreeFunc) av_xml_doc_free);
 }
 
+/* Marks the structure of @doc as changed, if it is wrapped in a
+ * GUPnPAVXMLDoc */
+void
+av_xml_doc_touch (xmlDoc *doc)
+{
+        GUPnPAVXMLDoc *xml_doc;
+
+        if (doc == NULL || doc->_private == NULL)
+                return;
+
+        xml_doc = (GUPnPAVXMLDoc *) doc->_private;
+        xml_doc->generation++;
+}
+
 xmlNode *
 av_xml_util_get_element (xmlNode *node,
                          ...)
@@ -270,6 +285,7 @@ av_xml_util_set_child (xmlNode    *parent_node,
                                     ns_ptr,
                                     (unsigned char *) name,
                                     NULL);
+                av_xml_doc_touch (parent_node->doc);
         }
 
         escaped = xmlEncodeSpecialChars (doc, (const unsigned char *) value);
@@ -289,6 +305,7 @@ av_xml_util_unset_child (xmlNode    *parent_node,
         if (node != NULL) {
                 xmlUnlinkNode (node);
                 xmlFreeNode (node);
+                av_xml_doc_touch (parent_node->doc);
         }
 }
 
@@ -318,25 +335,141 @@ av_xml_util_get_child_string (xmlNode    *parent_node,
                               xmlDoc     *doc,
                               const char *name)
 {
-        xmlBuffer *buffer;
-        char      *ret;
-        xmlNode   *node;
+        GString *string;
+        xmlNode *node;
 
         node = av_xml_util_get_element (parent_node, name, NULL);
         if (!node)
                 return NULL;
 
+        string = g_string_new (NULL);
+        av_xml_util_dump_node_to_string (string, doc, node);
+
+        return g_string_free (string, FALSE);
+}
+
+static int
+string_write_cb (void       *context,
+                 const char *buffer,
+                 int         len)
+{
+        g_string_append_len ((GString *) context, buffer, len);
+
+        return len;
+}
+
+/* Serializes @node into @string without an intermediate copy of the whole
+ * serialization */
+void
+av_xml_util_dump_node_to_string (GString *string,
+                                 xmlDoc  *doc,
+                                 xmlNode *node)
+{
+        xmlOutputBuffer *output;
+
+        output = xmlOutputBufferCreateIO (string_write_cb, NULL, string, NULL);
+        if (output == NULL)
+                return;
+
+        xmlNodeDumpOutput (output, doc, node, 0, 0, NULL);
+        xmlOutputBufferClose (output);
+}
+
+/* Serializes @node into a GBytes that takes over the buffer of libxml2 */
+GBytes *
+av_xml_util_dump_node_to_bytes (xmlDoc  *doc,
+                                xmlNode *node)
+{
+        xmlBuffer *buffer;
+        xmlChar   *content;
+        gsize      length;
+
         buffer = xmlBufferCreate ();
-        xmlNodeDump (buffer,
-                     doc,
-                     node,
-                     0,
-                     0);
-        ret = g_strndup ((char *) xmlBufferContent (buffer),
-                         xmlBufferLength (buffer));
+        xmlNodeDump (buffer, doc, node, 0, 0);
+        length = xmlBufferLength (buffer);
+        content = xmlBufferDetach (buffer);
         xmlBufferFree (buffer);
 
-        return ret;
+        if (content == NULL)
+                return g_bytes_new (NULL, 0);
+
+        return g_bytes_new_with_free_func (content,
+                                           length,
+                                           (GDestroyNotify) xmlFree,
+                                           content);
+}
+
+typedef struct {
+        GOutputStream *stream;
+        GCancellable  *cancellable;
+        GError        *error;
+} StreamWriteContext;
+
+static int
+stream_write_cb (void       *context,
+                 const char *buffer,
+                 int         len)
+{
+        StreamWriteContext *ctx = context;
+
+        if (ctx->error != NULL)
+                return -1;
+
+        if (!g_output_stream_write_all (ctx->stream,
+                                        buffer,
+                                        len,
+                                        NULL,
+                                        ctx->cancellable,
+                                        &ctx->error))
+                return -1;
+
+        return len;
+}
+
+/* Serializes @node to @stream, a few kilobytes at a time */
+gboolean
+av_xml_util_dump_node_to_stream (GOutputStream *stream,
+                                 xmlDoc        *doc,
+                                 xmlNode       *node,
+                                 GCancellable  *cancellable,
+                                 GError       **error)
+{
+        StreamWriteContext context = { stream, cancellable, NULL };
+        xmlOutputBuffer *output;
+        int ret;
+
+        output = xmlOutputBufferCreateIO (stream_write_cb,
+                                          NULL,
+                                          &context,
+                                          NULL);
+        if (output == NULL) {
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_FAILED,
+                                     "Could not create XML output buffer");
+
+                return FALSE;
+        }
+
+        xmlNodeDumpOutput (output, doc, node, 0, 0, NULL);
+        ret = xmlOutputBufferClose (output);
+
+        if (context.error != NULL) {
+                g_propagate_error (error, context.error);
+
+                return FALSE;
+        }
+
+        if (ret < 0) {
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_FAILED,
+                                     "Could not serialize XML");
+
+                return FALSE;
+        }
+
+        return TRUE;
 }
 
 gboolean
@@ -424,16 +557,189 @@ av_xml_util_find_node (xmlNode *haystack,
         return NULL;
 }
 
+/* Whether anything in the subtree of @node refers to @ns */
+static gboolean
+namespace_is_used (xmlNode *node,
+                   xmlNs   *ns)
+{
+        xmlAttr *attr;
+        xmlNode *child;
+
+        if (node->ns == ns)
+                return TRUE;
+
+        for (attr = node->properties; attr != NULL; attr = attr->next)
+                if (attr->ns == ns)
+                        return TRUE;
+
+        for (child = node->children; child != NULL; child = child->next)
+                if (child->type == XML_ELEMENT_NODE &&
+                    namespace_is_used (child, ns))
+                        return TRUE;
+
+        return FALSE;
+}
+
+/* Drops the namespace declarations in the subtree of @node that nothing
+ * refers to */
+static void
+remove_unused_namespaces (xmlNode *node)
+{
+        xmlNs  **link;
+        xmlNode *child;
+
+        link = &node->nsDef;
+        while (*link != NULL) {
+                xmlNs *ns = *link;
+
+                if (namespace_is_used (node, ns)) {
+                        link = &ns->next;
+
+                        continue;
+                }
+
+                *link = ns->next;
+                ns->next = NULL;
+                xmlFreeNs (ns);
+        }
+
+        for (child = node->children; child != NULL; child = child->next)
+                if (child->type == XML_ELEMENT_NODE)
+                        remove_unused_namespaces (child);
+}
+
 xmlNode *
 av_xml_util_copy_node (xmlNode *node)
 {
         xmlNode *dup = xmlCopyNode (node, 1);
 
-        /* TODO: remove useless namespace definition. */
+        if (dup != NULL)
+                remove_unused_namespaces (dup);
 
         return dup;
 }
 
+static xmlNs *
+remap_ns (xmlNs   *ns,
+          xmlNode *node,
+          xmlNs   *old_defs,
+          xmlNs   *new_defs)
+{
+        if (ns == NULL)
+                return NULL;
+
+        for (; old_defs != NULL && new_defs != NULL;
+             old_defs = old_defs->next, new_defs = new_defs->next)
+                if (ns == old_defs)
+                        return new_defs;
+
+        /* The implicit xml namespace belongs to the document */
+        if (xmlStrEqual (ns->href, XML_XML_NAMESPACE))
+                return xmlSearchNs (node->doc, node, (const xmlChar *) "xml");
+
+        return ns;
+}
+
+static void
+remap_ns_tree (xmlNode *node,
+               xmlNs   *old_defs,
+               xmlNs   *new_defs)
+{
+        xmlAttr *attr;
+        xmlNode *child;
+
+        node->ns = remap_ns (node->ns, node, old_defs, new_defs);
+        for (attr = node->properties; attr != NULL; attr = attr->next)
+                attr->ns = remap_ns (attr->ns, node, old_defs, new_defs);
+
+        for (child = node->children; child != NULL; child = child->next)
+                if (child->type == XML_ELEMENT_NODE)
+                        remap_ns_tree (child, old_defs, new_defs);
+}
+
+/**
+ * av_xml_util_move_node_to_new_doc:
+ * @node: An element below @root
+ * @root: The root element of @node's document
+ *
+ * Unlinks @node and re-parents it below a shallow copy of @root in a new
+ * document sharing the dictionary of the old one. References to namespaces
+ * declared on @root are rewritten to point to the copied declarations, so
+ * the old document may be freed afterwards.
+ *
+ * Returns: The root element of the new document.
+ */
+xmlNode *
+av_xml_util_move_node_to_new_doc (xmlNode *node,
+                                  xmlNode *root)
+{
+        xmlDoc  *doc;
+        xmlNode *new_root;
+
+        doc = xmlNewDoc ((const xmlChar *) "1.0");
+
+        /* Names and short text nodes may be interned in the dictionary */
+        if (root->doc->dict != NULL) {
+                doc->dict = root->doc->dict;
+                xmlDictReference (doc->dict);
+        }
+
+        new_root = xmlNewDocNode (doc, NULL, root->name, NULL);
+        new_root->nsDef = xmlCopyNamespaceList (root->nsDef);
+        xmlDocSetRootElement (doc, new_root);
+        new_root->ns = remap_ns (root->ns, new_root, root->nsDef, new_root->nsDef);
+
+        xmlUnlinkNode (node);
+        xmlAddChild (new_root, node);
+        remap_ns_tree (node, root->nsDef, new_root->nsDef);
+
+        return new_root;
+}
+
+/**
+ * av_xml_util_copy_node_to_new_doc:
+ * @node: An element below @root
+ * @root: The root element of @node's document
+ *
+ * Copies @node below a new element named like @root in a new document. The
+ * new document only declares the namespaces the copy uses, and shares
+ * nothing with the old one.
+ *
+ * Returns: The root element of the new document.
+ */
+xmlNode *
+av_xml_util_copy_node_to_new_doc (xmlNode *node,
+                                  xmlNode *root)
+{
+        xmlDoc  *doc;
+        xmlNode *new_root;
+        xmlNode *copy;
+
+        doc = xmlNewDoc ((const xmlChar *) "1.0");
+        new_root = xmlNewDocNode (doc, NULL, root->name, NULL);
+        xmlDocSetRootElement (doc, new_root);
+
+        /* Namespaces declared outside of @node are declared again on the
+         * copy, but only if the copy uses them */
+        copy = xmlDocCopyNode (node, doc, 1);
+        xmlAddChild (new_root, copy);
+        remove_unused_namespaces (copy);
+
+        /* Move them up so they are in scope for later additions, too */
+        new_root->nsDef = copy->nsDef;
+        copy->nsDef = NULL;
+
+        if (root->ns != NULL) {
+                new_root->ns = xmlSearchNsByHref (doc, new_root, root->ns->href);
+                if (new_root->ns == NULL)
+                        new_root->ns = xmlNewNs (new_root,
+                                                 root->ns->href,
+                                                 root->ns->prefix);
+        }
+
+        return new_root;
+}
+
 GHashTable *
 av_xml_util_get_attributes_map (xmlNode *node)
 {
@@ -467,54 +773,145 @@ av_xml_util_create_namespace (xmlNodePtr root, GUPnPXMLNamespace ns)
                          (const xmlChar *) gupnp_xml_namespaces[ns].prefix);
 }
 
+/* Whether the declaration @ns on a document root is the one of @id */
+static gboolean
+namespace_matches (xmlNs *ns, GUPnPXMLNamespace id)
+{
+        const char *prefix = gupnp_xml_namespaces[id].prefix;
+
+        /* The default namespace is recognized by its URI, the others by
+         * their prefix */
+        if (ns->prefix == NULL)
+                return prefix == NULL &&
+                       ns->href != NULL &&
+                       g_ascii_strcasecmp ((const char *) ns->href,
+                                           gupnp_xml_namespaces[id].uri) == 0;
+
+        return prefix != NULL &&
+               g_ascii_strcasecmp ((const char *) ns->prefix, prefix) == 0;
+}
+
 /**
- * av_xml_util_lookup_namespace:
+ * av_xml_util_resolve_namespaces:
  * @doc: #xmlDoc
- * @ns: namespace to look up (except DIDL-Lite, which doesn't have a prefix)
- * @returns: %NULL if namespace does not exist, a pointer to the namespace
- * otherwise.
+ * @namespaces: (inout): namespaces known so far
+ *
+ * Fills in all entries of @namespaces that are still %NULL and declared on
+ * the root element of @doc, in a single walk over its declarations. Entries
+ * already set are left alone.
  */
-xmlNsPtr
-av_xml_util_lookup_namespace (xmlDocPtr doc, GUPnPXMLNamespace ns)
+void
+av_xml_util_resolve_namespaces (xmlDocPtr doc, GUPnPAVXMLNamespaces *namespaces)
 {
-        xmlNsPtr *ns_list, *it, retval = NULL;
-        const char *ns_prefix = NULL;
-        const char *ns_uri = NULL;
-
-        g_return_val_if_fail (ns < GUPNP_XML_NAMESPACE_COUNT, NULL);
+        xmlNode *root;
+        xmlNs *it;
+        guint missing = 0;
+        guint i;
 
-        ns_prefix = gupnp_xml_namespaces[ns].prefix;
-        ns_uri = gupnp_xml_namespaces[ns].uri;
+        g_return_if_fail (namespaces != NULL);
 
-        ns_list = xmlGetNsList (doc, xmlDocGetRootElement (doc));
-        if (ns_list == NULL)
-                return NULL;
+        for (i = 0; i < GUPNP_XML_NAMESPACE_COUNT; i++)
+                if (namespaces->ns[i] == NULL)
+                        missing++;
 
-        for (it = ns_list; *it != NULL; it++) {
-                const char *it_prefix = (const char *) (*it)->prefix;
-                const char *it_uri = (const char *) (*it)->href;
+        root = xmlDocGetRootElement (doc);
+        if (missing == 0 || root == NULL)
+                return;
 
-                if (it_prefix == NULL) {
-                        if (ns_prefix != NULL)
+        for (it = root->nsDef; it != NULL && missing > 0; it = it->next) {
+                for (i = 0; i < GUPNP_XML_NAMESPACE_COUNT; i++) {
+                        if (!namespace_matches (it, i))
                                 continue;
 
-                        if (g_ascii_strcasecmp (it_uri, ns_uri) == 0) {
-                                retval = *it;
-                                break;
+                        /* The first declaration wins, like xmlGetNsList()
+                         * does */
+                        if (namespaces->ns[i] == NULL) {
+                                namespaces->ns[i] = it;
+                                missing--;
                         }
 
-                        continue;
-                }
-
-                if (g_ascii_strcasecmp (it_prefix, ns_prefix) == 0) {
-                        retval = *it;
                         break;
                 }
         }
+}
+
+/**
+ * av_xml_util_ensure_namespaces:
+ * @doc: #xmlDoc
+ * @namespaces: (inout): namespaces known so far
+ *
+ * Like av_xml_util_resolve_namespaces(), but additionally creates the
+ * prefixed namespaces missing from @doc on its root element. The default
+ * DIDL-Lite namespace is only looked up, never created.
+ */
+void
+av_xml_util_ensure_namespaces (xmlDocPtr doc, GUPnPAVXMLNamespaces *namespaces)
+{
+        /* Kept in the order the declarations were always added in */
+        static const GUPnPXMLNamespace prefixed[] = {
+                GUPNP_XML_NAMESPACE_UPNP,
+                GUPNP_XML_NAMESPACE_DC,
+                GUPNP_XML_NAMESPACE_DLNA,
+                GUPNP_XML_NAMESPACE_PV
+        };
+        xmlNode *root;
+        guint i;
+
+        av_xml_util_resolve_namespaces (doc, namespaces);
+
+        root = xmlDocGetRootElement (doc);
+        for (i = 0; i < G_N_ELEMENTS (prefixed); i++) {
+                GUPnPXMLNamespace ns = prefixed[i];
+
+                if (namespaces->ns[ns] == NULL)
+                        namespaces->ns[ns] =
+                                av_xml_util_create_namespace (root, ns);
+        }
+}
+
+/**
+ * av_xml_util_lookup_namespace:
+ * @doc: #xmlDoc
+ * @ns: namespace to look up
+ * @returns: %NULL if namespace does not exist, a pointer to the namespace
+ * otherwise.
+ */
+xmlNsPtr
+av_xml_util_lookup_namespace (xmlDocPtr doc, GUPnPXMLNamespace ns)
+{
+        GUPnPAVXMLNamespaces namespaces = { { NULL, } };
 
-        xmlFree (ns_list);
+        g_return_val_if_fail (ns < GUPNP_XML_NAMESPACE_COUNT, NULL);
+
+        av_xml_util_resolve_namespaces (doc, &namespaces);
+
+        return namespaces.ns[ns];
+}
+
+/**
+ * av_xml_util_get_namespace_uri:
+ * @ns: A #GUPnPXMLNamespace.
+ * @returns: The URI of @ns.
+ */
+const char *
+av_xml_util_get_namespace_uri (GUPnPXMLNamespace ns)
+{
+        g_return_val_if_fail (ns < GUPNP_XML_NAMESPACE_COUNT, NULL);
+
+        return gupnp_xml_namespaces[ns].uri;
+}
+
+/**
+ * av_xml_util_get_namespace_prefix:
+ * @ns: A #GUPnPXMLNamespace.
+ * @returns: The usual prefix of @ns, %NULL for the default namespace.
+ */
+const char *
+av_xml_util_get_namespace_prefix (GUPnPXMLNamespace ns)
+{
+        g_return_val_if_fail (ns < GUPNP_XML_NAMESPACE_COUNT, NULL);
 
-        return retval;
+        return gupnp_xml_namespaces[ns].prefix;
 }
 
 /**
@@ -15,6 +15,7 @@
 #define XML_UTIL_H
 
 #include <glib.h>
+#include <gio/gio.h>
 #include <libxml/tree.h>
 #include <libxml/parser.h>
 #include <stdarg.h>
@@ -32,9 +33,19 @@ typedef enum _GUPnPXMLNamespace
 
 G_BEGIN_DECLS
 
+/* The namespaces of a document, indexed by GUPnPXMLNamespace */
+typedef struct _GUPnPAVXMLNamespaces
+{
+    xmlNs *ns[GUPNP_XML_NAMESPACE_COUNT];
+} GUPnPAVXMLNamespaces;
+
 typedef struct _GPnPAVXMLDoc
 {
     xmlDoc *doc;
+
+    /* Bumped whenever elements are added or removed, so indexes into the
+     * document know they are stale */
+    guint generation;
 } GUPnPAVXMLDoc;
 
 G_GNUC_INTERNAL GUPnPAVXMLDoc *
@@ -49,6 +60,9 @@ av_xml_doc_unref                           (GUPnPAVXMLDoc *doc);
 G_GNUC_INTERNAL GType
 av_xml_doc_get_type                        (void) G_GNUC_CONST;
 
+G_GNUC_INTERNAL void
+av_xml_doc_touch                           (xmlDoc *doc);
+
 /* Misc utilities for inspecting xmlNodes */
 G_GNUC_INTERNAL xmlNode *
 av_xml_util_get_element                    (xmlNode    *node,
@@ -121,6 +135,22 @@ av_xml_util_get_child_string               (xmlNode    *parent_node,
                                             xmlDoc     *doc,
                                             const char *name);
 
+G_GNUC_INTERNAL void
+av_xml_util_dump_node_to_string            (GString *string,
+                                            xmlDoc  *doc,
+                                            xmlNode *node);
+
+G_GNUC_INTERNAL GBytes *
+av_xml_util_dump_node_to_bytes             (xmlDoc  *doc,
+                                            xmlNode *node);
+
+G_GNUC_INTERNAL gboolean
+av_xml_util_dump_node_to_stream            (GOutputStream *stream,
+                                            xmlDoc        *doc,
+                                            xmlNode       *node,
+                                            GCancellable  *cancellable,
+                                            GError       **error);
+
 G_GNUC_INTERNAL gboolean
 av_xml_util_node_deep_equal                (xmlNode *first,
                                             xmlNode *second);
@@ -132,6 +162,14 @@ av_xml_util_find_node                      (xmlNode *haystack,
 G_GNUC_INTERNAL xmlNode *
 av_xml_util_copy_node                      (xmlNode *node);
 
+G_GNUC_INTERNAL xmlNode *
+av_xml_util_move_node_to_new_doc           (xmlNode *node,
+                                            xmlNode *root);
+
+G_GNUC_INTERNAL xmlNode *
+av_xml_util_copy_node_to_new_doc           (xmlNode *node,
+                                            xmlNode *root);
+
 G_GNUC_INTERNAL GHashTable *
 av_xml_util_get_attributes_map             (xmlNode *node);
 
@@ -143,6 +181,20 @@ G_GNUC_INTERNAL xmlNsPtr
 av_xml_util_lookup_namespace               (xmlDocPtr doc,
                                             GUPnPXMLNamespace ns);
 
+G_GNUC_INTERNAL void
+av_xml_util_resolve_namespaces             (xmlDocPtr doc,
+                                            GUPnPAVXMLNamespaces *namespaces);
+
+G_GNUC_INTERNAL void
+av_xml_util_ensure_namespaces              (xmlDocPtr doc,
+                                            GUPnPAVXMLNamespaces *namespaces);
+
+G_GNUC_INTERNAL const char *
+av_xml_util_get_namespace_uri              (GUPnPXMLNamespace ns);
+
+G_GNUC_INTERNAL const char *
+av_xml_util_get_namespace_prefix           (GUPnPXMLNamespace ns);
+
 G_GNUC_INTERNAL xmlNsPtr
 av_xml_util_get_ns                         (xmlDocPtr doc,
                                             GUPnPXMLNamespace ns,
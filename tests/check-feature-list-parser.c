@@ -46,10 +46,8 @@ static const char *text =
         "</Features>";
 
 static gboolean
-check_feature (GUPnPFeature *feature)
+check_feature (GUPnPFeature *feature, guint index)
 {
-        static int index = 0;
-
         if (strcmp (names[index], gupnp_feature_get_name (feature)))
                         return FALSE;
 
@@ -59,40 +57,86 @@ check_feature (GUPnPFeature *feature)
         if (strcmp (ids[index], gupnp_feature_get_object_ids (feature)))
                         return FALSE;
 
-        index++;
-
         return TRUE;
 }
 
-int
-main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+static gboolean
+check_parse (GUPnPFeatureListParser *parser)
 {
-        GUPnPFeatureListParser *parser;
         GError                 *error;
         GList                  *features;
         GList                  *item;
+        guint                  index = 0;
         gboolean               success = TRUE;
 
-        parser = gupnp_feature_list_parser_new ();
-
         error = NULL;
         features = gupnp_feature_list_parser_parse_text (parser, text, &error);
         if (features == NULL) {
                 g_printerr ("Parse error: %s\n", error->message);
                 g_error_free (error);
-                return EXIT_FAILURE;
+                return FALSE;
         }
 
         for (item = features; item != NULL; item = g_list_next (item)) {
-                success = check_feature ((GUPnPFeature *) item->data);
+                success = check_feature ((GUPnPFeature *) item->data, index++);
                 if (!success)
                         break;
         }
 
-        g_print ("\n");
+        if (success && index != G_N_ELEMENTS (names))
+                success = FALSE;
 
         g_list_free_full (features, g_object_unref);
+
+        return success;
+}
+
+static void
+on_notify (G_GNUC_UNUSED GObject    *object,
+           G_GNUC_UNUSED GParamSpec *pspec,
+           gpointer                  user_data)
+{
+        (*(guint *) user_data)++;
+}
+
+int
+main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+        GUPnPFeatureListParser *parser;
+        GUPnPAVStringDict      *dict;
+        gsize                  size;
+        guint                  notified = 0;
+        gboolean               success;
+
+        parser = gupnp_feature_list_parser_new ();
+        g_signal_connect (parser,
+                          "notify::string-dict",
+                          G_CALLBACK (on_notify),
+                          &notified);
+
+        success = check_parse (parser);
+
+        /* The same features come out of documents parsed with a shared
+         * dictionary, and a second document adds no new names to it */
+        dict = gupnp_av_string_dict_new ();
+        gupnp_feature_list_parser_set_string_dict (parser, dict);
+        gupnp_feature_list_parser_set_string_dict (parser, dict);
+        if (notified != 1 ||
+            gupnp_feature_list_parser_get_string_dict (parser) != dict)
+                success = FALSE;
+
+        if (success)
+                success = check_parse (parser);
+        size = gupnp_av_string_dict_get_size (dict);
+        if (success)
+                success = size > 0 && check_parse (parser);
+        if (success)
+                success = gupnp_av_string_dict_get_size (dict) == size;
+
+        g_print ("\n");
+
         g_object_unref (parser);
+        gupnp_av_string_dict_unref (dict);
 
         return (success) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
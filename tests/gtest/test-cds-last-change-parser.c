@@ -424,15 +424,13 @@ compare_entries (const char *file, GList *entries)
 }
 
 static void
-test_parse_spec_samples (void)
+parse_spec_samples (GUPnPCDSLastChangeParser *parser)
 {
         GDir *dir;
         GError *error = NULL;
         const char *file;
         char *data_path;
-        GUPnPCDSLastChangeParser *parser;
 
-        parser = gupnp_cds_last_change_parser_new ();
         data_path = g_build_filename (DATA_PATH,
                                       "data",
                                       "cds-last-change",
@@ -466,11 +464,61 @@ test_parse_spec_samples (void)
                 g_free (contents);
         }
 
-        g_object_unref (parser);
         g_dir_close (dir);
         g_free (data_path);
 }
 
+static void
+test_parse_spec_samples (void)
+{
+        GUPnPCDSLastChangeParser *parser;
+
+        parser = gupnp_cds_last_change_parser_new ();
+        parse_spec_samples (parser);
+        g_object_unref (parser);
+}
+
+static void
+on_notify (G_GNUC_UNUSED GObject    *object,
+           G_GNUC_UNUSED GParamSpec *pspec,
+           gpointer                  user_data)
+{
+        (*(guint *) user_data)++;
+}
+
+static void
+test_string_dict (void)
+{
+        GUPnPCDSLastChangeParser *parser;
+        GUPnPAVStringDict *dict;
+        guint notified = 0;
+        gsize size;
+
+        parser = gupnp_cds_last_change_parser_new ();
+        dict = gupnp_av_string_dict_new ();
+        g_signal_connect (parser,
+                          "notify::string-dict",
+                          G_CALLBACK (on_notify),
+                          &notified);
+
+        g_object_set (parser, "string-dict", dict, NULL);
+        gupnp_cds_last_change_parser_set_string_dict (parser, dict);
+        g_assert_cmpuint (notified, ==, 1);
+        g_assert_true
+                (gupnp_cds_last_change_parser_get_string_dict (parser) == dict);
+
+        /* The entries do not depend on where the names are interned, and
+         * parsing the same documents again adds no new names */
+        parse_spec_samples (parser);
+        size = gupnp_av_string_dict_get_size (dict);
+        g_assert_cmpuint (size, >, 0);
+        parse_spec_samples (parser);
+        g_assert_cmpuint (gupnp_av_string_dict_get_size (dict), ==, size);
+
+        g_object_unref (parser);
+        gupnp_av_string_dict_unref (dict);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -478,6 +526,8 @@ main (int argc, char *argv[])
 
         g_test_add_func ("/cds-last-change/parse-spec-samples",
                          test_parse_spec_samples);
+        g_test_add_func ("/cds-last-change/string-dict",
+                         test_string_dict);
 
         return g_test_run ();
 }
@@ -5,8 +5,16 @@
  */
 #include <config.h>
 
+#include <string.h>
+
+#include <glib/gstdio.h>
+
 #include <libgupnp-av/gupnp-didl-lite-object.h>
+#include <libgupnp-av/gupnp-didl-lite-parser.h>
+#include <libgupnp-av/gupnp-didl-lite-snapshot.h>
+#include <libgupnp-av/gupnp-didl-lite-catalog.h>
 #include <libgupnp-av/gupnp-didl-lite-writer.h>
+#include <libgupnp-av/gupnp-didl-lite-fragment-cache.h>
 
 static void
 namespace_getters (void)
@@ -33,12 +41,1019 @@ namespace_getters (void)
   g_assert_cmpstr ((char *) namespace->prefix, ==, "pv");
 }
 
+static xmlNode *
+find_child (xmlNode *parent, const char *name)
+{
+  xmlNode *node;
+
+  for (node = parent->children; node != NULL; node = node->next)
+    if (g_strcmp0 ((const char *) node->name, name) == 0)
+      return node;
+
+  return NULL;
+}
+
+static void
+property_index (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GUPnPDIDLLiteContainer *container;
+  GUPnPDIDLLiteContributor *artist;
+  xmlNode *xml_node, *node;
+
+  g_assert_null (gupnp_didl_lite_object_get_title (object));
+  g_assert_null (gupnp_didl_lite_object_get_artist (object));
+  g_assert_false (gupnp_didl_lite_object_update_id_is_set (object));
+
+  gupnp_didl_lite_object_set_title (object, "Title");
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (object), ==, "Title");
+
+  gupnp_didl_lite_object_set_title (object, "Other title");
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (object), ==, "Other title");
+
+  gupnp_didl_lite_object_set_update_id (object, 42);
+  g_assert_true (gupnp_didl_lite_object_update_id_is_set (object));
+  g_assert_cmpuint (gupnp_didl_lite_object_get_update_id (object), ==, 42);
+
+  gupnp_didl_lite_object_unset_update_id (object);
+  g_assert_false (gupnp_didl_lite_object_update_id_is_set (object));
+
+  artist = gupnp_didl_lite_object_add_artist (object);
+  gupnp_didl_lite_contributor_set_name (artist, "Artist");
+  g_object_unref (artist);
+  g_assert_cmpstr (gupnp_didl_lite_object_get_artist (object), ==, "Artist");
+
+  gupnp_didl_lite_object_unset_artists (object);
+  g_assert_null (gupnp_didl_lite_object_get_artist (object));
+
+  /* Changes made through the node handed out are seen by the getters */
+  gupnp_didl_lite_object_set_album (object, "Album");
+  g_assert_cmpstr (gupnp_didl_lite_object_get_album (object), ==, "Album");
+  node = find_child (gupnp_didl_lite_object_get_xml_node (object), "album");
+  g_assert_nonnull (node);
+  xmlUnlinkNode (node);
+  xmlFreeNode (node);
+  g_assert_null (gupnp_didl_lite_object_get_album (object));
+
+  /* Even a node unlinked after the next getter call is not used */
+  xml_node = gupnp_didl_lite_object_get_xml_node (object);
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (object), ==, "Other title");
+  node = find_child (xml_node, "title");
+  g_assert_nonnull (node);
+  xmlUnlinkNode (node);
+  g_assert_null (gupnp_didl_lite_object_get_title (object));
+  xmlFreeNode (node);
+
+  g_object_unref (object);
+
+  /* The index is built by the first getter, the setter has to invalidate
+   * it when it adds the element */
+  container = gupnp_didl_lite_writer_add_container (writer);
+  g_assert_cmpint (gupnp_didl_lite_container_get_storage_used (container), ==, -1);
+  gupnp_didl_lite_container_set_storage_used (container, 4096);
+  g_assert_cmpint (gupnp_didl_lite_container_get_storage_used (container), ==, 4096);
+  gupnp_didl_lite_container_set_storage_used (container, 8192);
+  g_assert_cmpint (gupnp_didl_lite_container_get_storage_used (container), ==, 8192);
+  g_object_unref (container);
+
+  g_object_unref (writer);
+}
+
+static void
+resource_cache (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GUPnPDIDLLiteResource *resource;
+  GPtrArray *first, *second;
+  GList *list;
+
+  first = gupnp_didl_lite_object_get_resources_as_array (object);
+  g_assert_cmpuint (first->len, ==, 0);
+
+  resource = gupnp_didl_lite_object_add_resource (object);
+  gupnp_didl_lite_resource_set_uri (resource, "http://example.com/a");
+  g_object_unref (resource);
+
+  /* Adding a resource must not touch arrays handed out before */
+  g_assert_cmpuint (first->len, ==, 0);
+  g_ptr_array_unref (first);
+
+  resource = gupnp_didl_lite_object_add_resource (object);
+  gupnp_didl_lite_resource_set_uri (resource, "http://example.com/b");
+  g_object_unref (resource);
+
+  first = gupnp_didl_lite_object_get_resources_as_array (object);
+  second = gupnp_didl_lite_object_get_resources_as_array (object);
+  g_assert_true (first == second);
+  g_assert_cmpuint (first->len, ==, 2);
+  g_assert_cmpstr (gupnp_didl_lite_resource_get_uri (g_ptr_array_index (first, 0)), ==, "http://example.com/a");
+  g_assert_cmpstr (gupnp_didl_lite_resource_get_uri (g_ptr_array_index (first, 1)), ==, "http://example.com/b");
+
+  list = gupnp_didl_lite_object_get_resources (object);
+  g_assert_cmpuint (g_list_length (list), ==, 2);
+  g_assert_true (list->data == g_ptr_array_index (first, 0));
+  g_assert_true (list->next->data == g_ptr_array_index (first, 1));
+  g_list_free_full (list, g_object_unref);
+
+  g_ptr_array_unref (second);
+  g_ptr_array_unref (first);
+  g_object_unref (object);
+  g_object_unref (writer);
+}
+
+static void
+add_resource (GUPnPDIDLLiteObject *object,
+              const char          *uri,
+              const char          *protocol_info)
+{
+  GUPnPDIDLLiteResource *resource = gupnp_didl_lite_object_add_resource (object);
+  GUPnPProtocolInfo *info = gupnp_protocol_info_new_from_string (protocol_info, NULL);
+
+  gupnp_didl_lite_resource_set_uri (resource, uri);
+  gupnp_didl_lite_resource_set_protocol_info (resource, info);
+
+  g_object_unref (info);
+  g_object_unref (resource);
+}
+
+static void
+compat_resource_matcher (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GUPnPProtocolInfoMatcher *matcher;
+  GUPnPDIDLLiteResource *resource;
+
+  add_resource (object, "http://example.com/flac", "http-get:*:audio/flac:*");
+  add_resource (object, "http://example.com/lpcm", "http-get:*:audio/L16;rate=44100;channels=2:DLNA.ORG_PN=LPCM;DLNA.ORG_CI=1");
+  add_resource (object, "http://example.com/mp3", "http-get:*:audio/mpeg:DLNA.ORG_PN=MP3");
+
+  matcher = gupnp_protocol_info_matcher_new ("http-get:*:audio/L16:DLNA.ORG_PN=LPCM,"
+                                             "http-get:*:AUDIO/MPEG:*,"
+                                             "not a protocol info");
+  g_assert_cmpuint (gupnp_protocol_info_matcher_get_length (matcher), ==, 2);
+
+  /* The transcoded LPCM resource matches first, but the MP3 one is preferred */
+  resource = gupnp_didl_lite_object_get_compat_resource_with_matcher (object, matcher, FALSE);
+  g_assert_nonnull (resource);
+  g_assert_cmpstr (gupnp_didl_lite_resource_get_uri (resource), ==, "http://example.com/mp3");
+  g_object_unref (resource);
+
+  resource = gupnp_didl_lite_object_get_compat_resource (object, "http-get:*:audio/L16:*", FALSE);
+  g_assert_nonnull (resource);
+  g_assert_cmpstr (gupnp_didl_lite_resource_get_uri (resource), ==, "http://example.com/lpcm");
+  g_object_unref (resource);
+  gupnp_protocol_info_matcher_unref (matcher);
+
+  matcher = gupnp_protocol_info_matcher_new ("rtsp-rtp-udp:*:audio/flac:*");
+  resource = gupnp_didl_lite_object_get_compat_resource_with_matcher (object, matcher, FALSE);
+  g_assert_null (resource);
+
+  resource = gupnp_didl_lite_object_get_compat_resource_with_matcher (object, matcher, TRUE);
+  g_assert_nonnull (resource);
+  g_assert_cmpstr (gupnp_didl_lite_resource_get_uri (resource), ==, "http://example.com/flac");
+  g_object_unref (resource);
+  gupnp_protocol_info_matcher_unref (matcher);
+
+  g_object_unref (object);
+  g_object_unref (writer);
+}
+
+static void
+bulk_fields (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GUPnPDIDLLiteResource *resource;
+  GUPnPDIDLLiteFields fields;
+  GUPnPDIDLLiteField found;
+
+  gupnp_didl_lite_object_set_id (object, "42");
+  gupnp_didl_lite_object_set_upnp_class (object, "object.item.audioItem.musicTrack");
+  gupnp_didl_lite_object_set_title (object, "Title");
+  gupnp_didl_lite_object_set_album (object, "Album");
+  gupnp_didl_lite_object_set_track_number (object, 7);
+
+  resource = gupnp_didl_lite_object_add_resource (object);
+  gupnp_didl_lite_resource_set_duration (resource, 3723);
+  g_object_unref (resource);
+
+  found = gupnp_didl_lite_object_get_fields (object, GUPNP_DIDL_LITE_FIELD_ALL, &fields);
+  g_assert_cmpuint (found, ==, GUPNP_DIDL_LITE_FIELD_ID |
+                               GUPNP_DIDL_LITE_FIELD_UPNP_CLASS |
+                               GUPNP_DIDL_LITE_FIELD_TITLE |
+                               GUPNP_DIDL_LITE_FIELD_ALBUM |
+                               GUPNP_DIDL_LITE_FIELD_TRACK_NUMBER |
+                               GUPNP_DIDL_LITE_FIELD_DURATION);
+  g_assert_cmpstr (fields.id, ==, "42");
+  g_assert_cmpstr (fields.upnp_class, ==, "object.item.audioItem.musicTrack");
+  g_assert_cmpstr (fields.title, ==, "Title");
+  g_assert_cmpstr (fields.album, ==, "Album");
+  g_assert_null (fields.artist);
+  g_assert_cmpint (fields.track_number, ==, 7);
+  g_assert_cmpint (fields.duration, ==, 3723);
+
+  found = gupnp_didl_lite_object_get_fields (object, GUPNP_DIDL_LITE_FIELD_TITLE | GUPNP_DIDL_LITE_FIELD_ARTIST, &fields);
+  g_assert_cmpuint (found, ==, GUPNP_DIDL_LITE_FIELD_TITLE);
+  g_assert_cmpstr (fields.title, ==, "Title");
+  g_assert_null (fields.id);
+  g_assert_cmpint (fields.duration, ==, -1);
+
+  g_object_unref (object);
+  g_object_unref (writer);
+}
+
+static void
+snapshot_roundtrip (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GUPnPDIDLLiteContributor *artist;
+  GUPnPDIDLLiteResource *resource;
+  const GUPnPDIDLLiteSnapshotContributor *contributor;
+  const GUPnPDIDLLiteSnapshotResource *res;
+  GUPnPDIDLLiteSnapshot *snapshot;
+  GList *artists;
+
+  gupnp_didl_lite_object_set_id (object, "42");
+  gupnp_didl_lite_object_set_title (object, "Title");
+  artist = gupnp_didl_lite_object_add_artist (object);
+  gupnp_didl_lite_contributor_set_name (artist, "Artist");
+  gupnp_didl_lite_contributor_set_role (artist, "Performer");
+  g_object_unref (artist);
+  add_resource (object, "http://example.com/mp3", "http-get:*:audio/mpeg:*");
+  resource = gupnp_didl_lite_object_add_resource (object);
+  gupnp_didl_lite_resource_set_duration (resource, 61);
+  g_object_unref (resource);
+
+  snapshot = gupnp_didl_lite_snapshot_new (object);
+  g_object_unref (object);
+  g_object_unref (writer);
+
+  g_assert_false (gupnp_didl_lite_snapshot_is_container (snapshot));
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (snapshot)->id, ==, "42");
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (snapshot)->title, ==, "Title");
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (snapshot)->artist, ==, "Artist");
+  g_assert_null (gupnp_didl_lite_snapshot_get_fields (snapshot)->album);
+
+  g_assert_cmpuint (gupnp_didl_lite_snapshot_get_n_contributors (snapshot), ==, 1);
+  contributor = gupnp_didl_lite_snapshot_get_contributor (snapshot, 0);
+  g_assert_cmpstr (contributor->element, ==, "artist");
+  g_assert_cmpstr (contributor->name, ==, "Artist");
+  g_assert_cmpstr (contributor->role, ==, "Performer");
+
+  g_assert_cmpuint (gupnp_didl_lite_snapshot_get_n_resources (snapshot), ==, 2);
+  res = gupnp_didl_lite_snapshot_get_resource (snapshot, 0);
+  g_assert_cmpstr (res->uri, ==, "http://example.com/mp3");
+  g_assert_nonnull (res->protocol_info);
+  g_assert_cmpint (res->duration, ==, -1);
+  res = gupnp_didl_lite_snapshot_get_resource (snapshot, 1);
+  g_assert_null (res->uri);
+  g_assert_cmpint (res->duration, ==, 61);
+
+  writer = gupnp_didl_lite_writer_new (NULL);
+  object = gupnp_didl_lite_snapshot_to_object (snapshot, writer);
+  gupnp_didl_lite_snapshot_unref (snapshot);
+
+  g_assert_true (GUPNP_IS_DIDL_LITE_ITEM (object));
+  g_assert_cmpstr (gupnp_didl_lite_object_get_id (object), ==, "42");
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (object), ==, "Title");
+  artists = gupnp_didl_lite_object_get_artists (object);
+  g_assert_cmpuint (g_list_length (artists), ==, 1);
+  g_assert_cmpstr (gupnp_didl_lite_contributor_get_role (artists->data), ==, "Performer");
+  g_list_free_full (artists, g_object_unref);
+
+  resource = gupnp_didl_lite_object_get_compat_resource (object, "http-get:*:audio/mpeg:*", FALSE);
+  g_assert_nonnull (resource);
+  g_assert_cmpstr (gupnp_didl_lite_resource_get_uri (resource), ==, "http://example.com/mp3");
+  g_object_unref (resource);
+
+  g_object_unref (object);
+  g_object_unref (writer);
+}
+
+static void
+snapshot_variant (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_container (writer));
+  GUPnPDIDLLiteContributor *author;
+  GUPnPDIDLLiteSnapshot *snapshot, *copy;
+  const GUPnPDIDLLiteSnapshotResource *res;
+  GVariant *variant;
+  GBytes *bytes;
+
+  gupnp_didl_lite_object_set_id (object, "7");
+  gupnp_didl_lite_object_set_title (object, "Container");
+  gupnp_didl_lite_object_set_restricted (object, TRUE);
+  author = gupnp_didl_lite_object_add_author (object);
+  gupnp_didl_lite_contributor_set_name (author, "Author");
+  g_object_unref (author);
+  add_resource (object, "http://example.com/playlist", "http-get:*:audio/x-mpegurl:*");
+
+  snapshot = gupnp_didl_lite_snapshot_new (object);
+  g_object_unref (object);
+  g_object_unref (writer);
+
+  variant = g_variant_ref_sink (gupnp_didl_lite_snapshot_to_variant (snapshot));
+  g_assert_true (g_variant_is_of_type (variant, G_VARIANT_TYPE (GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE)));
+  bytes = g_variant_get_data_as_bytes (variant);
+  g_variant_unref (variant);
+  gupnp_didl_lite_snapshot_unref (snapshot);
+
+  /* As if read back from a file */
+  variant = g_variant_new_from_bytes (G_VARIANT_TYPE (GUPNP_DIDL_LITE_SNAPSHOT_VARIANT_TYPE), bytes, FALSE);
+  g_bytes_unref (bytes);
+  copy = gupnp_didl_lite_snapshot_new_from_variant (variant);
+  g_assert_nonnull (copy);
+
+  g_assert_true (gupnp_didl_lite_snapshot_is_container (copy));
+  g_assert_true (gupnp_didl_lite_snapshot_get_restricted (copy));
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (copy)->id, ==, "7");
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (copy)->title, ==, "Container");
+  g_assert_null (gupnp_didl_lite_snapshot_get_fields (copy)->artist);
+  g_assert_cmpint (gupnp_didl_lite_snapshot_get_fields (copy)->track_number, ==, -1);
+  g_assert_cmpuint (gupnp_didl_lite_snapshot_get_n_contributors (copy), ==, 1);
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_contributor (copy, 0)->element, ==, "author");
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_contributor (copy, 0)->name, ==, "Author");
+  g_assert_null (gupnp_didl_lite_snapshot_get_contributor (copy, 0)->role);
+  g_assert_cmpuint (gupnp_didl_lite_snapshot_get_n_resources (copy), ==, 1);
+  res = gupnp_didl_lite_snapshot_get_resource (copy, 0);
+  g_assert_cmpstr (res->uri, ==, "http://example.com/playlist");
+  g_assert_cmpint (res->size, ==, -1);
+  gupnp_didl_lite_snapshot_unref (copy);
+
+  g_assert_null (gupnp_didl_lite_snapshot_new_from_variant (g_variant_new_string ("nope")));
+}
+
+static void
+add_catalog_object (GUPnPDIDLLiteCatalogBuilder *builder,
+                    GUPnPDIDLLiteWriter         *writer,
+                    gboolean                     is_container,
+                    const char                  *id,
+                    const char                  *parent_id,
+                    const char                  *title)
+{
+  GUPnPDIDLLiteObject *object;
+
+  if (is_container)
+    object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_container (writer));
+  else
+    object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  gupnp_didl_lite_object_set_id (object, id);
+  gupnp_didl_lite_object_set_parent_id (object, parent_id);
+  gupnp_didl_lite_object_set_title (object, title);
+  gupnp_didl_lite_catalog_builder_add_object (builder, object);
+  g_object_unref (object);
+}
+
+static void
+catalog (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteCatalogBuilder *builder = gupnp_didl_lite_catalog_builder_new ();
+  GUPnPDIDLLiteCatalog *cat;
+  GUPnPDIDLLiteSnapshot *snapshot;
+  GUPnPDIDLLiteObject *object;
+  const guint32 *children;
+  guint n_children;
+  GBytes *bytes;
+  GError *error = NULL;
+  char *path;
+  char *didl;
+  int fd;
+
+  add_catalog_object (builder, writer, TRUE, "1", "0", "Music");
+  add_catalog_object (builder, writer, FALSE, "1$c", "1", "Third");
+  add_catalog_object (builder, writer, TRUE, "2", "0", "Pictures");
+  add_catalog_object (builder, writer, FALSE, "1$a", "1", "First");
+  add_catalog_object (builder, writer, FALSE, "1$b", "1", "Second");
+  g_object_unref (writer);
+
+  fd = g_file_open_tmp ("catalog-XXXXXX", &path, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+  g_assert_true (gupnp_didl_lite_catalog_builder_write (builder, path, &error));
+  g_assert_no_error (error);
+  gupnp_didl_lite_catalog_builder_unref (builder);
+
+  cat = gupnp_didl_lite_catalog_new_from_file (path, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (cat);
+  g_unlink (path);
+  g_free (path);
+
+  g_assert_cmpuint (gupnp_didl_lite_catalog_get_length (cat), ==, 5);
+
+  snapshot = gupnp_didl_lite_catalog_lookup (cat, "1$b");
+  g_assert_nonnull (snapshot);
+  g_assert_false (gupnp_didl_lite_snapshot_is_container (snapshot));
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (snapshot)->title, ==, "Second");
+  gupnp_didl_lite_snapshot_unref (snapshot);
+  g_assert_null (gupnp_didl_lite_catalog_lookup (cat, "1$d"));
+  g_assert_null (gupnp_didl_lite_catalog_lookup (cat, ""));
+
+  /* Children are listed in the order they were added */
+  children = gupnp_didl_lite_catalog_get_children (cat, "1", &n_children);
+  g_assert_cmpuint (n_children, ==, 3);
+  g_assert_cmpuint (children[0], ==, 1);
+  g_assert_cmpuint (children[1], ==, 3);
+  g_assert_cmpuint (children[2], ==, 4);
+  children = gupnp_didl_lite_catalog_get_children (cat, "0", &n_children);
+  g_assert_cmpuint (n_children, ==, 2);
+  snapshot = gupnp_didl_lite_catalog_get_snapshot (cat, children[1]);
+  g_assert_true (gupnp_didl_lite_snapshot_is_container (snapshot));
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (snapshot)->id, ==, "2");
+  gupnp_didl_lite_snapshot_unref (snapshot);
+  g_assert_null (gupnp_didl_lite_catalog_get_children (cat, "2", &n_children));
+  g_assert_cmpuint (n_children, ==, 0);
+
+  writer = gupnp_didl_lite_writer_new (NULL);
+  object = gupnp_didl_lite_catalog_add_to_writer (cat, "1$a", writer);
+  g_assert_nonnull (object);
+  g_object_unref (object);
+  g_assert_null (gupnp_didl_lite_catalog_add_to_writer (cat, "3", writer));
+  didl = gupnp_didl_lite_writer_get_string (writer);
+  g_assert_nonnull (strstr (didl, "<dc:title>First</dc:title>"));
+  g_free (didl);
+  g_object_unref (writer);
+
+  /* Snapshots stay valid after the catalog is gone */
+  snapshot = gupnp_didl_lite_catalog_lookup (cat, "1");
+  gupnp_didl_lite_catalog_unref (cat);
+  g_assert_cmpstr (gupnp_didl_lite_snapshot_get_fields (snapshot)->title, ==, "Music");
+  gupnp_didl_lite_snapshot_unref (snapshot);
+
+  bytes = g_bytes_new_static ("not a catalog", 13);
+  g_assert_null (gupnp_didl_lite_catalog_new_from_bytes (bytes, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+  g_clear_error (&error);
+  g_bytes_unref (bytes);
+}
+
+static void
+xml_output (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GOutputStream *stream;
+  GString *string;
+  GBytes *bytes;
+  GError *error = NULL;
+  char *xml;
+
+  gupnp_didl_lite_object_set_id (object, "1");
+  gupnp_didl_lite_object_set_title (object, "Fish & Chips");
+
+  xml = gupnp_didl_lite_object_get_xml_string (object);
+  g_assert_nonnull (strstr (xml, "Fish &amp; Chips"));
+
+  bytes = gupnp_didl_lite_object_get_xml_bytes (object);
+  g_assert_cmpmem (g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes), xml, strlen (xml));
+  g_bytes_unref (bytes);
+
+  string = g_string_new ("<prefix/>");
+  gupnp_didl_lite_object_append_xml_string (object, string);
+  g_assert_true (g_str_has_prefix (string->str, "<prefix/>"));
+  g_assert_cmpstr (string->str + strlen ("<prefix/>"), ==, xml);
+  g_string_free (string, TRUE);
+
+  stream = g_memory_output_stream_new_resizable ();
+  g_assert_true (gupnp_didl_lite_object_write_xml (object, stream, NULL, &error));
+  g_assert_no_error (error);
+  g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream)),
+                   g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream)),
+                   xml, strlen (xml));
+  g_object_unref (stream);
+  g_free (xml);
+  g_object_unref (object);
+
+  xml = gupnp_didl_lite_writer_get_string (writer);
+
+  bytes = gupnp_didl_lite_writer_get_bytes (writer);
+  g_assert_cmpmem (g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes), xml, strlen (xml));
+  g_bytes_unref (bytes);
+
+  string = g_string_new (NULL);
+  gupnp_didl_lite_writer_append_string (writer, string);
+  g_assert_cmpstr (string->str, ==, xml);
+  g_string_free (string, TRUE);
+
+  stream = g_memory_output_stream_new_resizable ();
+  g_assert_true (gupnp_didl_lite_writer_write_to_stream (writer, stream, NULL, &error));
+  g_assert_no_error (error);
+  g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream)),
+                   g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream)),
+                   xml, strlen (xml));
+
+  /* Errors of the stream are passed on */
+  g_output_stream_close (stream, NULL, NULL);
+  g_assert_false (gupnp_didl_lite_writer_write_to_stream (writer, stream, NULL, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CLOSED);
+  g_clear_error (&error);
+  g_object_unref (stream);
+
+  g_free (xml);
+  g_object_unref (writer);
+}
+
+static void
+date_accessors (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GDateTime *date_time;
+  char *formatted;
+
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_MININT64);
+  g_assert_null (gupnp_didl_lite_object_get_date_time (object));
+
+  gupnp_didl_lite_object_set_date (object, "2021-04-23");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_GINT64_CONSTANT (1619136000) * G_USEC_PER_SEC);
+
+  /* The cached value follows changes of the date */
+  gupnp_didl_lite_object_set_date (object, "2021-04-23T18:18:42.5+02:00");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_GINT64_CONSTANT (1619194722) * G_USEC_PER_SEC + 500000);
+  date_time = gupnp_didl_lite_object_get_date_time (object);
+  g_assert_nonnull (date_time);
+  g_assert_cmpint (g_date_time_get_hour (date_time), ==, 18);
+  g_assert_cmpint (g_date_time_get_microsecond (date_time), ==, 500000);
+  g_assert_cmpint (g_date_time_get_utc_offset (date_time), ==, 2 * G_TIME_SPAN_HOUR);
+  g_assert_cmpint (g_date_time_to_unix (date_time), ==, 1619194722);
+
+  /* Formatting and parsing agree */
+  formatted = gupnp_format_date_time_for_didl_lite (date_time, FALSE);
+  g_assert_cmpstr (formatted, ==, "2021-04-23T18:18:42.500+02:00");
+  g_free (formatted);
+  formatted = gupnp_format_date_time_for_didl_lite (date_time, TRUE);
+  g_assert_cmpstr (formatted, ==, "2021-04-23");
+  g_free (formatted);
+  g_date_time_unref (date_time);
+
+  date_time = g_date_time_new_utc (1999, 12, 31, 23, 59, 59);
+  formatted = gupnp_format_date_time_for_didl_lite (date_time, FALSE);
+  g_assert_cmpstr (formatted, ==, "1999-12-31T23:59:59Z");
+  g_date_time_unref (date_time);
+  gupnp_didl_lite_object_set_date (object, formatted);
+  g_free (formatted);
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_GINT64_CONSTANT (946684799) * G_USEC_PER_SEC);
+
+  gupnp_didl_lite_object_set_date (object, "2021-02-29");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_MININT64);
+  g_assert_null (gupnp_didl_lite_object_get_date_time (object));
+
+  g_object_unref (object);
+  g_object_unref (writer);
+}
+
+static void
+date_shared_node (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+  GUPnPDIDLLiteObject *other;
+  xmlNode *node;
+
+  other = g_object_new (GUPNP_TYPE_DIDL_LITE_ITEM,
+                        "xml-node", gupnp_didl_lite_object_get_xml_node (object),
+                        NULL);
+
+  gupnp_didl_lite_object_set_date (object, "2021-04-23");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_GINT64_CONSTANT (1619136000) * G_USEC_PER_SEC);
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (other), ==, G_GINT64_CONSTANT (1619136000) * G_USEC_PER_SEC);
+
+  /* Another writer of the node, like a third wrapper of it, rewrites the
+   * content of the existing element in place without touching the
+   * document. Neither wrapper may keep the date it cached before. */
+  node = find_child (gupnp_didl_lite_object_get_xml_node (object), "date");
+  g_assert_nonnull (node);
+
+  xmlNodeSetContent (node, (const xmlChar *) "2021-04-24");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_GINT64_CONSTANT (1619222400) * G_USEC_PER_SEC);
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (other), ==, G_GINT64_CONSTANT (1619222400) * G_USEC_PER_SEC);
+
+  xmlNodeSetContent (node, (const xmlChar *) "not a date");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (object), ==, G_MININT64);
+  g_assert_null (gupnp_didl_lite_object_get_date_time (other));
+
+  gupnp_didl_lite_object_set_date (object, "2021-04-25");
+  g_assert_cmpint (gupnp_didl_lite_object_get_date_sort_key (other), ==, G_GINT64_CONSTANT (1619308800) * G_USEC_PER_SEC);
+
+  g_object_unref (other);
+  g_object_unref (object);
+  g_object_unref (writer);
+}
+
+static GUPnPDIDLLiteWriter *
+new_filter_test_writer (GUPnPDIDLLiteFilter *preset)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteObject *object;
+  GUPnPDIDLLiteResource *resource;
+
+  gupnp_didl_lite_writer_set_filter (writer, preset);
+  object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+
+  gupnp_didl_lite_object_set_id (object, "1");
+  gupnp_didl_lite_object_set_parent_id (object, "0");
+  gupnp_didl_lite_object_set_title (object, "Title");
+  gupnp_didl_lite_object_set_upnp_class (object, "object.item.audioItem.musicTrack");
+  gupnp_didl_lite_object_set_album (object, "Album");
+  gupnp_didl_lite_object_set_genre (object, "Genre");
+  gupnp_didl_lite_object_set_date (object, "2021-04-23");
+  resource = gupnp_didl_lite_object_add_resource (object);
+  gupnp_didl_lite_resource_set_uri (resource, "http://example.com/track.mp3");
+  gupnp_didl_lite_resource_set_size64 (resource, 1234);
+  gupnp_didl_lite_resource_set_duration (resource, 60);
+  g_object_unref (resource);
+  g_object_unref (object);
+
+  return writer;
+}
+
+static void
+compiled_filter (void)
+{
+  const char *filters[] = { "upnp:album,res@size", "dc:date,res", "@size", "*", "", "upnp:albumArtURI" };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (filters); i++) {
+    GUPnPDIDLLiteFilter *filter = gupnp_didl_lite_filter_new (filters[i]);
+    GUPnPDIDLLiteWriter *expected = new_filter_test_writer (NULL);
+    GUPnPDIDLLiteWriter *writer;
+    char *expected_xml;
+    char *xml;
+    int round;
+
+    g_assert_cmpstr (gupnp_didl_lite_filter_get_string (filter), ==, filters[i]);
+    g_assert_true (gupnp_didl_lite_filter_is_wildcard (filter) == (filters[i][0] == '*'));
+
+    gupnp_didl_lite_writer_filter (expected, filters[i]);
+    expected_xml = gupnp_didl_lite_writer_get_string (expected);
+    g_object_unref (expected);
+
+    /* The same filter can be applied over and over */
+    for (round = 0; round < 2; round++) {
+      writer = new_filter_test_writer (NULL);
+      gupnp_didl_lite_writer_apply_filter (writer, filter);
+      xml = gupnp_didl_lite_writer_get_string (writer);
+      g_assert_cmpstr (xml, ==, expected_xml);
+      g_free (xml);
+      g_object_unref (writer);
+    }
+
+    if (i == 0) {
+      g_assert_nonnull (strstr (expected_xml, "<upnp:album>"));
+      g_assert_nonnull (strstr (expected_xml, "size=\"1234\""));
+      g_assert_null (strstr (expected_xml, "duration="));
+      g_assert_null (strstr (expected_xml, "<upnp:genre>"));
+      g_assert_null (strstr (expected_xml, "<dc:date>"));
+    }
+
+    g_free (expected_xml);
+    gupnp_didl_lite_filter_unref (filter);
+  }
+}
+
+static void
+writer_preset_filter (void)
+{
+  const char *filters[] = { "upnp:album,res@size", "dc:date,res", "@size", "*", "", "upnp:albumArtURI" };
+  GUPnPDIDLLiteWriter *writer;
+  GUPnPDIDLLiteContainer *container;
+  GUPnPDIDLLiteFilter *filter;
+  char *expected_xml;
+  char *xml;
+  guint i;
+
+  /* Setters skip what filtering would remove, so the result does not
+   * change */
+  for (i = 0; i < G_N_ELEMENTS (filters); i++) {
+    filter = gupnp_didl_lite_filter_new (filters[i]);
+
+    writer = new_filter_test_writer (NULL);
+    gupnp_didl_lite_writer_apply_filter (writer, filter);
+    expected_xml = gupnp_didl_lite_writer_get_string (writer);
+    g_object_unref (writer);
+
+    writer = new_filter_test_writer (filter);
+    g_assert_true (gupnp_didl_lite_writer_get_filter (writer) == filter);
+    gupnp_didl_lite_writer_apply_filter (writer, filter);
+    xml = gupnp_didl_lite_writer_get_string (writer);
+    g_assert_cmpstr (xml, ==, expected_xml);
+    g_free (xml);
+    g_object_unref (writer);
+
+    g_free (expected_xml);
+    gupnp_didl_lite_filter_unref (filter);
+  }
+
+  /* Nothing to remove from the properties set directly */
+  filter = gupnp_didl_lite_filter_new ("upnp:album,@childCount");
+  writer = new_filter_test_writer (filter);
+  xml = gupnp_didl_lite_writer_get_string (writer);
+  g_assert_nonnull (strstr (xml, "<dc:title>Title</dc:title>"));
+  g_assert_nonnull (strstr (xml, "<upnp:album>Album</upnp:album>"));
+  g_assert_null (strstr (xml, "<upnp:genre>"));
+  g_assert_null (strstr (xml, "<dc:date>"));
+  g_free (xml);
+
+  container = gupnp_didl_lite_writer_add_container (writer);
+  gupnp_didl_lite_object_set_upnp_class (GUPNP_DIDL_LITE_OBJECT (container),
+                                         "object.container.storageFolder");
+  gupnp_didl_lite_container_set_child_count (container, 3);
+  gupnp_didl_lite_container_set_searchable (container, TRUE);
+  gupnp_didl_lite_container_set_storage_used (container, 4096);
+  gupnp_didl_lite_container_set_total_deleted_child_count (container, 1);
+  gupnp_didl_lite_container_add_search_class (container, "object.item");
+  g_assert_cmpint (gupnp_didl_lite_container_get_child_count (container), ==, 3);
+  g_assert_false (gupnp_didl_lite_container_get_searchable (container));
+  g_assert_cmpint (gupnp_didl_lite_container_get_storage_used (container), ==, 4096);
+  g_assert_null (gupnp_didl_lite_container_get_search_classes (container));
+  g_object_unref (container);
+
+  /* Objects created after unsetting the filter get everything again */
+  gupnp_didl_lite_writer_set_filter (writer, NULL);
+  container = gupnp_didl_lite_writer_add_container (writer);
+  gupnp_didl_lite_container_set_searchable (container, TRUE);
+  g_assert_true (gupnp_didl_lite_container_get_searchable (container));
+  g_object_unref (container);
+
+  g_object_unref (writer);
+  gupnp_didl_lite_filter_unref (filter);
+}
+
+static void
+streaming_writer (void)
+{
+  GOutputStream *stream = g_memory_output_stream_new_resizable ();
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new_for_stream (NULL, stream);
+  GUPnPDIDLLiteFilter *filter = gupnp_didl_lite_filter_new ("upnp:album");
+  GUPnPDIDLLiteObject *first = NULL;
+  GUPnPDIDLLiteParser *parser;
+  GPtrArray *objects;
+  GError *error = NULL;
+  GBytes *bytes;
+  char *didl;
+  guint i;
+
+  g_assert_true (gupnp_didl_lite_writer_get_stream (writer) == stream);
+  gupnp_didl_lite_writer_set_filter (writer, filter);
+
+  for (i = 0; i < 3; i++) {
+    GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+    GUPnPDIDLLiteResource *resource;
+    char *id = g_strdup_printf ("%u", i);
+
+    gupnp_didl_lite_object_set_id (object, id);
+    gupnp_didl_lite_object_set_parent_id (object, "0");
+    gupnp_didl_lite_object_set_title (object, "Title & more");
+    gupnp_didl_lite_object_set_upnp_class (object, "object.item.audioItem.musicTrack");
+    gupnp_didl_lite_object_set_album (object, "Album");
+    gupnp_didl_lite_object_set_genre (object, "Genre");
+    resource = gupnp_didl_lite_object_add_resource (object);
+    gupnp_didl_lite_resource_set_uri (resource, "http://example.com/track.mp3");
+    g_object_unref (resource);
+    g_free (id);
+
+    if (first == NULL)
+      first = object;
+    else
+      g_object_unref (object);
+  }
+
+  /* Everything but the last item has been written, objects still held
+   * stay usable but do not change the output anymore */
+  g_assert_cmpuint (g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream)), >, 0);
+  gupnp_didl_lite_object_set_title (first, "Changed");
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (first), ==, "Changed");
+  g_object_unref (first);
+
+  g_assert_true (gupnp_didl_lite_writer_finish (writer, NULL, &error));
+  g_assert_no_error (error);
+  g_assert_true (g_output_stream_close (stream, NULL, NULL));
+  g_object_unref (writer);
+
+  bytes = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (stream));
+  didl = g_strndup (g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes));
+  g_assert_true (g_str_has_prefix (didl, "<DIDL-Lite "));
+  g_assert_true (g_str_has_suffix (didl, "</item></DIDL-Lite>"));
+  g_assert_null (strstr (didl, "Changed"));
+  g_assert_null (strstr (didl, "<upnp:genre>"));
+  /* Filtered when written, although added */
+  g_assert_null (strstr (didl, "<res"));
+
+  parser = gupnp_didl_lite_parser_new ();
+  objects = gupnp_didl_lite_parser_parse_didl_as_array (parser, didl, FALSE, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (objects->len, ==, 3);
+  for (i = 0; i < objects->len; i++) {
+    GUPnPDIDLLiteObject *object = g_ptr_array_index (objects, i);
+    char *id = g_strdup_printf ("%u", i);
+
+    g_assert_cmpstr (gupnp_didl_lite_object_get_id (object), ==, id);
+    g_assert_cmpstr (gupnp_didl_lite_object_get_title (object), ==, "Title & more");
+    g_assert_cmpstr (gupnp_didl_lite_object_get_album (object), ==, "Album");
+    g_free (id);
+  }
+  g_ptr_array_unref (objects);
+  g_object_unref (parser);
+  g_free (didl);
+  g_bytes_unref (bytes);
+  g_object_unref (stream);
+  gupnp_didl_lite_filter_unref (filter);
+
+  /* The first error sticks */
+  stream = g_memory_output_stream_new_resizable ();
+  g_output_stream_close (stream, NULL, NULL);
+  writer = gupnp_didl_lite_writer_new_for_stream (NULL, stream);
+  g_object_unref (gupnp_didl_lite_writer_add_container (writer));
+  g_object_unref (gupnp_didl_lite_writer_add_item (writer));
+  g_assert_false (gupnp_didl_lite_writer_flush (writer, NULL, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CLOSED);
+  g_clear_error (&error);
+  g_assert_false (gupnp_didl_lite_writer_finish (writer, NULL, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CLOSED);
+  g_clear_error (&error);
+  g_object_unref (writer);
+  g_object_unref (stream);
+}
+
+static GUPnPDIDLLiteObject *
+add_reset_test_item (GUPnPDIDLLiteWriter *writer, const char *title)
+{
+  GUPnPDIDLLiteObject *object = GUPNP_DIDL_LITE_OBJECT (gupnp_didl_lite_writer_add_item (writer));
+
+  gupnp_didl_lite_object_set_id (object, title);
+  gupnp_didl_lite_object_set_title (object, title);
+  gupnp_didl_lite_object_set_upnp_class (object, "object.item");
+
+  return object;
+}
+
+static void
+writer_reset (void)
+{
+  GUPnPDIDLLiteWriter *writer = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteWriter *fresh = gupnp_didl_lite_writer_new (NULL);
+  GUPnPDIDLLiteFilter *filter = gupnp_didl_lite_filter_new ("upnp:album");
+  char *expected;
+  char *xml;
+
+  gupnp_didl_lite_writer_set_filter (writer, filter);
+  g_object_unref (add_reset_test_item (writer, "First"));
+  g_object_unref (add_reset_test_item (writer, "Second"));
+
+  gupnp_didl_lite_writer_reset (writer);
+  g_assert_null (gupnp_didl_lite_writer_get_filter (writer));
+  g_assert_null (gupnp_didl_lite_writer_get_xml_node (writer)->children);
+
+  /* A reused writer gives the same result as a new one */
+  g_object_unref (add_reset_test_item (writer, "Third"));
+  g_object_unref (add_reset_test_item (fresh, "Third"));
+  xml = gupnp_didl_lite_writer_get_string (writer);
+  expected = gupnp_didl_lite_writer_get_string (fresh);
+  g_assert_cmpstr (xml, ==, expected);
+  g_assert_null (strstr (xml, "First"));
+  g_free (xml);
+  g_free (expected);
+
+  g_object_unref (fresh);
+  g_object_unref (writer);
+  gupnp_didl_lite_filter_unref (filter);
+}
+
+static void
+fragment_cache (void)
+{
+  GUPnPDIDLLiteFragmentCache *cache = gupnp_didl_lite_fragment_cache_new (2);
+  GUPnPDIDLLiteFilter *filter = gupnp_didl_lite_filter_new ("upnp:album,upnp:objectUpdateID");
+  GUPnPDIDLLiteFilter *wildcard = gupnp_didl_lite_filter_new ("*");
+  GUPnPDIDLLiteWriter *writer;
+  GUPnPDIDLLiteObject *object;
+  GUPnPDIDLLiteParser *parser;
+  GPtrArray *objects;
+  GError *error = NULL;
+  GBytes *fragment;
+  GBytes *cached;
+  GBytes *bytes;
+  GOutputStream *stream;
+  xmlNode *root;
+  char *xml;
+
+  /* Build an object once, filtered for the request */
+  writer = gupnp_didl_lite_writer_new (NULL);
+  gupnp_didl_lite_writer_set_filter (writer, filter);
+  object = add_reset_test_item (writer, "Second");
+  gupnp_didl_lite_object_set_id (object, "2");
+  gupnp_didl_lite_object_set_update_id (object, 7);
+  fragment = gupnp_didl_lite_fragment_cache_insert_object (cache, object, filter);
+  g_object_unref (object);
+
+  cached = gupnp_didl_lite_fragment_cache_lookup (cache, "2", 7, filter);
+  g_assert_true (cached == fragment);
+  g_bytes_unref (cached);
+  g_assert_null (gupnp_didl_lite_fragment_cache_lookup (cache, "2", 8, filter));
+  g_assert_null (gupnp_didl_lite_fragment_cache_lookup (cache, "2", 7, NULL));
+
+  /* No filter and the wildcard share their fragments */
+  gupnp_didl_lite_fragment_cache_insert (cache, "1", 0, NULL, fragment);
+  cached = gupnp_didl_lite_fragment_cache_lookup (cache, "1", 0, wildcard);
+  g_assert_nonnull (cached);
+  g_bytes_unref (cached);
+
+  /* The least recently used entry goes first */
+  gupnp_didl_lite_fragment_cache_insert (cache, "3", 0, NULL, fragment);
+  g_assert_cmpuint (gupnp_didl_lite_fragment_cache_get_length (cache), ==, 2);
+  g_assert_null (gupnp_didl_lite_fragment_cache_lookup (cache, "2", 7, filter));
+
+  gupnp_didl_lite_fragment_cache_remove (cache, "3");
+  g_assert_cmpuint (gupnp_didl_lite_fragment_cache_get_length (cache), ==, 1);
+  gupnp_didl_lite_fragment_cache_clear (cache);
+  g_assert_cmpuint (gupnp_didl_lite_fragment_cache_get_length (cache), ==, 0);
+
+  /* Spliced in as is, next to objects built as usual, and left alone by
+   * the filter */
+  g_object_unref (writer);
+  writer = gupnp_didl_lite_writer_new (NULL);
+  gupnp_didl_lite_writer_add_serialized (writer, fragment);
+  g_object_unref (add_reset_test_item (writer, "Third"));
+  gupnp_didl_lite_writer_add_serialized (writer, fragment);
+  gupnp_didl_lite_writer_filter (writer, "upnp:genre");
+  xml = gupnp_didl_lite_writer_get_string (writer);
+  g_assert_nonnull (strstr (xml, "<upnp:objectUpdateID>7</upnp:objectUpdateID>"));
+
+  parser = gupnp_didl_lite_parser_new ();
+  objects = gupnp_didl_lite_parser_parse_didl_as_array (parser, xml, FALSE, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (objects->len, ==, 3);
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (g_ptr_array_index (objects, 0)), ==, "Second");
+  g_assert_cmpuint (gupnp_didl_lite_object_get_update_id (g_ptr_array_index (objects, 0)), ==, 7);
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (g_ptr_array_index (objects, 1)), ==, "Third");
+  g_assert_cmpstr (gupnp_didl_lite_object_get_id (g_ptr_array_index (objects, 2)), ==, "2");
+  g_ptr_array_unref (objects);
+
+  /* The tree only holds the objects built as usual */
+  root = gupnp_didl_lite_writer_get_xml_node (writer);
+  g_assert_nonnull (root->children);
+  g_assert_true (root->children == root->last);
+  g_assert_cmpint (root->children->type, ==, XML_ELEMENT_NODE);
+
+  bytes = gupnp_didl_lite_writer_get_bytes (writer);
+  g_assert_cmpmem (g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes), xml, strlen (xml));
+  g_bytes_unref (bytes);
+
+  stream = g_memory_output_stream_new_resizable ();
+  g_assert_true (gupnp_didl_lite_writer_write_to_stream (writer, stream, NULL, &error));
+  g_assert_no_error (error);
+  g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream)),
+                   g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream)),
+                   xml, strlen (xml));
+  g_object_unref (stream);
+  g_free (xml);
+
+  /* Resetting drops them along with the tree */
+  gupnp_didl_lite_writer_reset (writer);
+  g_object_unref (add_reset_test_item (writer, "Fourth"));
+  xml = gupnp_didl_lite_writer_get_string (writer);
+  objects = gupnp_didl_lite_parser_parse_didl_as_array (parser, xml, FALSE, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (objects->len, ==, 1);
+  g_assert_cmpstr (gupnp_didl_lite_object_get_title (g_ptr_array_index (objects, 0)), ==, "Fourth");
+  g_ptr_array_unref (objects);
+  g_object_unref (parser);
+  g_free (xml);
+
+  g_object_unref (writer);
+  g_bytes_unref (fragment);
+  gupnp_didl_lite_filter_unref (wildcard);
+  gupnp_didl_lite_filter_unref (filter);
+  gupnp_didl_lite_fragment_cache_unref (cache);
+}
+
 int
 main (int argc, char **argv)
 {
   g_test_init (&argc, &argv, NULL);
 
   g_test_add_func ("/didl-lite-object/namespace-getters", namespace_getters);
+  g_test_add_func ("/didl-lite-object/property-index", property_index);
+  g_test_add_func ("/didl-lite-object/resource-cache", resource_cache);
+  g_test_add_func ("/didl-lite-object/compat-resource-matcher", compat_resource_matcher);
+  g_test_add_func ("/didl-lite-object/bulk-fields", bulk_fields);
+  g_test_add_func ("/didl-lite-object/snapshot", snapshot_roundtrip);
+  g_test_add_func ("/didl-lite-object/snapshot-variant", snapshot_variant);
+  g_test_add_func ("/didl-lite-object/catalog", catalog);
+  g_test_add_func ("/didl-lite-object/xml-output", xml_output);
+  g_test_add_func ("/didl-lite-object/date", date_accessors);
+  g_test_add_func ("/didl-lite-object/date-shared-node", date_shared_node);
+  g_test_add_func ("/didl-lite-object/compiled-filter", compiled_filter);
+  g_test_add_func ("/didl-lite-object/writer-preset-filter", writer_preset_filter);
+  g_test_add_func ("/didl-lite-object/streaming-writer", streaming_writer);
+  g_test_add_func ("/didl-lite-object/writer-reset", writer_reset);
+  g_test_add_func ("/didl-lite-object/fragment-cache", fragment_cache);
 
   g_test_run ();
 
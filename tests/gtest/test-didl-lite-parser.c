@@ -0,0 +1,984 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include <libgupnp-av/gupnp-didl-lite-parser.h>
+
+#define TEST_DIDL_OBJECTS \
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>" \
+"<DIDL-Lite xmlns=\"urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/\" " \
+           "xmlns:dc=\"http://purl.org/dc/elements/1.1/\" " \
+           "xmlns:upnp=\"urn:schemas-upnp-org:metadata-1-0/upnp/\">\n" \
+"    <container id=\"1\" parentID=\"0\" restricted=\"1\">" \
+"        <dc:title>Music</dc:title>" \
+"        <upnp:class>object.container.storageFolder</upnp:class>" \
+"    </container>\n" \
+"    <!-- Ignored -->\n" \
+"    <item id=\"2\" parentID=\"1\" restricted=\"1\">" \
+"        <dc:title>Song &amp; Dance</dc:title>" \
+"        <upnp:class>object.item.audioItem.musicTrack</upnp:class>" \
+"        <res protocolInfo=\"http-get:*:audio/mpeg:*\">http://example.com/2</res>" \
+"    </item>\n" \
+"    <desc id=\"3\" nameSpace=\"urn:example\"/>\n" \
+"    <item id=\"4\" parentID=\"1\" restricted=\"0\">" \
+"        <dc:title>Second</dc:title>" \
+"        <upnp:class>object.item.audioItem</upnp:class>" \
+"    </item>\n" \
+"</DIDL-Lite>"
+
+#define TEST_DIDL_NESTED \
+"<DIDL-Lite xmlns=\"urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/\" " \
+           "xmlns:dc=\"http://purl.org/dc/elements/1.1/\" " \
+           "xmlns:upnp=\"urn:schemas-upnp-org:metadata-1-0/upnp/\">" \
+"    <container id=\"1\" parentID=\"0\" restricted=\"1\">" \
+"        <upnp:class>object.container</upnp:class>" \
+"        <item id=\"2\" parentID=\"1\" restricted=\"1\">" \
+"            <upnp:class>object.item</upnp:class>" \
+"        </item>" \
+"    </container>" \
+"    <item id=\"3\" parentID=\"0\" restricted=\"1\">" \
+"        <upnp:class>object.item</upnp:class>" \
+"    </item>" \
+"</DIDL-Lite>"
+
+#define TEST_DIDL_SCAN \
+"<DIDL-Lite xmlns:upnp=\"urn:schemas-upnp-org:metadata-1-0/upnp/\">" \
+"    <container id=\"a&amp;b\" parentID=\"&lt;p&#233;&#x41;&amp;amp;&gt;\">" \
+"        <upnp:objectUpdateID>12</upnp:objectUpdateID>" \
+"        <upnp:containerUpdateID>7</upnp:containerUpdateID>" \
+"        <item id=\"nested\"/>" \
+"    </container>" \
+"</DIDL-Lite>"
+
+static void
+on_object_available (G_GNUC_UNUSED GUPnPDIDLLiteParser *parser,
+                     GUPnPDIDLLiteObject               *object,
+                     gpointer                           user_data)
+{
+        GPtrArray *objects = (GPtrArray *) user_data;
+
+        g_ptr_array_add (objects, g_object_ref (object));
+}
+
+static GPtrArray *
+parse_objects (gboolean streaming, const char *didl, GError **error)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects;
+
+        objects = g_ptr_array_new_with_free_func (g_object_unref);
+        parser = gupnp_didl_lite_parser_new ();
+        gupnp_didl_lite_parser_set_streaming (parser, streaming);
+        g_signal_connect (parser,
+                          "object-available",
+                          G_CALLBACK (on_object_available),
+                          objects);
+
+        if (!gupnp_didl_lite_parser_parse_didl (parser, didl, error))
+                g_clear_pointer (&objects, g_ptr_array_unref);
+
+        g_object_unref (parser);
+
+        return objects;
+}
+
+static void
+test_didl_lite_parser_streaming (void)
+{
+        GPtrArray *tree;
+        GPtrArray *stream;
+        GError *error = NULL;
+        guint i;
+
+        tree = parse_objects (FALSE, TEST_DIDL_OBJECTS, &error);
+        g_assert_no_error (error);
+        stream = parse_objects (TRUE, TEST_DIDL_OBJECTS, &error);
+        g_assert_no_error (error);
+
+        g_assert_cmpuint (stream->len, ==, 3);
+        g_assert_cmpuint (stream->len, ==, tree->len);
+
+        /* Objects outlive the parser run in both modes */
+        for (i = 0; i < stream->len; i++) {
+                GUPnPDIDLLiteObject *a = g_ptr_array_index (tree, i);
+                GUPnPDIDLLiteObject *b = g_ptr_array_index (stream, i);
+                char *a_xml, *b_xml;
+
+                g_assert_cmpstr (gupnp_didl_lite_object_get_id (a),
+                                 ==,
+                                 gupnp_didl_lite_object_get_id (b));
+                g_assert_cmpstr (gupnp_didl_lite_object_get_title (a),
+                                 ==,
+                                 gupnp_didl_lite_object_get_title (b));
+                g_assert_true (G_OBJECT_TYPE (a) == G_OBJECT_TYPE (b));
+
+                a_xml = gupnp_didl_lite_object_get_xml_string (a);
+                b_xml = gupnp_didl_lite_object_get_xml_string (b);
+                g_assert_cmpstr (a_xml, ==, b_xml);
+                g_free (a_xml);
+                g_free (b_xml);
+        }
+
+        g_assert_cmpstr (gupnp_didl_lite_object_get_title
+                                        (g_ptr_array_index (stream, 1)),
+                         ==,
+                         "Song & Dance");
+
+        g_ptr_array_unref (tree);
+        g_ptr_array_unref (stream);
+}
+
+static void
+test_didl_lite_parser_streaming_errors (void)
+{
+        GPtrArray *objects;
+        GError *error = NULL;
+
+        objects = parse_objects (TRUE, "This is just some random text", &error);
+        g_assert_null (objects);
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE);
+        g_clear_error (&error);
+
+        objects = parse_objects (TRUE,
+                                 "<DIDL-Lite xmlns=\"urn:schemas-upnp-org:"
+                                 "metadata-1-0/DIDL-Lite/\"/>",
+                                 &error);
+        g_assert_null (objects);
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_EMPTY);
+        g_clear_error (&error);
+}
+
+static void
+test_didl_lite_parser_feed (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects;
+        GError *error = NULL;
+        const char *didl = TEST_DIDL_OBJECTS;
+        gsize length = strlen (didl);
+        gsize offset;
+
+        objects = g_ptr_array_new_with_free_func (g_object_unref);
+        parser = gupnp_didl_lite_parser_new ();
+        g_signal_connect (parser,
+                          "object-available",
+                          G_CALLBACK (on_object_available),
+                          objects);
+
+        /* Objects become available while the document is still arriving */
+        for (offset = 0; offset < length; offset += 7) {
+                g_assert_true (gupnp_didl_lite_parser_feed
+                                        (parser,
+                                         didl + offset,
+                                         MIN (7, length - offset),
+                                         &error));
+                g_assert_no_error (error);
+
+                if (offset + 7 < (gsize) (strstr (didl, "</item>") - didl))
+                        g_assert_cmpuint (objects->len, <=, 1);
+        }
+        g_assert_cmpuint (objects->len, ==, 3);
+
+        g_assert_true (gupnp_didl_lite_parser_finish (parser, &error));
+        g_assert_no_error (error);
+        g_assert_cmpuint (objects->len, ==, 3);
+        g_assert_cmpstr (gupnp_didl_lite_object_get_id
+                                        (g_ptr_array_index (objects, 2)),
+                         ==,
+                         "4");
+
+        /* The parser can be reused and reports truncated input */
+        g_assert_true (gupnp_didl_lite_parser_feed (parser, didl, 10, &error));
+        g_assert_false (gupnp_didl_lite_parser_finish (parser, &error));
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE);
+        g_clear_error (&error);
+
+        g_ptr_array_unref (objects);
+        g_object_unref (parser);
+}
+
+static void
+test_didl_lite_parser_parse_bytes (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects;
+        GString *didl;
+        GBytes *bytes;
+        GError *error = NULL;
+        guint i;
+
+        objects = g_ptr_array_new_with_free_func (g_object_unref);
+        parser = gupnp_didl_lite_parser_new ();
+        g_signal_connect (parser,
+                          "object-available",
+                          G_CALLBACK (on_object_available),
+                          objects);
+
+        /* The input does not need to be nul-terminated */
+        didl = g_string_new (TEST_DIDL_OBJECTS);
+        g_string_append (didl, "<trailing garbage");
+        bytes = g_bytes_new (didl->str, strlen (TEST_DIDL_OBJECTS));
+        g_assert_true (gupnp_didl_lite_parser_parse_bytes (parser,
+                                                           bytes,
+                                                           FALSE,
+                                                           &error));
+        g_assert_no_error (error);
+        g_assert_cmpuint (objects->len, ==, 3);
+        g_bytes_unref (bytes);
+
+        /* Errors on large documents stay small */
+        g_string_assign (didl, "<?xml version=\"1.0\"?>\n<NotDIDL>\n");
+        for (i = 0; i < 10000; i++)
+                g_string_append (didl, "<item><title>Filler</title></item>\n");
+        g_string_append (didl, "</NotDIDL>");
+        bytes = g_string_free_to_bytes (didl);
+
+        g_assert_false (gupnp_didl_lite_parser_parse_bytes (parser,
+                                                            bytes,
+                                                            FALSE,
+                                                            &error));
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE);
+        g_assert_cmpuint (strlen (error->message), <, 200);
+        g_clear_error (&error);
+
+        gupnp_didl_lite_parser_set_streaming (parser, TRUE);
+        g_assert_false (gupnp_didl_lite_parser_parse_bytes (parser,
+                                                            bytes,
+                                                            FALSE,
+                                                            &error));
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE);
+        g_assert_cmpuint (strlen (error->message), <, 200);
+        g_clear_error (&error);
+        g_bytes_unref (bytes);
+
+        g_ptr_array_unref (objects);
+        g_object_unref (parser);
+}
+
+static void
+on_object_count (G_GNUC_UNUSED GUPnPDIDLLiteParser *parser,
+                 G_GNUC_UNUSED GUPnPDIDLLiteObject *object,
+                 gpointer                           user_data)
+{
+        (*(guint *) user_data)++;
+}
+
+static void
+test_didl_lite_parser_as_array (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects;
+        GError *error = NULL;
+        guint signal_count = 0;
+        guint i;
+
+        parser = gupnp_didl_lite_parser_new ();
+        g_signal_connect (parser,
+                          "object-available",
+                          G_CALLBACK (on_object_count),
+                          &signal_count);
+
+        objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_OBJECTS,
+                                         FALSE,
+                                         &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (objects);
+        g_assert_cmpuint (objects->len, ==, 3);
+        g_assert_true (GUPNP_IS_DIDL_LITE_CONTAINER
+                                        (g_ptr_array_index (objects, 0)));
+        g_assert_cmpstr (gupnp_didl_lite_object_get_id
+                                        (g_ptr_array_index (objects, 1)),
+                         ==,
+                         "2");
+        g_ptr_array_unref (objects);
+        g_assert_cmpuint (signal_count, ==, 0);
+
+        objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         "<DIDL-Lite/>",
+                                         FALSE,
+                                         &error);
+        g_assert_null (objects);
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_EMPTY);
+        g_clear_error (&error);
+
+        /* Nested objects follow their container, in both modes */
+        for (i = 0; i < 2; i++) {
+                gupnp_didl_lite_parser_set_streaming (parser, i == 1);
+
+                objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_NESTED,
+                                         FALSE,
+                                         &error);
+                g_assert_no_error (error);
+                g_assert_cmpuint (objects->len, ==, 2);
+                g_assert_cmpstr (gupnp_didl_lite_object_get_id
+                                        (g_ptr_array_index (objects, 1)),
+                                 ==,
+                                 "3");
+                g_ptr_array_unref (objects);
+
+                objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_NESTED,
+                                         TRUE,
+                                         &error);
+                g_assert_no_error (error);
+                g_assert_cmpuint (objects->len, ==, 3);
+                g_assert_cmpstr (gupnp_didl_lite_object_get_id
+                                        (g_ptr_array_index (objects, 1)),
+                                 ==,
+                                 "2");
+                g_assert_cmpstr (gupnp_didl_lite_object_get_parent_id
+                                        (g_ptr_array_index (objects, 1)),
+                                 ==,
+                                 "1");
+                g_assert_cmpstr (gupnp_didl_lite_object_get_id
+                                        (g_ptr_array_index (objects, 2)),
+                                 ==,
+                                 "3");
+                g_ptr_array_unref (objects);
+        }
+        g_assert_cmpuint (signal_count, ==, 0);
+
+        g_object_unref (parser);
+}
+
+static void
+on_parse_didl_done (GObject      *source,
+                    GAsyncResult *result,
+                    gpointer      user_data)
+{
+        GPtrArray **out = (GPtrArray **) user_data;
+        GError *error = NULL;
+
+        *out = gupnp_didl_lite_parser_parse_didl_finish
+                                        (GUPNP_DIDL_LITE_PARSER (source),
+                                         result,
+                                         &error);
+        g_assert_no_error (error);
+}
+
+static void
+test_didl_lite_parser_async (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects = NULL;
+
+        parser = gupnp_didl_lite_parser_new ();
+        gupnp_didl_lite_parser_parse_didl_async (parser,
+                                                 TEST_DIDL_OBJECTS,
+                                                 NULL,
+                                                 on_parse_didl_done,
+                                                 &objects);
+
+        while (objects == NULL)
+                g_main_context_iteration (NULL, TRUE);
+
+        g_assert_cmpuint (objects->len, ==, 3);
+        g_assert_cmpstr (gupnp_didl_lite_object_get_title
+                                        (g_ptr_array_index (objects, 1)),
+                         ==,
+                         "Song & Dance");
+
+        g_ptr_array_unref (objects);
+        g_object_unref (parser);
+}
+
+static gpointer
+parse_in_thread (gpointer user_data)
+{
+        GUPnPDIDLLiteParser *parser;
+        guint i;
+
+        parser = gupnp_didl_lite_parser_new ();
+        gupnp_didl_lite_parser_set_streaming (parser,
+                                              GPOINTER_TO_UINT (user_data) % 2);
+
+        for (i = 0; i < 100; i++) {
+                GPtrArray *objects;
+                GError *error = NULL;
+
+                objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_OBJECTS,
+                                         FALSE,
+                                         &error);
+                g_assert_no_error (error);
+                g_assert_cmpuint (objects->len, ==, 3);
+                g_assert_cmpstr (gupnp_didl_lite_object_get_upnp_class
+                                        (g_ptr_array_index (objects, 2)),
+                                 ==,
+                                 "object.item.audioItem");
+                g_ptr_array_unref (objects);
+        }
+
+        g_object_unref (parser);
+
+        return NULL;
+}
+
+static void
+test_didl_lite_parser_threads (void)
+{
+        GThread *threads[4];
+        guint i;
+
+        for (i = 0; i < G_N_ELEMENTS (threads); i++)
+                threads[i] = g_thread_new ("parser",
+                                           parse_in_thread,
+                                           GUINT_TO_POINTER (i));
+
+        for (i = 0; i < G_N_ELEMENTS (threads); i++)
+                g_thread_join (threads[i]);
+}
+
+static gpointer
+parse_for_handover (G_GNUC_UNUSED gpointer user_data)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects;
+        GError *error = NULL;
+
+        parser = gupnp_didl_lite_parser_new ();
+        objects = gupnp_didl_lite_parser_parse_didl_as_array (parser,
+                                                              TEST_DIDL_OBJECTS,
+                                                              FALSE,
+                                                              &error);
+        g_assert_no_error (error);
+        g_object_unref (parser);
+
+        return objects;
+}
+
+static gpointer
+use_handed_over (gpointer user_data)
+{
+        GPtrArray *objects = (GPtrArray *) user_data;
+        guint i;
+
+        /* Setters change the document the objects share */
+        for (i = 0; i < objects->len; i++)
+                gupnp_didl_lite_object_set_album (g_ptr_array_index (objects,
+                                                                     i),
+                                                  "Album");
+
+        return objects;
+}
+
+static void
+test_didl_lite_parser_threads_handover (void)
+{
+        GThread *threads[4];
+        GPtrArray *objects[G_N_ELEMENTS (threads)];
+        guint i, j;
+
+        /* All objects of one parse move between threads together, while
+         * the objects of separate parses are used concurrently */
+        for (i = 0; i < G_N_ELEMENTS (threads); i++)
+                threads[i] = g_thread_new ("parser", parse_for_handover, NULL);
+        for (i = 0; i < G_N_ELEMENTS (threads); i++)
+                objects[i] = g_thread_join (threads[i]);
+
+        for (i = 0; i < G_N_ELEMENTS (threads); i++)
+                threads[i] = g_thread_new ("user",
+                                           use_handed_over,
+                                           objects[i]);
+        for (i = 0; i < G_N_ELEMENTS (threads); i++)
+                g_thread_join (threads[i]);
+
+        for (i = 0; i < G_N_ELEMENTS (threads); i++) {
+                g_assert_cmpuint (objects[i]->len, ==, 3);
+                for (j = 0; j < objects[i]->len; j++)
+                        g_assert_cmpstr (gupnp_didl_lite_object_get_album
+                                        (g_ptr_array_index (objects[i], j)),
+                                         ==,
+                                         "Album");
+                g_ptr_array_unref (objects[i]);
+        }
+}
+
+#define TEST_DIDL_FILTER \
+"<DIDL-Lite xmlns=\"urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/\" " \
+           "xmlns:dc=\"http://purl.org/dc/elements/1.1/\" " \
+           "xmlns:upnp=\"urn:schemas-upnp-org:metadata-1-0/upnp/\">" \
+"<item id=\"2\" parentID=\"1\" restricted=\"1\">" \
+"<dc:title>Song</dc:title>" \
+"<dc:creator>Someone</dc:creator>" \
+"<upnp:class>object.item.audioItem.musicTrack</upnp:class>" \
+"<upnp:album>Album</upnp:album>" \
+"<upnp:albumArtURI>http://example.com/art</upnp:albumArtURI>" \
+"<res protocolInfo=\"http-get:*:audio/mpeg:*\" size=\"42\" " \
+     "bitrate=\"128\">http://example.com/2</res>" \
+"</item>" \
+"</DIDL-Lite>"
+
+/* The storage usage comes before the class */
+#define TEST_DIDL_STORAGE \
+"<DIDL-Lite xmlns=\"urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/\" " \
+           "xmlns:dc=\"http://purl.org/dc/elements/1.1/\" " \
+           "xmlns:upnp=\"urn:schemas-upnp-org:metadata-1-0/upnp/\">" \
+"<container id=\"1\" parentID=\"0\" restricted=\"1\">" \
+"<upnp:storageUsed>100</upnp:storageUsed>" \
+"<upnp:class>object.container.storageFolder</upnp:class>" \
+"</container>" \
+"<container id=\"2\" parentID=\"0\" restricted=\"1\">" \
+"<upnp:storageUsed>200</upnp:storageUsed>" \
+"<upnp:class>object.container.album.musicAlbum</upnp:class>" \
+"</container>" \
+"</DIDL-Lite>"
+
+static void
+test_didl_lite_parser_filter (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GPtrArray *objects;
+        GError *error = NULL;
+        guint streaming;
+
+        parser = gupnp_didl_lite_parser_new ();
+        gupnp_didl_lite_parser_set_filter (parser, "upnp:album,res@size");
+        g_assert_cmpstr (gupnp_didl_lite_parser_get_filter (parser),
+                         ==,
+                         "upnp:album,res@size");
+
+        for (streaming = 0; streaming < 2; streaming++) {
+                GUPnPDIDLLiteObject *object;
+                GUPnPDIDLLiteResource *resource;
+                GList *resources;
+                char *xml;
+
+                gupnp_didl_lite_parser_set_streaming (parser, streaming);
+                objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_FILTER,
+                                         FALSE,
+                                         &error);
+                g_assert_no_error (error);
+                g_assert_cmpuint (objects->len, ==, 1);
+
+                object = g_ptr_array_index (objects, 0);
+                g_assert_cmpstr (gupnp_didl_lite_object_get_id (object),
+                                 ==,
+                                 "2");
+                g_assert_cmpstr (gupnp_didl_lite_object_get_title (object),
+                                 ==,
+                                 "Song");
+                g_assert_cmpstr (gupnp_didl_lite_object_get_album (object),
+                                 ==,
+                                 "Album");
+                g_assert_null (gupnp_didl_lite_object_get_creator (object));
+                g_assert_null
+                        (gupnp_didl_lite_object_get_album_art (object));
+
+                resources = gupnp_didl_lite_object_get_resources (object);
+                g_assert_cmpuint (g_list_length (resources), ==, 1);
+                resource = resources->data;
+                g_assert_cmpint (gupnp_didl_lite_resource_get_size64
+                                        (resource),
+                                 ==,
+                                 42);
+                g_assert_cmpint (gupnp_didl_lite_resource_get_bitrate
+                                        (resource),
+                                 ==,
+                                 -1);
+                g_list_free_full (resources, g_object_unref);
+
+                xml = gupnp_didl_lite_object_get_xml_string (object);
+                g_assert_null (strstr (xml, "albumArtURI"));
+                g_free (xml);
+
+                g_ptr_array_unref (objects);
+
+                /* Only storage folders keep their storage usage, as with
+                 * gupnp_didl_lite_writer_filter() */
+                objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_STORAGE,
+                                         FALSE,
+                                         &error);
+                g_assert_no_error (error);
+                g_assert_cmpuint (objects->len, ==, 2);
+                g_assert_cmpint (gupnp_didl_lite_container_get_storage_used
+                                        (g_ptr_array_index (objects, 0)),
+                                 ==,
+                                 100);
+                g_assert_cmpint (gupnp_didl_lite_container_get_storage_used
+                                        (g_ptr_array_index (objects, 1)),
+                                 ==,
+                                 -1);
+                g_ptr_array_unref (objects);
+        }
+
+        /* The wildcard keeps everything */
+        gupnp_didl_lite_parser_set_filter (parser, "*");
+        objects = gupnp_didl_lite_parser_parse_didl_as_array (parser,
+                                                              TEST_DIDL_FILTER,
+                                                              FALSE,
+                                                              &error);
+        g_assert_no_error (error);
+        g_assert_cmpstr (gupnp_didl_lite_object_get_creator
+                                (g_ptr_array_index (objects, 0)),
+                         ==,
+                         "Someone");
+        g_ptr_array_unref (objects);
+
+        objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_STORAGE,
+                                         FALSE,
+                                         &error);
+        g_assert_no_error (error);
+        g_assert_cmpint (gupnp_didl_lite_container_get_storage_used
+                                (g_ptr_array_index (objects, 1)),
+                         ==,
+                         200);
+        g_ptr_array_unref (objects);
+
+        g_object_unref (parser);
+}
+
+static void
+test_didl_lite_parser_string_dict (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GUPnPAVStringDict *dict;
+        GPtrArray *first;
+        GPtrArray *second;
+        GError *error = NULL;
+        gsize size;
+
+        dict = gupnp_av_string_dict_new ();
+        g_assert_cmpuint (gupnp_av_string_dict_get_size (dict), ==, 0);
+
+        parser = gupnp_didl_lite_parser_new ();
+        g_object_set (parser, "string-dict", dict, NULL);
+        g_assert_true (gupnp_didl_lite_parser_get_string_dict (parser) == dict);
+
+        first = gupnp_didl_lite_parser_parse_didl_as_array (parser,
+                                                            TEST_DIDL_OBJECTS,
+                                                            FALSE,
+                                                            &error);
+        g_assert_no_error (error);
+        size = gupnp_av_string_dict_get_size (dict);
+        g_assert_cmpuint (size, >, 0);
+
+        /* A document with the same structure adds nothing new */
+        gupnp_didl_lite_parser_set_streaming (parser, TRUE);
+        second = gupnp_didl_lite_parser_parse_didl_as_array (parser,
+                                                             TEST_DIDL_OBJECTS,
+                                                             FALSE,
+                                                             &error);
+        g_assert_no_error (error);
+        g_assert_cmpuint (gupnp_av_string_dict_get_size (dict), ==, size);
+
+        /* The objects keep the dictionary alive */
+        g_object_unref (parser);
+        gupnp_av_string_dict_unref (dict);
+
+        g_assert_cmpstr (gupnp_didl_lite_object_get_upnp_class
+                                        (g_ptr_array_index (first, 1)),
+                         ==,
+                         "object.item.audioItem.musicTrack");
+        gupnp_didl_lite_object_set_upnp_class (g_ptr_array_index (second, 1),
+                                               "object.item");
+        g_assert_cmpstr (gupnp_didl_lite_object_get_upnp_class
+                                        (g_ptr_array_index (second, 1)),
+                         ==,
+                         "object.item");
+
+        g_ptr_array_unref (first);
+        g_ptr_array_unref (second);
+}
+
+static void
+test_didl_lite_parser_scan (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GUPnPDIDLLiteScanResult *result;
+        const GUPnPDIDLLiteScanEntry *entry;
+        GBytes *bytes;
+        GError *error = NULL;
+
+        parser = gupnp_didl_lite_parser_new ();
+        bytes = g_bytes_new_static (TEST_DIDL_OBJECTS,
+                                    strlen (TEST_DIDL_OBJECTS));
+        result = gupnp_didl_lite_parser_scan_bytes (parser, bytes, &error);
+        g_bytes_unref (bytes);
+        g_assert_no_error (error);
+        g_assert_nonnull (result);
+        g_assert_cmpuint (gupnp_didl_lite_scan_result_get_length (result),
+                          ==,
+                          3);
+
+        entry = gupnp_didl_lite_scan_result_get_entry (result, 0);
+        g_assert_cmpstr (entry->id, ==, "1");
+        g_assert_cmpstr (entry->parent_id, ==, "0");
+        g_assert_cmpstr (entry->upnp_class,
+                         ==,
+                         "object.container.storageFolder");
+        g_assert_true (entry->is_container);
+        g_assert_false (entry->update_id_set);
+
+        entry = gupnp_didl_lite_scan_result_lookup (result, "4");
+        g_assert_true (entry ==
+                       gupnp_didl_lite_scan_result_get_entry (result, 2));
+        g_assert_cmpstr (entry->parent_id, ==, "1");
+        g_assert_cmpstr (entry->upnp_class, ==, "object.item.audioItem");
+        g_assert_false (entry->is_container);
+        g_assert_null (gupnp_didl_lite_scan_result_lookup (result, "3"));
+        gupnp_didl_lite_scan_result_unref (result);
+
+        /* Update IDs, escaped IDs and no nested objects */
+        bytes = g_bytes_new_static (TEST_DIDL_SCAN, strlen (TEST_DIDL_SCAN));
+        result = gupnp_didl_lite_parser_scan_bytes (parser, bytes, &error);
+        g_bytes_unref (bytes);
+        g_assert_no_error (error);
+        g_assert_cmpuint (gupnp_didl_lite_scan_result_get_length (result),
+                          ==,
+                          1);
+        entry = gupnp_didl_lite_scan_result_get_entry (result, 0);
+        g_assert_cmpstr (entry->id, ==, "a&b");
+        g_assert_cmpstr (entry->parent_id, ==, "<p\xc3\xa9" "A&amp;>");
+        g_assert_null (entry->upnp_class);
+        g_assert_true (entry->update_id_set);
+        g_assert_cmpuint (entry->update_id, ==, 12);
+        g_assert_true (entry->container_update_id_set);
+        g_assert_cmpuint (entry->container_update_id, ==, 7);
+        gupnp_didl_lite_scan_result_unref (result);
+
+        bytes = g_bytes_new_static ("<DIDL-Lite/>", 12);
+        result = gupnp_didl_lite_parser_scan_bytes (parser, bytes, &error);
+        g_bytes_unref (bytes);
+        g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_EMPTY);
+        g_assert_null (result);
+        g_clear_error (&error);
+
+        g_object_unref (parser);
+}
+
+static void
+collect_handle (GUPnPDIDLLiteObjectHandle *handle,
+                gpointer                   user_data)
+{
+        g_ptr_array_add ((GPtrArray *) user_data,
+                         gupnp_didl_lite_object_handle_ref (handle));
+}
+
+static void
+test_didl_lite_parser_lazy (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GUPnPDIDLLiteObjectHandle *handle;
+        GUPnPDIDLLiteObject *object;
+        GUPnPDIDLLiteObject *again;
+        GPtrArray *handles;
+        GError *error = NULL;
+
+        parser = gupnp_didl_lite_parser_new ();
+        handles = g_ptr_array_new_with_free_func
+                        ((GDestroyNotify) gupnp_didl_lite_object_handle_unref);
+        g_assert_true (gupnp_didl_lite_parser_parse_didl_lazy (parser,
+                                                               TEST_DIDL_OBJECTS,
+                                                               FALSE,
+                                                               collect_handle,
+                                                               handles,
+                                                               &error));
+        g_assert_no_error (error);
+        g_object_unref (parser);
+
+        g_assert_cmpuint (handles->len, ==, 3);
+
+        handle = g_ptr_array_index (handles, 0);
+        g_assert_true (gupnp_didl_lite_object_handle_is_container (handle));
+        g_assert_cmpstr (gupnp_didl_lite_object_handle_get_id (handle),
+                         ==,
+                         "1");
+
+        /* Handles outlive the parser and are upgraded on demand */
+        handle = g_ptr_array_index (handles, 1);
+        g_assert_false (gupnp_didl_lite_object_handle_is_container (handle));
+        g_assert_cmpstr (gupnp_didl_lite_object_handle_get_parent_id (handle),
+                         ==,
+                         "1");
+        g_assert_cmpstr (gupnp_didl_lite_object_handle_get_upnp_class (handle),
+                         ==,
+                         "object.item.audioItem.musicTrack");
+
+        object = gupnp_didl_lite_object_handle_get_object (handle);
+        g_assert_true (GUPNP_IS_DIDL_LITE_ITEM (object));
+        g_assert_cmpstr (gupnp_didl_lite_object_get_title (object),
+                         ==,
+                         "Song & Dance");
+        again = gupnp_didl_lite_object_handle_get_object (handle);
+        g_assert_true (object == again);
+        g_object_unref (again);
+
+        g_ptr_array_unref (handles);
+
+        /* The object keeps its document */
+        g_assert_cmpstr (gupnp_didl_lite_object_get_id (object), ==, "2");
+        g_object_unref (object);
+}
+
+static void
+test_didl_lite_parser_detach (void)
+{
+        GUPnPDIDLLiteParser *parser;
+        GUPnPDIDLLiteObject *object;
+        GPtrArray *objects;
+        GError *error = NULL;
+        xmlNode *node;
+        xmlNs *ns;
+        char *xml;
+        guint n_ns = 0;
+
+        parser = gupnp_didl_lite_parser_new ();
+        objects = gupnp_didl_lite_parser_parse_didl_as_array
+                                        (parser,
+                                         TEST_DIDL_OBJECTS,
+                                         FALSE,
+                                         &error);
+        g_assert_no_error (error);
+        g_object_unref (parser);
+
+        object = g_object_ref (g_ptr_array_index (objects, 2));
+        gupnp_didl_lite_object_detach (object);
+        g_ptr_array_unref (objects);
+
+        g_assert_cmpstr (gupnp_didl_lite_object_get_id (object), ==, "4");
+        g_assert_cmpstr (gupnp_didl_lite_object_get_title (object),
+                         ==,
+                         "Second");
+
+        /* Only the namespaces in use are declared in the new document */
+        node = gupnp_didl_lite_object_get_xml_node (object);
+        g_assert_null (node->prev);
+        g_assert_null (node->next);
+        for (ns = node->parent->nsDef; ns != NULL; ns = ns->next)
+                n_ns++;
+        g_assert_cmpuint (n_ns, ==, 3);
+
+        gupnp_didl_lite_object_set_album (object, "Album");
+        gupnp_didl_lite_object_set_dlna_managed (object,
+                                                 GUPNP_OCM_FLAGS_UPLOAD);
+        xml = gupnp_didl_lite_object_get_xml_string (object);
+        g_assert_nonnull (strstr (xml, "<upnp:album>Album</upnp:album>"));
+        g_assert_nonnull (strstr (xml, "dlna:dlnaManaged="));
+        g_free (xml);
+
+        g_object_unref (object);
+}
+
+static gboolean
+parse_date (const char *date)
+{
+        GPtrArray *objects;
+        GError *error = NULL;
+        char *didl;
+
+        didl = g_strdup_printf
+                ("<DIDL-Lite xmlns=\"urn:schemas-upnp-org:metadata-1-0/"
+                 "DIDL-Lite/\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\">"
+                 "<item id=\"1\" parentID=\"0\" restricted=\"1\">"
+                 "<dc:date>%s</dc:date>"
+                 "</item>"
+                 "</DIDL-Lite>",
+                 date);
+        objects = parse_objects (FALSE, didl, &error);
+        g_free (didl);
+
+        if (objects == NULL) {
+                g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE);
+                g_error_free (error);
+
+                return FALSE;
+        }
+
+        g_assert_no_error (error);
+        g_assert_cmpuint (objects->len, ==, 1);
+        g_ptr_array_unref (objects);
+
+        return TRUE;
+}
+
+static void
+test_didl_lite_parser_dates (void)
+{
+        /* The date is roughly checked against ^\d{4}-\d{1,2}-\d{1,2},
+         * and the check stops after ten characters if more follow */
+        const char *accepted[] = {
+                "",
+                "2021-04-23",
+                "2021-4-3",
+                "2021-4-23",
+                "2021-04-23T18:18:42+02:00",
+                "2021-04-234",
+                "2021-13-45",
+                "12345678901",
+                "2020-12345xyz",
+        };
+        const char *rejected[] = {
+                "2021",
+                "2021-04",
+                "2021-04-",
+                "21-04-23",
+                "2021/04/23",
+                "2021-04-2x",
+                "2021-4-234",
+                "1234567890",
+                "April 23, 2021",
+        };
+        guint i;
+
+        for (i = 0; i < G_N_ELEMENTS (accepted); i++)
+                g_assert_true (parse_date (accepted[i]));
+
+        for (i = 0; i < G_N_ELEMENTS (rejected); i++)
+                g_assert_false (parse_date (rejected[i]));
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/didl-lite-parser/streaming",
+                         test_didl_lite_parser_streaming);
+        g_test_add_func ("/didl-lite-parser/streaming/errors",
+                         test_didl_lite_parser_streaming_errors);
+        g_test_add_func ("/didl-lite-parser/feed",
+                         test_didl_lite_parser_feed);
+        g_test_add_func ("/didl-lite-parser/parse-bytes",
+                         test_didl_lite_parser_parse_bytes);
+        g_test_add_func ("/didl-lite-parser/as-array",
+                         test_didl_lite_parser_as_array);
+        g_test_add_func ("/didl-lite-parser/async",
+                         test_didl_lite_parser_async);
+        g_test_add_func ("/didl-lite-parser/threads",
+                         test_didl_lite_parser_threads);
+        g_test_add_func ("/didl-lite-parser/threads/handover",
+                         test_didl_lite_parser_threads_handover);
+        g_test_add_func ("/didl-lite-parser/filter",
+                         test_didl_lite_parser_filter);
+        g_test_add_func ("/didl-lite-parser/string-dict",
+                         test_didl_lite_parser_string_dict);
+        g_test_add_func ("/didl-lite-parser/scan",
+                         test_didl_lite_parser_scan);
+        g_test_add_func ("/didl-lite-parser/lazy",
+                         test_didl_lite_parser_lazy);
+        g_test_add_func ("/didl-lite-parser/detach",
+                         test_didl_lite_parser_detach);
+        g_test_add_func ("/didl-lite-parser/dates",
+                         test_didl_lite_parser_dates);
+
+        return g_test_run ();
+}
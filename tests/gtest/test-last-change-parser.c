@@ -228,6 +228,92 @@ two_mutes (void)
   //g_assert_cmpint (cf_mute, ==, 1);
 }
 
+static void
+on_notify (G_GNUC_UNUSED GObject    *object,
+           G_GNUC_UNUSED GParamSpec *pspec,
+           gpointer                  user_data)
+{
+  (*(guint *) user_data)++;
+}
+
+static void
+string_dict (void)
+{
+  GUPnPLastChangeParser *parser = gupnp_last_change_parser_new ();
+  GUPnPAVStringDict     *dict = gupnp_av_string_dict_new ();
+  GError                *error = NULL;
+  gboolean               r;
+  guint                  notified = 0;
+  gsize                  size;
+  gint                   foo = -1;
+  gchar                 *bar = NULL;
+  gboolean               baz = FALSE;
+  int                    whatever = -1;
+
+  g_signal_connect (parser,
+                    "notify::string-dict",
+                    G_CALLBACK (on_notify),
+                    &notified);
+  gupnp_last_change_parser_set_string_dict (parser, dict);
+  gupnp_last_change_parser_set_string_dict (parser, dict);
+  g_assert_cmpuint (notified, ==, 1);
+  g_assert_true (gupnp_last_change_parser_get_string_dict (parser) == dict);
+
+  r = gupnp_last_change_parser_parse_last_change (parser,
+                                                  0,
+                                                  TEST_GENERAL,
+                                                  &error,
+                                                  "Foo",
+                                                          G_TYPE_INT,
+                                                          &foo,
+                                                  "Bar",
+                                                          G_TYPE_STRING,
+                                                          &bar,
+                                                  NULL);
+  g_assert (r == TRUE);
+  g_assert_no_error (error);
+  g_assert_cmpint (foo, ==, -13);
+  g_assert_cmpstr (bar, ==, "ajwaj");
+  g_free (bar);
+
+  size = gupnp_av_string_dict_get_size (dict);
+  g_assert_cmpuint (size, >, 0);
+
+  /* The names of a second parse are already in the dictionary */
+  r = gupnp_last_change_parser_parse_last_change (parser,
+                                                  1,
+                                                  TEST_GENERAL,
+                                                  &error,
+                                                  "Baz",
+                                                          G_TYPE_BOOLEAN,
+                                                          &baz,
+                                                  NULL);
+  g_assert (r == TRUE);
+  g_assert_no_error (error);
+  g_assert (baz == TRUE);
+  g_assert_cmpuint (gupnp_av_string_dict_get_size (dict), ==, size);
+
+  r = gupnp_last_change_parser_parse_last_change (parser,
+                                                  0,
+                                                  BOGUS_TEXT,
+                                                  &error,
+                                                  "whatever",
+                                                          G_TYPE_INT,
+                                                          &whatever,
+                                                  NULL);
+  g_assert (r == FALSE);
+  g_assert_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE);
+  g_assert_cmpint (whatever, ==, -1);
+  g_clear_error (&error);
+
+  gupnp_last_change_parser_set_string_dict (parser, NULL);
+  g_assert_cmpuint (notified, ==, 2);
+  g_assert_null (gupnp_last_change_parser_get_string_dict (parser));
+
+  g_object_unref (parser);
+  gupnp_av_string_dict_unref (dict);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -238,6 +324,7 @@ main (int argc, char **argv)
   g_test_add_func ("/last-change-parser/nonexistent-instance", nonexistent_instance);
   g_test_add_func ("/last-change-parser/nonexistent-variable", nonexistent_variable);
   g_test_add_func ("/last-change-parser/two-mutes", two_mutes);
+  g_test_add_func ("/last-change-parser/string-dict", string_dict);
 
   g_test_run ();
 